@@ -0,0 +1,115 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Decodes Solo.3v3.Audit journal files to CSV on stdout.
+//
+//   solo3v3_audit_csv solo3v3_audit.bin.2 solo3v3_audit.bin.1 solo3v3_audit.bin > audit.csv
+//
+// Pass rotated files oldest first to get one chronological stream.
+
+#include "MatchmakingAudit.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+
+namespace
+{
+    char const* TypeName(uint8_t type)
+    {
+        switch (type)
+        {
+            case AUDIT_JOIN:     return "join";
+            case AUDIT_LEAVE:    return "leave";
+            case AUDIT_MATCHED:  return "matched";
+            case AUDIT_DECISION: return "decision";
+            case AUDIT_SELECTED: return "selected";
+            case AUDIT_SPLIT:    return "split";
+            default:             return "unknown";
+        }
+    }
+
+    char const* ReasonName(uint8_t reason)
+    {
+        static char const* const names[MAX_AUDIT_REASON] =
+        {
+            "ok", "too_few", "one_healer", "all_dps_wait", "role_shortage", "no_split", "split_composition", "split_class_stack"
+        };
+        return reason < MAX_AUDIT_REASON ? names[reason] : "unknown";
+    }
+
+    char const* RoleName(uint8_t role)
+    {
+        static char const* const names[] = { "melee", "range", "healer" };
+        return role < 3 ? names[role] : "unknown";
+    }
+
+    /// Returns the number of records written, or -1 if @p path is not a journal.
+    long DecodeFile(char const* path)
+    {
+        std::ifstream in(path, std::ios::binary);
+        std::vector<uint8_t> const data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        if (!MatchmakingAuditWriter::IsHeader(data.data(), data.size()))
+            return -1;
+
+        long records = 0;
+        for (size_t offset = MatchmakingAuditWriter::HEADER_SIZE; offset + MatchmakingAuditWriter::RECORD_SIZE <= data.size();
+            offset += MatchmakingAuditWriter::RECORD_SIZE)
+        {
+            MatchmakingAuditRecord r;
+            if (!MatchmakingAuditWriter::DecodeRecord(data.data() + offset, r))
+            {
+                std::fprintf(stderr, "%s: corrupt record at offset %zu, stopping\n", path, offset);
+                break;
+            }
+
+            std::printf("%llu,%s,%u,%u,%llu,%s,%u,%u,%u,%s,%u,%u,%llu\n",
+                static_cast<unsigned long long>(r.timeMs), TypeName(r.type), r.decisionId, r.bracket,
+                static_cast<unsigned long long>(r.guid), RoleName(r.role), r.classId, r.mmr, r.rating,
+                ReasonName(r.reason), r.flags, r.mask, static_cast<unsigned long long>(r.value));
+            ++records;
+        }
+
+        return records;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        std::fprintf(stderr, "usage: %s <audit file>...\n", argv[0]);
+        return 1;
+    }
+
+    std::printf("time_ms,type,decision,bracket,guid,role,class,mmr,rating,reason,flags,mask,value\n");
+
+    int status = 0;
+    for (int i = 1; i < argc; ++i)
+    {
+        long const records = DecodeFile(argv[i]);
+        if (records < 0)
+        {
+            std::fprintf(stderr, "%s: not a solo 3v3 audit journal (version %u)\n", argv[i], MatchmakingAuditWriter::VERSION);
+            status = 1;
+        }
+        else
+            std::fprintf(stderr, "%s: %ld records\n", argv[i], records);
+    }
+
+    return status;
+}
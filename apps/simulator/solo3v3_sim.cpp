@@ -0,0 +1,244 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Offline solo queue simulator. Replays a synthetic or recorded arrival
+// process through MatchmakingComposer and reports throughput, waits, MMR
+// balance and healer starvation, e.g.
+//
+//   solo3v3_sim --minutes=43200 --rate=8 --healers=0.15 --all-dps-timer=60 --class-stacking=1
+//   solo3v3_sim --trace=audit.csv --all-dps-timer=90
+//
+// --trace takes a CSV with time_ms, role, mmr and class columns, such as the
+// output of solo3v3_audit_csv (only its "join" rows are used).
+
+#include "QueueSimulator.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+namespace
+{
+    struct Options
+    {
+        double              minutes      = 7 * 24 * 60;
+        double              rate         = 10.0;   //< arrivals per minute
+        double              healers      = 0.2;
+        double              mmrMean      = 1500.0;
+        double              mmrStdDev    = 250.0;
+        std::vector<double> classWeights;
+        uint64_t            seed         = 1;
+        std::string         trace;
+        SimSettings         settings;
+    };
+
+    void Usage(char const* self)
+    {
+        std::fprintf(stderr,
+            "usage: %s [options]\n"
+            "  --minutes=N            simulated minutes (default 10080; with --trace: until the trace ends)\n"
+            "  --rate=N               arrivals per minute (default 10)\n"
+            "  --healers=F            share of healers among arrivals (default 0.2)\n"
+            "  --mmr-mean=N           MMR mean (default 1500)\n"
+            "  --mmr-sd=N             MMR standard deviation (default 250)\n"
+            "  --classes=w1,...,w11   class weights by class id (default uniform)\n"
+            "  --seed=N               random seed (default 1)\n"
+            "  --trace=FILE           replay recorded arrivals instead of generating them\n"
+            "  --no-filter-talents    Solo.3v3.FilterTalents = 0\n"
+            "  --all-dps-timer=S      Solo.3v3.FilterTalents.AllDPSTimer in seconds (default 60, 0 = at join)\n"
+            "  --class-stacking=N     Solo.3v3.PreventClassStacking (default 0)\n"
+            "  --class-mask=N         Solo.3v3.PreventClassStacking.Classes (default 0)\n"
+            "  --patience=M           mean minutes before a player leaves the queue (default 0 = never)\n",
+            self);
+    }
+
+    bool ParseArgs(int argc, char** argv, Options& options)
+    {
+        options.settings.allDpsTimerMs = 60000;
+
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string const arg = argv[i];
+            std::string::size_type const eq = arg.find('=');
+            std::string const key   = arg.substr(0, eq);
+            std::string const value = eq == std::string::npos ? "" : arg.substr(eq + 1);
+            double const number     = std::atof(value.c_str());
+
+            if (key == "--minutes")                  options.minutes = number;
+            else if (key == "--rate")                options.rate = number;
+            else if (key == "--healers")             options.healers = number;
+            else if (key == "--mmr-mean")            options.mmrMean = number;
+            else if (key == "--mmr-sd")              options.mmrStdDev = number;
+            else if (key == "--seed")                options.seed = std::strtoull(value.c_str(), nullptr, 10);
+            else if (key == "--trace")               options.trace = value;
+            else if (key == "--no-filter-talents")   options.settings.filterTalents = false;
+            else if (key == "--all-dps-timer")       options.settings.allDpsTimerMs = uint32_t(number * 1000);
+            else if (key == "--class-stacking")      options.settings.preventClassStacking = uint8_t(number);
+            else if (key == "--class-mask")          options.settings.classStackMask = uint32_t(std::strtoul(value.c_str(), nullptr, 0));
+            else if (key == "--patience")            options.settings.meanPatienceMs = uint64_t(number * 60000);
+            else if (key == "--classes")
+            {
+                std::stringstream ss(value);
+                std::string weight;
+                while (std::getline(ss, weight, ','))
+                    options.classWeights.push_back(std::atof(weight.c_str()));
+            }
+            else
+                return false;
+        }
+
+        return true;
+    }
+
+    /// Loads join rows from a CSV with a header naming its columns.
+    bool LoadTrace(std::string const& path, std::vector<SimArrival>& arrivals)
+    {
+        std::ifstream in(path);
+        std::string line;
+        if (!std::getline(in, line))
+            return false;
+
+        auto split = [](std::string const& text)
+        {
+            std::vector<std::string> fields;
+            std::stringstream ss(text);
+            std::string field;
+            while (std::getline(ss, field, ','))
+                fields.push_back(field);
+            return fields;
+        };
+
+        std::vector<std::string> const header = split(line);
+        auto column = [&header](char const* name) -> int
+        {
+            for (size_t i = 0; i < header.size(); ++i)
+                if (header[i] == name)
+                    return int(i);
+            return -1;
+        };
+
+        int const timeCol = column("time_ms"), roleCol = column("role"), mmrCol = column("mmr"), classCol = column("class");
+        int const typeCol = column("type");
+        if (timeCol < 0 || roleCol < 0 || mmrCol < 0 || classCol < 0)
+            return false;
+
+        while (std::getline(in, line))
+        {
+            std::vector<std::string> const fields = split(line);
+            if (fields.size() < header.size() || (typeCol >= 0 && fields[typeCol] != "join"))
+                continue;
+
+            SimArrival arrival;
+            arrival.timeMs  = std::strtoull(fields[timeCol].c_str(), nullptr, 10);
+            arrival.role    = fields[roleCol] == "healer" ? PlayerRole::HEALER : PlayerRole::DPS;
+            arrival.mmr     = uint32_t(std::strtoul(fields[mmrCol].c_str(), nullptr, 10));
+            arrival.classId = uint8_t(std::strtoul(fields[classCol].c_str(), nullptr, 10));
+            arrivals.push_back(arrival);
+        }
+
+        std::stable_sort(arrivals.begin(), arrivals.end(), [](SimArrival const& a, SimArrival const& b) { return a.timeMs < b.timeMs; });
+
+        // Rebase wall clock times on the first join.
+        uint64_t const base = arrivals.empty() ? 0 : arrivals.front().timeMs;
+        for (SimArrival& arrival : arrivals)
+            arrival.timeMs -= base;
+
+        return true;
+    }
+
+    void PrintHistogram(char const* label, LatencyHistogram const& h)
+    {
+        if (!h.Count())
+        {
+            std::printf("%-22s none\n", label);
+            return;
+        }
+
+        std::printf("%-22s p50 %llu  p90 %llu  p99 %llu  max %llu  mean %.1f  (n=%llu)\n", label,
+            static_cast<unsigned long long>(h.Percentile(50)), static_cast<unsigned long long>(h.Percentile(90)),
+            static_cast<unsigned long long>(h.Percentile(99)), static_cast<unsigned long long>(h.Max()), h.Mean(),
+            static_cast<unsigned long long>(h.Count()));
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Options options;
+    if (!ParseArgs(argc, argv, options))
+    {
+        Usage(argv[0]);
+        return 1;
+    }
+
+    std::vector<SimArrival> recorded;
+    if (!options.trace.empty() && !LoadTrace(options.trace, recorded))
+    {
+        std::fprintf(stderr, "%s: cannot read a time_ms,role,mmr,class CSV\n", options.trace.c_str());
+        return 1;
+    }
+
+    SimArrivalGenerator generator(options.rate, options.healers, options.mmrMean, options.mmrStdDev, options.classWeights, options.seed);
+    size_t replayed = 0;
+    auto next = [&](SimArrival& out)
+    {
+        if (options.trace.empty())
+        {
+            out = generator.Next();
+            return true;
+        }
+
+        if (replayed >= recorded.size())
+            return false;
+
+        out = recorded[replayed++];
+        return true;
+    };
+
+    bool const explicitMinutes = std::any_of(argv + 1, argv + argc, [](char const* arg) { return std::string(arg).rfind("--minutes", 0) == 0; });
+    uint64_t const endMs = options.trace.empty() || explicitMinutes ? uint64_t(options.minutes * 60000) : std::numeric_limits<uint64_t>::max();
+
+    QueueSimulator sim(options.settings, options.seed);
+    auto const wallStart = std::chrono::steady_clock::now();
+    SimReport const report = sim.Run(next, endMs);
+    double const wallSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+
+    double const simMinutes = double(report.simulatedMs) / 60000.0;
+    uint64_t const dps = uint32_t(PlayerRole::DPS), healer = uint32_t(PlayerRole::HEALER);
+
+    std::printf("simulated              %.0f min (%.1f days) in %.3f s wall, %.2fM sim-min/s\n", simMinutes, simMinutes / 1440.0,
+        wallSec, wallSec > 0.0 ? simMinutes / wallSec / 1e6 : 0.0);
+    std::printf("arrivals               %llu dps, %llu healers\n",
+        static_cast<unsigned long long>(report.arrivals[dps]), static_cast<unsigned long long>(report.arrivals[healer]));
+    std::printf("matches                %llu (%.2f/hour), %llu all-DPS\n", static_cast<unsigned long long>(report.matches),
+        simMinutes > 0.0 ? double(report.matches) * 60.0 / simMinutes : 0.0, static_cast<unsigned long long>(report.allDpsMatches));
+    std::printf("passes                 %llu, %llu with no legal split\n",
+        static_cast<unsigned long long>(report.passes), static_cast<unsigned long long>(report.noSplitPasses));
+    std::printf("abandoned              %llu dps, %llu healers\n",
+        static_cast<unsigned long long>(report.abandoned[dps]), static_cast<unsigned long long>(report.abandoned[healer]));
+    std::printf("still queued           %llu dps, %llu healers\n",
+        static_cast<unsigned long long>(report.stillQueued[dps]), static_cast<unsigned long long>(report.stillQueued[healer]));
+    PrintHistogram("wait dps (s)", report.waitSec[dps]);
+    PrintHistogram("wait healer (s)", report.waitSec[healer]);
+    PrintHistogram("team mmr diff", report.mmrDiff);
+    std::printf("healer starved         %.1f%% of the time\n",
+        report.simulatedMs ? 100.0 * double(report.healerStarvedMs) / double(report.simulatedMs) : 0.0);
+
+    return 0;
+}
@@ -10,7 +10,7 @@ if (BUILD_TESTING)
 
     # Collect all test sources
     file(GLOB_RECURSE MODULE_TEST_SOURCES
-        "${CMAKE_SOURCE_DIR}/modules/mod-arena-3v3-solo-queue/tests/*.cpp"
+        "${CMAKE_SOURCE_DIR}/modules/mod-arena-3v3-solo-queue/tests/unit/*.cpp"
     )
 
     if(MODULE_TEST_SOURCES)
@@ -20,7 +20,6 @@ if (BUILD_TESTING)
         # Expose the MatchmakingComposer header (header-only, no WoW server deps)
         set_property(GLOBAL APPEND PROPERTY ACORE_MODULE_TEST_INCLUDES
             "${CMAKE_SOURCE_DIR}/modules/mod-arena-3v3-solo-queue/src"
-            "${CMAKE_SOURCE_DIR}/modules/mod-arena-3v3-solo-queue/tests"
         )
 
         list(LENGTH MODULE_TEST_SOURCES TEST_FILE_COUNT)
@@ -28,4 +27,80 @@ if (BUILD_TESTING)
     else()
         message(STATUS "  +- No test files found in mod-arena-3v3-solo-queue/tests")
     endif()
+
+    # Allocation-counting tests (tests/alloc). They replace the global
+    # operator new/delete, so they get their own runner instead of being
+    # linked into the shared one.
+    option(SOLO3V3_BUILD_ALLOCATION_TESTS "Build the mod-arena-3v3-solo-queue allocation tests" OFF)
+
+    if (SOLO3V3_BUILD_ALLOCATION_TESTS)
+        find_package(GTest REQUIRED)
+        find_package(Threads REQUIRED)
+
+        file(GLOB MODULE_ALLOC_TEST_SOURCES
+            "${CMAKE_SOURCE_DIR}/modules/mod-arena-3v3-solo-queue/tests/alloc/*.cpp"
+        )
+
+        add_executable(solo3v3_alloc_tests ${MODULE_ALLOC_TEST_SOURCES})
+        target_include_directories(solo3v3_alloc_tests PRIVATE
+            "${CMAKE_SOURCE_DIR}/modules/mod-arena-3v3-solo-queue/src"
+            "${CMAKE_SOURCE_DIR}/modules/mod-arena-3v3-solo-queue/tests/alloc"
+        )
+        target_link_libraries(solo3v3_alloc_tests PRIVATE GTest::gtest GTest::gtest_main Threads::Threads)
+        target_compile_features(solo3v3_alloc_tests PRIVATE cxx_std_17)
+
+        add_test(NAME solo3v3_alloc_tests COMMAND solo3v3_alloc_tests)
+
+        message(STATUS "  +- Registered solo3v3_alloc_tests")
+    endif()
+
+    # Google Benchmark suite for the matchmaking hot path (tests/bench).
+    # Run `make solo3v3_bench_json` to write solo3v3_bench.json for comparisons.
+    option(SOLO3V3_BUILD_BENCHMARKS "Build the mod-arena-3v3-solo-queue benchmarks (needs Google Benchmark)" OFF)
+
+    if (SOLO3V3_BUILD_BENCHMARKS)
+        find_package(benchmark REQUIRED)
+
+        file(GLOB MODULE_BENCH_SOURCES
+            "${CMAKE_SOURCE_DIR}/modules/mod-arena-3v3-solo-queue/tests/bench/*.cpp"
+        )
+
+        add_executable(solo3v3_bench ${MODULE_BENCH_SOURCES})
+        target_include_directories(solo3v3_bench PRIVATE
+            "${CMAKE_SOURCE_DIR}/modules/mod-arena-3v3-solo-queue/src"
+        )
+        target_link_libraries(solo3v3_bench PRIVATE benchmark::benchmark benchmark::benchmark_main)
+        target_compile_features(solo3v3_bench PRIVATE cxx_std_17)
+
+        add_custom_target(solo3v3_bench_json
+            COMMAND solo3v3_bench --benchmark_out=${CMAKE_BINARY_DIR}/solo3v3_bench.json --benchmark_out_format=json
+            DEPENDS solo3v3_bench
+            COMMENT "Running mod-arena-3v3-solo-queue benchmarks"
+        )
+
+        message(STATUS "  +- Registered solo3v3_bench")
+    endif()
+endif()
+
+# Offline tools built from the engine-independent headers in src/.
+option(SOLO3V3_BUILD_TOOLS "Build the mod-arena-3v3-solo-queue offline tools" OFF)
+
+if (SOLO3V3_BUILD_TOOLS)
+    message(STATUS "Configuring mod-arena-3v3-solo-queue tools...")
+
+    find_package(Threads REQUIRED)
+
+    # solo3v3_audit_csv: decodes Solo.3v3.Audit journals to CSV
+    # solo3v3_sim:       offline queue simulator driving MatchmakingComposer
+    foreach(tool audit/solo3v3_audit_csv simulator/solo3v3_sim)
+        get_filename_component(tool_name ${tool} NAME)
+        add_executable(${tool_name}
+            "${CMAKE_SOURCE_DIR}/modules/mod-arena-3v3-solo-queue/apps/${tool}.cpp"
+        )
+        target_include_directories(${tool_name} PRIVATE
+            "${CMAKE_SOURCE_DIR}/modules/mod-arena-3v3-solo-queue/src"
+        )
+        target_link_libraries(${tool_name} PRIVATE Threads::Threads)
+        target_compile_features(${tool_name} PRIVATE cxx_std_17)
+    endforeach()
 endif()
@@ -0,0 +1,119 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _BOUNDED_MPMC_QUEUE_H_
+#define _BOUNDED_MPMC_QUEUE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+/// Fixed-capacity lock-free multi-producer / multi-consumer queue (Vyukov's
+/// bounded queue). Every cell carries a sequence number telling producers
+/// and consumers whose turn it is, so TryPush/TryPop are a CAS on the shared
+/// position plus one acquire/release pair on the cell, and never block.
+/// A full queue makes TryPush fail instead of waiting.
+template <typename T>
+class BoundedMpmcQueue
+{
+public:
+    /// @p capacity is rounded up to a power of two.
+    explicit BoundedMpmcQueue(std::size_t capacity)
+    {
+        std::size_t size = 2;
+        while (size < capacity)
+            size <<= 1;
+
+        _mask  = size - 1;
+        _cells = std::make_unique<Cell[]>(size);
+        for (std::size_t i = 0; i < size; ++i)
+            _cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    BoundedMpmcQueue(BoundedMpmcQueue const&) = delete;
+    BoundedMpmcQueue& operator=(BoundedMpmcQueue const&) = delete;
+
+    bool TryPush(T value)
+    {
+        std::size_t pos = _enqueue.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            Cell& cell = _cells[pos & _mask];
+            std::size_t const seq = cell.sequence.load(std::memory_order_acquire);
+            std::intptr_t const dif = std::intptr_t(seq) - std::intptr_t(pos);
+
+            if (dif == 0)
+            {
+                if (_enqueue.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    cell.value = std::move(value);
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (dif < 0)
+                return false; // full
+            else
+                pos = _enqueue.load(std::memory_order_relaxed);
+        }
+    }
+
+    bool TryPop(T& out)
+    {
+        std::size_t pos = _dequeue.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            Cell& cell = _cells[pos & _mask];
+            std::size_t const seq = cell.sequence.load(std::memory_order_acquire);
+            std::intptr_t const dif = std::intptr_t(seq) - std::intptr_t(pos + 1);
+
+            if (dif == 0)
+            {
+                if (_dequeue.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    out = std::move(cell.value);
+                    cell.sequence.store(pos + _mask + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (dif < 0)
+                return false; // empty
+            else
+                pos = _dequeue.load(std::memory_order_relaxed);
+        }
+    }
+
+    std::size_t Capacity() const { return _mask + 1; }
+
+private:
+    struct Cell
+    {
+        std::atomic<std::size_t> sequence{ 0 };
+        T                        value{};
+    };
+
+    // Producers and consumers touch different positions; keep them on
+    // separate cache lines.
+    alignas(64) std::atomic<std::size_t> _enqueue{ 0 };
+    alignas(64) std::atomic<std::size_t> _dequeue{ 0 };
+    std::size_t                          _mask = 0;
+    std::unique_ptr<Cell[]>              _cells;
+};
+
+#endif // _BOUNDED_MPMC_QUEUE_H_
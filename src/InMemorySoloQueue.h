@@ -0,0 +1,188 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _IN_MEMORY_SOLO_QUEUE_H_
+#define _IN_MEMORY_SOLO_QUEUE_H_
+
+#include "SoloMatchmaker.h"
+
+#include <algorithm>
+#include <array>
+#include <deque>
+#include <list>
+#include <unordered_set>
+#include <vector>
+
+/// A queued solo player held entirely in memory.
+struct InMemoryQueuedPlayer
+{
+    uint64_t id          = 0;
+    uint32_t bracket     = 0;
+    bool     rated       = false;
+    uint8_t  team        = SOLO_TEAM_ALLIANCE;
+    uint8_t  bucket      = SOLO_BUCKET_NORMAL_ALLIANCE;
+    uint8_t  role        = SOLO_ROLE_MELEE;
+    uint32_t mmr         = 1500;
+    uint8_t  classId     = 1;
+    uint32_t joinTime    = 0;
+    bool     available   = true;
+    bool     allDpsReady = false;
+    bool     pooled      = false;   //< in a selection pool since the last ResetPools()
+};
+
+/// In-memory SoloMatchmaker binding: faction buckets per bracket, selection
+/// pools and an ignore list, with none of the core's sessions, players or
+/// battleground queue behind them. Used by the unit tests, the benchmarks
+/// and the in-server synthetic load mode.
+class InMemorySoloQueue
+{
+public:
+    using GroupHandle  = InMemoryQueuedPlayer*;
+    using PlayerHandle = InMemoryQueuedPlayer*;
+    using Bucket       = std::list<GroupHandle>;
+
+    static constexpr uint32_t BUCKETS = 4;
+
+    /// Queues @p player, keeping its bucket in JoinTime order.
+    InMemoryQueuedPlayer& Add(InMemoryQueuedPlayer player)
+    {
+        player.bucket = uint8_t(player.team + (player.rated ? SOLO_BUCKET_PREMADE_ALLIANCE : SOLO_BUCKET_NORMAL_ALLIANCE));
+        player.pooled = false;
+
+        InMemoryQueuedPlayer* added = nullptr;
+        if (!_free.empty())
+        {
+            added = _free.back();
+            _free.pop_back();
+            *added = player;
+        }
+        else
+        {
+            _players.push_back(player);
+            added = &_players.back();
+        }
+
+        Bucket& bucket = Queued(added->bracket, added->bucket);
+        auto pos = bucket.end();
+        while (pos != bucket.begin() && (*std::prev(pos))->joinTime > added->joinTime)
+            --pos;
+        bucket.insert(pos, added);
+        ++_queued;
+        return *added;
+    }
+
+    /// Takes @p player out of the queue; the handle is reused by a later Add().
+    void Remove(InMemoryQueuedPlayer& player)
+    {
+        Bucket& bucket = Queued(player.bracket, player.bucket);
+        bucket.erase(std::find(bucket.begin(), bucket.end(), &player));
+        if (player.pooled)
+            for (std::vector<GroupHandle>& pool : _pools)
+                pool.erase(std::remove(pool.begin(), pool.end(), &player), pool.end());
+
+        _free.push_back(&player);
+        --_queued;
+    }
+
+    /// Takes the pooled players out of the queue, as inviting them would.
+    /// Returns how many were removed.
+    uint32_t RemovePooled()
+    {
+        uint32_t removed = 0;
+        for (std::vector<GroupHandle>& pool : _pools)
+        {
+            for (GroupHandle player : pool)
+            {
+                player->pooled = false;
+                Remove(*player);
+                ++removed;
+            }
+            pool.clear();
+        }
+        return removed;
+    }
+
+    void AddIgnore(uint64_t a, uint64_t b) { _ignores.insert(IgnoreKey(a, b)); }
+
+    std::vector<GroupHandle> const& Pool(uint8_t team) const { return _pools[team]; }
+    uint32_t QueuedCount() const { return _queued; }
+
+    // ---- SoloMatchmaker binding ----
+
+    Bucket& Queued(uint32_t bracket, uint8_t bucket)
+    {
+        if (bracket >= _buckets.size())
+            _buckets.resize(bracket + 1);
+        return _buckets[bracket][bucket];
+    }
+
+    bool Describe(GroupHandle group, SoloCandidate<InMemorySoloQueue>& candidate) const
+    {
+        if (!group->available)
+            return false;
+
+        candidate.player      = group;
+        candidate.id          = group->id;
+        candidate.role        = group->role;
+        candidate.mmr         = group->mmr;
+        candidate.classId     = group->classId;
+        candidate.allDpsReady = group->allDpsReady;
+        return true;
+    }
+
+    bool Ignores(PlayerHandle a, PlayerHandle b) const
+    {
+        return !_ignores.empty() && (_ignores.count(IgnoreKey(a->id, b->id)) || _ignores.count(IgnoreKey(b->id, a->id)));
+    }
+
+    static uint32_t JoinTime(GroupHandle group) { return group->joinTime; }
+    static uint8_t Team(GroupHandle group) { return group->team; }
+
+    static void SetTeam(GroupHandle group, uint8_t team, uint8_t bucket)
+    {
+        group->team   = team;
+        group->bucket = bucket;
+    }
+
+    void ResetPools()
+    {
+        for (std::vector<GroupHandle>& pool : _pools)
+        {
+            for (GroupHandle group : pool)
+                group->pooled = false;
+            pool.clear();
+        }
+    }
+
+    void AddToPool(uint8_t team, GroupHandle group, uint32_t /*minPlayers*/)
+    {
+        group->pooled = true;
+        _pools[team].push_back(group);
+    }
+
+private:
+    static uint64_t IgnoreKey(uint64_t a, uint64_t b) { return (a << 32) ^ b; }
+
+    std::deque<InMemoryQueuedPlayer>         _players; //< stable addresses for the handles
+    std::vector<InMemoryQueuedPlayer*>       _free;
+    std::vector<std::array<Bucket, BUCKETS>> _buckets;
+    std::vector<GroupHandle>                 _pools[2];
+    std::unordered_set<uint64_t>             _ignores;
+    uint32_t                                 _queued = 0;
+};
+
+#endif // _IN_MEMORY_SOLO_QUEUE_H_
@@ -0,0 +1,172 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _LATENCY_HISTOGRAM_H_
+#define _LATENCY_HISTOGRAM_H_
+
+#include <array>
+#include <cstdint>
+#include <limits>
+
+/// Fixed-size log-linear histogram (HDR-style) for latency and size samples.
+///
+/// Values are grouped by power-of-two magnitude, and every magnitude is split
+/// into SUB_BUCKETS linear sub-buckets. Reported percentiles are therefore
+/// accurate to within 1/SUB_BUCKETS of the true value, Record() never
+/// allocates, and the full uint64 range is covered.
+class LatencyHistogram
+{
+public:
+    static constexpr uint32_t SUB_BUCKET_BITS = 4;
+    static constexpr uint32_t SUB_BUCKETS     = 1u << SUB_BUCKET_BITS;
+    static constexpr uint32_t BUCKET_COUNT    = SUB_BUCKETS + (64 - SUB_BUCKET_BITS) * SUB_BUCKETS;
+
+    void Record(uint64_t value)
+    {
+        ++_buckets[BucketIndex(value)];
+        ++_count;
+        _sum += value;
+        if (value < _min)
+            _min = value;
+        if (value > _max)
+            _max = value;
+    }
+
+    /// Adds every sample of @p other to this histogram.
+    void Merge(LatencyHistogram const& other)
+    {
+        if (!other._count)
+            return;
+
+        for (uint32_t i = 0; i < BUCKET_COUNT; ++i)
+            _buckets[i] += other._buckets[i];
+
+        _count += other._count;
+        _sum   += other._sum;
+        if (other._min < _min)
+            _min = other._min;
+        if (other._max > _max)
+            _max = other._max;
+    }
+
+    /// Adds samples recorded elsewhere as raw bucket counts (BUCKET_COUNT of
+    /// them), together with their sum, min and max.
+    void MergeBuckets(uint64_t const* buckets, uint64_t sum, uint64_t min, uint64_t max)
+    {
+        uint64_t count = 0;
+        for (uint32_t i = 0; i < BUCKET_COUNT; ++i)
+        {
+            _buckets[i] += buckets[i];
+            count       += buckets[i];
+        }
+
+        if (!count)
+            return;
+
+        _count += count;
+        _sum   += sum;
+        if (min < _min)
+            _min = min;
+        if (max > _max)
+            _max = max;
+    }
+
+    void Reset()
+    {
+        _buckets.fill(0);
+        _count = 0;
+        _sum   = 0;
+        _min   = std::numeric_limits<uint64_t>::max();
+        _max   = 0;
+    }
+
+    uint64_t Count() const { return _count; }
+    uint64_t Sum()   const { return _sum; }
+    uint64_t Min()   const { return _count ? _min : 0; }
+    uint64_t Max()   const { return _max; }
+    double   Mean()  const { return _count ? double(_sum) / double(_count) : 0.0; }
+
+    /// Returns the value at percentile @p p (0-100). The result is the upper
+    /// bound of the bucket holding that sample, clamped to the observed max.
+    uint64_t Percentile(double p) const
+    {
+        if (!_count)
+            return 0;
+
+        if (p <= 0.0)
+            return Min();
+
+        uint64_t target = uint64_t(double(_count) * (p >= 100.0 ? 100.0 : p) / 100.0 + 0.5);
+        if (target < 1)
+            target = 1;
+
+        uint64_t seen = 0;
+        for (uint32_t i = 0; i < BUCKET_COUNT; ++i)
+        {
+            seen += _buckets[i];
+            if (seen >= target)
+            {
+                uint64_t const upper = BucketUpperBound(i);
+                return upper < _max ? upper : _max;
+            }
+        }
+
+        return _max;
+    }
+
+    static uint32_t BucketIndex(uint64_t value)
+    {
+        if (value < SUB_BUCKETS)
+            return static_cast<uint32_t>(value);
+
+        uint32_t const shift = HighestBit(value) - SUB_BUCKET_BITS;
+        uint32_t const sub   = static_cast<uint32_t>(value >> shift) - SUB_BUCKETS;
+        return SUB_BUCKETS + shift * SUB_BUCKETS + sub;
+    }
+
+    static uint64_t BucketUpperBound(uint32_t index)
+    {
+        if (index < SUB_BUCKETS)
+            return index;
+
+        uint32_t const shift = (index - SUB_BUCKETS) / SUB_BUCKETS;
+        uint32_t const sub   = (index - SUB_BUCKETS) % SUB_BUCKETS;
+        uint64_t const lower = uint64_t(SUB_BUCKETS + sub) << shift;
+        return lower + ((uint64_t(1) << shift) - 1);
+    }
+
+private:
+    static uint32_t HighestBit(uint64_t value)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return 63u - static_cast<uint32_t>(__builtin_clzll(value));
+#else
+        uint32_t bit = 0;
+        while (value >>= 1)
+            ++bit;
+        return bit;
+#endif
+    }
+
+    std::array<uint64_t, BUCKET_COUNT> _buckets{};
+    uint64_t _count = 0;
+    uint64_t _sum   = 0;
+    uint64_t _min   = std::numeric_limits<uint64_t>::max();
+    uint64_t _max   = 0;
+};
+
+#endif // _LATENCY_HISTOGRAM_H_
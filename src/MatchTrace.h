@@ -0,0 +1,301 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _MATCH_TRACE_H_
+#define _MATCH_TRACE_H_
+
+#include "BoundedMpmcQueue.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/// Timestamped stages of one match, from the members' queue joins to the
+/// arena being destroyed. An inactive trace (the default) records nothing,
+/// so untraced matches only pay for an Active() check per stage.
+///
+/// Events are either spans (durUs > 0) or instants. Thread id 0 is the
+/// match itself; other thread ids are players.
+class MatchTrace
+{
+public:
+    struct Event
+    {
+        char const* name    = nullptr; //< static string
+        uint64_t    tid     = 0;
+        uint64_t    startUs = 0;
+        uint64_t    durUs   = 0;       //< 0 for an instant
+    };
+
+    static uint64_t NowUs()
+    {
+        return uint64_t(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    void Start(uint64_t nowUs)
+    {
+        _active  = true;
+        _startUs = nowUs;
+        _events.reserve(32);
+    }
+
+    bool Active() const { return _active; }
+    uint64_t StartUs() const { return _startUs; }
+
+    void Instant(char const* name, uint64_t tid, uint64_t tsUs)
+    {
+        if (_active)
+            _events.push_back({ name, tid, tsUs, 0 });
+    }
+
+    void Span(char const* name, uint64_t tid, uint64_t startUs, uint64_t endUs)
+    {
+        if (_active)
+            _events.push_back({ name, tid, startUs, endUs > startUs ? endUs - startUs : 1 });
+    }
+
+    void NameThread(uint64_t tid, std::string name)
+    {
+        if (_active)
+            _threadNames.emplace_back(tid, std::move(name));
+    }
+
+    std::vector<Event> const& Events() const { return _events; }
+    std::vector<std::pair<uint64_t, std::string>> const& ThreadNames() const { return _threadNames; }
+
+private:
+    bool                                          _active  = false;
+    uint64_t                                      _startUs = 0;
+    std::vector<Event>                            _events;
+    std::vector<std::pair<uint64_t, std::string>> _threadNames;
+};
+
+/// Appends match traces to a file in the Chrome trace-event JSON array
+/// format (chrome://tracing, Perfetto). The closing bracket of the array is
+/// optional in that format, so every trace is a cheap append. Once the file
+/// grows past the size limit it is rotated: path -> path.1 -> path.2 ...,
+/// keeping at most maxFiles files. Open() rotates a file left by a previous
+/// run the same way, so each server start gets a file of its own.
+///
+/// Write() only encodes the trace and pushes it onto a bounded queue; a
+/// background thread does the file I/O, like MatchmakingAuditWriter. When
+/// that thread falls behind and the queue is full the trace is dropped and
+/// counted.
+class ChromeTraceWriter
+{
+public:
+    /// The queue of @p capacity traces is only allocated by Open().
+    explicit ChromeTraceWriter(std::size_t capacity = 1024) : _capacity(capacity) { }
+    ~ChromeTraceWriter() { Close(); }
+
+    ChromeTraceWriter(ChromeTraceWriter const&) = delete;
+    ChromeTraceWriter& operator=(ChromeTraceWriter const&) = delete;
+
+    /// Opens the file on the calling thread, then starts the writer thread.
+    bool Open(std::string const& path, uint64_t maxBytes, uint32_t maxFiles)
+    {
+        Close();
+        _path     = path;
+        _maxBytes = maxBytes;
+        _maxFiles = maxFiles ? maxFiles : 1;
+
+        if (std::FILE* existing = std::fopen(_path.c_str(), "rb"))
+        {
+            bool const empty = std::fgetc(existing) == EOF;
+            std::fclose(existing);
+            if (!empty)
+                RotateFiles();
+        }
+
+        if (!OpenFresh())
+            return false;
+
+        if (!_queue)
+            _queue = std::make_unique<BoundedMpmcQueue<std::string>>(_capacity);
+        _stop.store(false, std::memory_order_relaxed);
+        _thread = std::thread([this]() { Run(); });
+        return true;
+    }
+
+    /// Writes everything already queued, then joins the writer thread and
+    /// closes the file.
+    void Close()
+    {
+        if (!_thread.joinable())
+            return;
+
+        _stop.store(true, std::memory_order_release);
+        _thread.join();
+    }
+
+    bool IsOpen() const { return _thread.joinable(); }
+    std::string const& Path() const { return _path; }
+
+    uint64_t Written() const { return _written.load(std::memory_order_relaxed); }
+    uint64_t Dropped() const { return _dropped.load(std::memory_order_relaxed); }
+
+    /// Queues @p trace as process @p pid named @p processName.
+    bool Write(uint32_t pid, std::string const& processName, MatchTrace const& trace)
+    {
+        if (!IsOpen())
+            return false;
+
+        std::string encoded;
+        Encode(pid, processName, trace, encoded);
+        if (_queue->TryPush(std::move(encoded)))
+            return true;
+
+        _dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    /// Appends the events of @p trace, each followed by ",\n".
+    static void Encode(uint32_t pid, std::string const& processName, MatchTrace const& trace, std::string& out)
+    {
+        out += "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" + std::to_string(pid) +
+            ",\"args\":{\"name\":\"" + Escape(processName) + "\"}},\n";
+
+        for (auto const& [tid, name] : trace.ThreadNames())
+            out += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" + std::to_string(pid) + ",\"tid\":" +
+                std::to_string(tid) + ",\"args\":{\"name\":\"" + Escape(name) + "\"}},\n";
+
+        for (MatchTrace::Event const& event : trace.Events())
+        {
+            out += "{\"name\":\"";
+            out += Escape(event.name ? event.name : "");
+            out += event.durUs ? "\",\"ph\":\"X\",\"dur\":" + std::to_string(event.durUs) : std::string("\",\"ph\":\"i\",\"s\":\"t\"");
+            out += ",\"ts\":" + std::to_string(event.startUs) + ",\"pid\":" + std::to_string(pid) +
+                ",\"tid\":" + std::to_string(event.tid) + "},\n";
+        }
+    }
+
+private:
+    void Run()
+    {
+        std::string encoded;
+        for (;;)
+        {
+            // Read the flag before draining so nothing queued before
+            // Close() is left behind.
+            bool const stopping = _stop.load(std::memory_order_acquire);
+
+            uint64_t batch = 0;
+            while (_queue->TryPop(encoded))
+            {
+                ++batch;
+                if (!_file)
+                {
+                    _dropped.fetch_add(1, std::memory_order_relaxed);
+                    continue;
+                }
+
+                std::fwrite(encoded.data(), 1, encoded.size(), _file);
+                _bytes += encoded.size();
+                _written.fetch_add(1, std::memory_order_relaxed);
+
+                if (_maxBytes && _bytes >= _maxBytes)
+                {
+                    CloseFile();
+                    RotateFiles();
+                    OpenFresh();
+                }
+            }
+
+            if (batch && _file)
+                std::fflush(_file);
+
+            if (!batch)
+            {
+                if (stopping)
+                    break;
+
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+        }
+
+        CloseFile();
+    }
+
+    bool OpenFresh()
+    {
+        _file  = std::fopen(_path.c_str(), "wb");
+        _bytes = 0;
+        if (!_file)
+            return false;
+
+        std::fputs("[\n", _file);
+        _bytes = 2;
+        return true;
+    }
+
+    void CloseFile()
+    {
+        if (_file)
+        {
+            std::fclose(_file);
+            _file = nullptr;
+        }
+    }
+
+    // Drop the oldest, shift the rest up by one.
+    void RotateFiles()
+    {
+        std::remove(RotatedPath(_maxFiles - 1).c_str());
+        for (uint32_t i = _maxFiles - 1; i > 0; --i)
+            std::rename(RotatedPath(i - 1).c_str(), RotatedPath(i).c_str());
+    }
+
+    std::string RotatedPath(uint32_t index) const
+    {
+        return index ? _path + "." + std::to_string(index) : _path;
+    }
+
+    static std::string Escape(std::string const& in)
+    {
+        std::string out;
+        out.reserve(in.size());
+        for (char c : in)
+        {
+            if (c == '"' || c == '\\')
+                out += '\\';
+            if (static_cast<unsigned char>(c) >= 0x20)
+                out += c;
+        }
+        return out;
+    }
+
+    std::unique_ptr<BoundedMpmcQueue<std::string>> _queue;
+    std::size_t                                    _capacity;
+    std::thread                                    _thread;
+    std::atomic<bool>                              _stop{ false };
+    std::atomic<uint64_t>                          _written{ 0 };
+    std::atomic<uint64_t>                          _dropped{ 0 };
+    std::string                                    _path;
+    std::FILE*                                     _file     = nullptr; //< owned by the writer thread once open
+    uint64_t                                       _bytes    = 0;
+    uint64_t                                       _maxBytes = 0;
+    uint32_t                                       _maxFiles = 1;
+};
+
+#endif // _MATCH_TRACE_H_
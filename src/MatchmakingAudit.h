@@ -0,0 +1,372 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _MATCHMAKING_AUDIT_H_
+#define _MATCHMAKING_AUDIT_H_
+
+#include "BoundedMpmcQueue.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+enum MatchmakingAuditType : uint8_t
+{
+    AUDIT_JOIN     = 1, //< player joined the queue
+    AUDIT_LEAVE    = 2, //< player's queue entry was dropped (left, evicted or invited)
+    AUDIT_MATCHED  = 3, //< player moved into a match; value = waited ms
+    AUDIT_DECISION = 4, //< one matchmaking pass; reason = outcome, mask = candidates
+    AUDIT_SELECTED = 5, //< a player selected by that pass; mask = index in the selection
+    AUDIT_SPLIT    = 6  //< a team split scored by that pass; value = MMR diff, mmr = ignore pairs
+};
+
+enum MatchmakingAuditReason : uint8_t
+{
+    AUDIT_REASON_OK = 0,
+    AUDIT_REASON_TOO_FEW,           //< decision: not enough available players
+    AUDIT_REASON_ONE_HEALER,        //< decision: a single healer cannot be split
+    AUDIT_REASON_ALL_DPS_WAIT,      //< decision: no healer, AllDPS timers pending
+    AUDIT_REASON_ROLE_SHORTAGE,     //< decision: healers present, not enough DPS
+    AUDIT_REASON_NO_SPLIT,          //< decision: every split was rejected
+    AUDIT_REASON_SPLIT_COMPOSITION, //< split: healers not one per team
+    AUDIT_REASON_SPLIT_CLASS_STACK, //< split: same class on one team
+    MAX_AUDIT_REASON
+};
+
+enum MatchmakingAuditFlags : uint8_t
+{
+    AUDIT_FLAG_RATED   = 0x01,
+    AUDIT_FLAG_ALL_DPS = 0x02,
+    AUDIT_FLAG_CHOSEN  = 0x04  //< split: the one used for the match
+};
+
+/// One matchmaking audit record. Field meaning depends on the type, see
+/// MatchmakingAuditType.
+struct MatchmakingAuditRecord
+{
+    uint64_t timeMs     = 0; //< wall clock, ms since epoch
+    uint64_t guid       = 0;
+    uint64_t value      = 0;
+    uint32_t decisionId = 0;
+    uint32_t mmr        = 0;
+    uint32_t rating     = 0;
+    uint16_t mask       = 0;
+    uint8_t  type       = 0;
+    uint8_t  bracket    = 0;
+    uint8_t  role       = 0;
+    uint8_t  classId    = 0;
+    uint8_t  reason     = 0;
+    uint8_t  flags      = 0;
+};
+
+/// Appends matchmaking audit records to a rotating binary file from a
+/// background thread.
+///
+/// Submit() only pushes onto a lock-free bounded queue, so the caller never
+/// waits on I/O or a lock; when the writer falls behind and the queue is
+/// full the record is dropped and counted. The writer thread drains the
+/// queue in batches, opens and rotates the files (path -> path.1 -> ...).
+/// On start it appends to the journal left by the previous run when that
+/// is a complete file of this version, otherwise rotates it away.
+///
+/// File layout: an 8 byte header ("SQA" + version + 4 reserved bytes)
+/// followed by RECORD_SIZE byte little-endian records ending in an FNV-1a
+/// checksum, so a torn tail is detected by the reader.
+class MatchmakingAuditWriter
+{
+public:
+    static constexpr uint8_t VERSION     = 1;
+    static constexpr size_t  HEADER_SIZE = 8;
+    static constexpr size_t  RECORD_SIZE = 48;
+
+    /// The queue of @p capacity records is only allocated by Start().
+    explicit MatchmakingAuditWriter(std::size_t capacity = 1 << 16) : _capacity(capacity) { }
+    ~MatchmakingAuditWriter() { Stop(); }
+
+    MatchmakingAuditWriter(MatchmakingAuditWriter const&) = delete;
+    MatchmakingAuditWriter& operator=(MatchmakingAuditWriter const&) = delete;
+
+    /// Starts the writer thread. The file is opened by that thread.
+    void Start(std::string const& path, uint64_t maxBytes, uint32_t maxFiles)
+    {
+        Stop();
+        _path     = path;
+        _maxBytes = maxBytes;
+        _maxFiles = maxFiles ? maxFiles : 1;
+        if (!_queue)
+            _queue = std::make_unique<BoundedMpmcQueue<MatchmakingAuditRecord>>(_capacity);
+        _stop.store(false, std::memory_order_relaxed);
+        _running.store(true, std::memory_order_release);
+        _thread = std::thread([this]() { Run(); });
+    }
+
+    /// Writes everything already submitted, then joins the writer thread.
+    void Stop()
+    {
+        if (!_thread.joinable())
+            return;
+
+        _stop.store(true, std::memory_order_release);
+        _thread.join();
+        _running.store(false, std::memory_order_release);
+    }
+
+    bool IsRunning() const { return _running.load(std::memory_order_acquire); }
+
+    bool Submit(MatchmakingAuditRecord const& record)
+    {
+        if (_queue && _queue->TryPush(record))
+            return true;
+
+        _dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    uint64_t Written()   const { return _written.load(std::memory_order_relaxed); }
+    uint64_t Dropped()   const { return _dropped.load(std::memory_order_relaxed); }
+    uint64_t Rotations() const { return _rotations.load(std::memory_order_relaxed); }
+    bool     OpenFailed() const { return _openFailed.load(std::memory_order_relaxed); }
+
+    static uint64_t WallClockMs()
+    {
+        return uint64_t(std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count());
+    }
+
+    // ---- Encoding (exposed for tests and the CSV tool) ----
+
+    static void EncodeHeader(std::vector<uint8_t>& out)
+    {
+        out.push_back('S');
+        out.push_back('Q');
+        out.push_back('A');
+        out.push_back(VERSION);
+        out.insert(out.end(), 4, 0);
+    }
+
+    static bool IsHeader(uint8_t const* data, size_t size)
+    {
+        return size >= HEADER_SIZE && data[0] == 'S' && data[1] == 'Q' && data[2] == 'A' && data[3] == VERSION;
+    }
+
+    static void EncodeRecord(MatchmakingAuditRecord const& r, std::vector<uint8_t>& out)
+    {
+        size_t const start = out.size();
+        Put(out, r.timeMs, 8);
+        Put(out, r.guid, 8);
+        Put(out, r.value, 8);
+        Put(out, r.decisionId, 4);
+        Put(out, r.mmr, 4);
+        Put(out, r.rating, 4);
+        Put(out, r.mask, 2);
+        out.push_back(r.type);
+        out.push_back(r.bracket);
+        out.push_back(r.role);
+        out.push_back(r.classId);
+        out.push_back(r.reason);
+        out.push_back(r.flags);
+        Put(out, Checksum(out.data() + start, RECORD_SIZE - 4), 4);
+    }
+
+    static bool DecodeRecord(uint8_t const* data, MatchmakingAuditRecord& r)
+    {
+        if (Get(data + RECORD_SIZE - 4, 4) != Checksum(data, RECORD_SIZE - 4))
+            return false;
+
+        r.timeMs     = Get(data, 8);
+        r.guid       = Get(data + 8, 8);
+        r.value      = Get(data + 16, 8);
+        r.decisionId = uint32_t(Get(data + 24, 4));
+        r.mmr        = uint32_t(Get(data + 28, 4));
+        r.rating     = uint32_t(Get(data + 32, 4));
+        r.mask       = uint16_t(Get(data + 36, 2));
+        r.type       = data[38];
+        r.bracket    = data[39];
+        r.role       = data[40];
+        r.classId    = data[41];
+        r.reason     = data[42];
+        r.flags      = data[43];
+        return r.type >= AUDIT_JOIN && r.type <= AUDIT_SPLIT;
+    }
+
+private:
+    void Run()
+    {
+        uint64_t bytes = HEADER_SIZE;
+        std::FILE* file = OpenAtStart(bytes);
+        std::vector<uint8_t> buffer;
+        buffer.reserve(256 * RECORD_SIZE);
+
+        for (;;)
+        {
+            // Read the flag before draining so nothing submitted before
+            // Stop() is left behind.
+            bool const stopping = _stop.load(std::memory_order_acquire);
+
+            buffer.clear();
+            MatchmakingAuditRecord record;
+            uint64_t batch = 0;
+            while (batch < 4096 && _queue->TryPop(record))
+            {
+                EncodeRecord(record, buffer);
+                ++batch;
+            }
+
+            if (batch && file)
+            {
+                std::fwrite(buffer.data(), 1, buffer.size(), file);
+                std::fflush(file);
+                bytes += buffer.size();
+                _written.fetch_add(batch, std::memory_order_relaxed);
+
+                if (_maxBytes && bytes >= _maxBytes)
+                {
+                    std::fclose(file);
+                    Rotate();
+                    file  = OpenFresh();
+                    bytes = HEADER_SIZE;
+                    _rotations.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+            else if (batch)
+                _dropped.fetch_add(batch, std::memory_order_relaxed);
+
+            if (!batch)
+            {
+                if (stopping)
+                    break;
+
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+        }
+
+        if (file)
+            std::fclose(file);
+    }
+
+    /// Continues the previous run's journal if it has this version's header,
+    /// no torn tail and room left; anything else is rotated to path.1.
+    std::FILE* OpenAtStart(uint64_t& bytes)
+    {
+        bool     resumable = false;
+        uint64_t size      = 0;
+        if (std::FILE* existing = std::fopen(_path.c_str(), "rb"))
+        {
+            uint8_t header[HEADER_SIZE];
+            resumable = std::fread(header, 1, HEADER_SIZE, existing) == HEADER_SIZE && IsHeader(header, HEADER_SIZE);
+            if (std::fseek(existing, 0, SEEK_END) == 0)
+                size = uint64_t(std::max<long>(std::ftell(existing), 0));
+            std::fclose(existing);
+        }
+
+        if (resumable && (size - HEADER_SIZE) % RECORD_SIZE == 0 && (!_maxBytes || size < _maxBytes))
+        {
+            std::FILE* file = std::fopen(_path.c_str(), "ab");
+            if (!file)
+            {
+                _openFailed.store(true, std::memory_order_relaxed);
+                return nullptr;
+            }
+
+            bytes = size;
+            return file;
+        }
+
+        if (size)
+        {
+            Rotate();
+            _rotations.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        bytes = HEADER_SIZE;
+        return OpenFresh();
+    }
+
+    std::FILE* OpenFresh()
+    {
+        std::FILE* file = std::fopen(_path.c_str(), "wb");
+        if (!file)
+        {
+            _openFailed.store(true, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        std::vector<uint8_t> header;
+        EncodeHeader(header);
+        std::fwrite(header.data(), 1, header.size(), file);
+        return file;
+    }
+
+    void Rotate()
+    {
+        std::remove(RotatedPath(_maxFiles - 1).c_str());
+        for (uint32_t i = _maxFiles - 1; i > 0; --i)
+            std::rename(RotatedPath(i - 1).c_str(), RotatedPath(i).c_str());
+    }
+
+    std::string RotatedPath(uint32_t index) const
+    {
+        return index ? _path + "." + std::to_string(index) : _path;
+    }
+
+    static void Put(std::vector<uint8_t>& out, uint64_t value, uint32_t bytes)
+    {
+        for (uint32_t i = 0; i < bytes; ++i)
+            out.push_back(uint8_t(value >> (8 * i)));
+    }
+
+    static uint64_t Get(uint8_t const* data, uint32_t bytes)
+    {
+        uint64_t value = 0;
+        for (uint32_t i = 0; i < bytes; ++i)
+            value |= uint64_t(data[i]) << (8 * i);
+        return value;
+    }
+
+    // FNV-1a; only needs to catch torn writes, not adversarial edits.
+    static uint32_t Checksum(uint8_t const* data, size_t size)
+    {
+        uint32_t hash = 2166136261u;
+        for (size_t i = 0; i < size; ++i)
+        {
+            hash ^= data[i];
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+    std::unique_ptr<BoundedMpmcQueue<MatchmakingAuditRecord>> _queue;
+    std::size_t                                               _capacity;
+    std::thread                                               _thread;
+    std::atomic<bool>                                         _stop{ false };
+    std::atomic<bool>                                         _running{ false };
+    std::atomic<bool>                                         _openFailed{ false };
+    std::atomic<uint64_t>                                     _written{ 0 };
+    std::atomic<uint64_t>                                     _dropped{ 0 };
+    std::atomic<uint64_t>                                     _rotations{ 0 };
+    std::string                                               _path;
+    uint64_t                                                  _maxBytes = 0;
+    uint32_t                                                  _maxFiles = 1;
+};
+
+#endif // _MATCHMAKING_AUDIT_H_
@@ -20,6 +20,7 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <functional>
 #include <vector>
 
 /// Simplified role enum for matchmaking composition logic.
@@ -38,7 +39,7 @@ struct QueuedCandidate
     PlayerRole role;     ///< Detected talent category (DPS or HEALER)
     uint32_t   mmr;      ///< Current matchmaker rating
     uint32_t   joinTime; ///< Queue join timestamp in ms (for FIFO ordering)
-    uint8_t    classId;  ///< WoW class ID (1-11, mirrors player->GetClass())
+    uint8_t    classId = 0; ///< WoW class ID (1-11, mirrors player->GetClass())
 };
 
 /// Result of FindBestTeamSplit(): indices into the selected candidate vector.
@@ -48,8 +49,12 @@ struct TeamSplitResult
     std::vector<uint32_t> team1Indices; ///< Indices for team 1 (Alliance)
     std::vector<uint32_t> team2Indices; ///< Indices for team 2 (Horde)
     uint64_t              mmrDiff = 0;  ///< |sum_mmr_team1 - sum_mmr_team2|
+    int                   ignorePairs = 0; ///< Same-team pairs where one ignores the other
 };
 
+/// Returns true when either candidate has the other on their ignore list.
+using IgnorePredicate = std::function<bool(QueuedCandidate const&, QueuedCandidate const&)>;
+
 /// Standalone implementation of the 3v3 solo queue Phase-2 candidate selection
 /// and Phase-3 exhaustive MMR-balancing team split.
 ///
@@ -146,7 +151,9 @@ public:
     ///
     /// Enumerates all C(n, teamSize) combinations. The split that minimises
     /// |sum_mmr_team1 - sum_mmr_team2| while satisfying role constraints and
-    /// the optional class-stacking constraint is returned.
+    /// the optional class-stacking constraint is returned. Ties are broken by
+    /// the fewest same-team ignore pairs when @p ignores is set
+    /// (Solo.3v3.AvoidSameTeamIgnore).
     ///
     /// @param selected             Candidates to split (size must equal teamSize*2).
     /// @param teamSize             Players per team.
@@ -154,6 +161,7 @@ public:
     /// @param allDpsMatch          When true, no healers are allowed on either team.
     /// @param preventClassStacking 0=off, 1-6=stacking level (see conf.dist).
     /// @param classStackMask       Bitmask of affected classes; 0=all classes.
+    /// @param ignores              Ignore-list lookup; empty disables the tie-breaker.
     /// @returns TeamSplitResult with the optimal split, or !valid if none found.
     TeamSplitResult FindBestTeamSplit(
         std::vector<QueuedCandidate> const& selected,
@@ -161,7 +169,8 @@ public:
         bool                                filterTalents,
         bool                                allDpsMatch,
         uint8_t                             preventClassStacking = 0,
-        uint32_t                            classStackMask       = 0) const
+        uint32_t                            classStackMask       = 0,
+        IgnorePredicate const&              ignores              = {}) const
     {
         TeamSplitResult result;
         uint32_t const  n = static_cast<uint32_t>(selected.size());
@@ -169,21 +178,23 @@ public:
         if (n < teamSize * 2)
             return result;
 
-        bool                  haveBest = false;
-        uint64_t              bestDiff = 0;
+        bool                  haveBest    = false;
+        uint64_t              bestDiff    = 0;
+        int                   bestIgnores = 0;
         std::vector<uint32_t> bestTeam1;
         std::vector<uint32_t> combo(teamSize);
 
         Enumerate(0, 0, combo, selected, teamSize, n,
                   filterTalents, allDpsMatch,
-                  preventClassStacking, classStackMask,
-                  bestTeam1, haveBest, bestDiff);
+                  preventClassStacking, classStackMask, ignores,
+                  bestTeam1, haveBest, bestDiff, bestIgnores);
 
         if (!haveBest)
             return result;
 
         result.valid        = true;
         result.mmrDiff      = bestDiff;
+        result.ignorePairs  = bestIgnores;
         result.team1Indices = bestTeam1;
 
         // Build team2 as the complement of team1
@@ -261,6 +272,23 @@ private:
         return false;
     }
 
+    /// Mirrors Solo3v3::CountIgnorePairs.
+    int CountIgnorePairs(
+        std::vector<uint32_t> const&         indices,
+        std::vector<QueuedCandidate> const&  pool,
+        IgnorePredicate const&               ignores) const
+    {
+        if (!ignores)
+            return 0;
+
+        int pairs = 0;
+        for (uint32_t i = 0; i < indices.size(); ++i)
+            for (uint32_t j = i + 1; j < indices.size(); ++j)
+                if (ignores(pool[indices[i]], pool[indices[j]]))
+                    ++pairs;
+        return pairs;
+    }
+
     void Enumerate(
         uint32_t                            start,
         uint32_t                            depth,
@@ -272,9 +300,11 @@ private:
         bool                                allDpsMatch,
         uint8_t                             preventClassStacking,
         uint32_t                            classStackMask,
+        IgnorePredicate const&              ignores,
         std::vector<uint32_t>&              bestTeam1,
         bool&                               haveBest,
-        uint64_t&                           bestDiff) const
+        uint64_t&                           bestDiff,
+        int&                                bestIgnores) const
     {
         if (depth == teamSize)
         {
@@ -318,10 +348,14 @@ private:
             for (uint32_t i : team2) sum2 += selected[i].mmr;
             uint64_t diff = static_cast<uint64_t>(sum1 > sum2 ? sum1 - sum2 : sum2 - sum1);
 
-            if (!haveBest || diff < bestDiff)
+            // Ignore-pair count as tie-breaker
+            int ign = CountIgnorePairs(combo, selected, ignores) + CountIgnorePairs(team2, selected, ignores);
+
+            if (!haveBest || diff < bestDiff || (diff == bestDiff && ign < bestIgnores))
             {
-                haveBest  = true;
-                bestDiff  = diff;
+                haveBest    = true;
+                bestDiff    = diff;
+                bestIgnores = ign;
                 bestTeam1.assign(combo.begin(), combo.end());
             }
             return;
@@ -332,8 +366,8 @@ private:
             combo[depth] = i;
             Enumerate(i + 1, depth + 1, combo, selected, teamSize, n,
                       filterTalents, allDpsMatch,
-                      preventClassStacking, classStackMask,
-                      bestTeam1, haveBest, bestDiff);
+                      preventClassStacking, classStackMask, ignores,
+                      bestTeam1, haveBest, bestDiff, bestIgnores);
         }
     }
 };
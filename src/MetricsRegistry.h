@@ -0,0 +1,175 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _METRICS_REGISTRY_H_
+#define _METRICS_REGISTRY_H_
+
+#include "LatencyHistogram.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+/// Fixed set of counters and histograms, sharded per thread.
+///
+/// Every thread that records gets its own shard on first use (the only time
+/// the registry mutex is taken). A shard has exactly one writer, so updates
+/// are a relaxed load and store with no read-modify-write or fence, and
+/// Collect() can read shards from another thread at any time without a data
+/// race; it may just miss an update still in flight. Shards are kept when
+/// their thread exits so nothing recorded is lost.
+template <uint32_t COUNTERS, uint32_t HISTOGRAMS>
+class MetricsRegistry
+{
+public:
+    struct Snapshot
+    {
+        std::array<uint64_t, COUNTERS>           counters{};
+        std::array<LatencyHistogram, HISTOGRAMS> histograms;
+    };
+
+    MetricsRegistry() : _id(NextId()) { }
+
+    MetricsRegistry(MetricsRegistry const&) = delete;
+    MetricsRegistry& operator=(MetricsRegistry const&) = delete;
+
+    void Add(uint32_t counter, uint64_t value = 1)
+    {
+        if (counter < COUNTERS)
+            Bump(Local().counters[counter], value);
+    }
+
+    void Record(uint32_t histogram, uint64_t value)
+    {
+        if (histogram >= HISTOGRAMS)
+            return;
+
+        AtomicHistogram& h = Local().histograms[histogram];
+        Bump(h.buckets[LatencyHistogram::BucketIndex(value)], 1);
+        Bump(h.sum, value);
+        if (value < h.min.load(std::memory_order_relaxed))
+            h.min.store(value, std::memory_order_relaxed);
+        if (value > h.max.load(std::memory_order_relaxed))
+            h.max.store(value, std::memory_order_relaxed);
+    }
+
+    /// Sums every shard into @p out (which is overwritten).
+    void Collect(Snapshot& out) const
+    {
+        out = Snapshot();
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        std::array<uint64_t, LatencyHistogram::BUCKET_COUNT> buckets;
+        for (auto const& shard : _shards)
+        {
+            for (uint32_t i = 0; i < COUNTERS; ++i)
+                out.counters[i] += shard->counters[i].load(std::memory_order_relaxed);
+
+            for (uint32_t i = 0; i < HISTOGRAMS; ++i)
+            {
+                AtomicHistogram const& h = shard->histograms[i];
+                for (uint32_t b = 0; b < LatencyHistogram::BUCKET_COUNT; ++b)
+                    buckets[b] = h.buckets[b].load(std::memory_order_relaxed);
+
+                out.histograms[i].MergeBuckets(buckets.data(), h.sum.load(std::memory_order_relaxed),
+                    h.min.load(std::memory_order_relaxed), h.max.load(std::memory_order_relaxed));
+            }
+        }
+    }
+
+    std::size_t ShardCount() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _shards.size();
+    }
+
+private:
+    struct AtomicHistogram
+    {
+        std::atomic<uint64_t> buckets[LatencyHistogram::BUCKET_COUNT] = { };
+        std::atomic<uint64_t> sum{ 0 };
+        std::atomic<uint64_t> min{ UINT64_MAX };
+        std::atomic<uint64_t> max{ 0 };
+    };
+
+    struct Shard
+    {
+        std::atomic<uint64_t> counters[COUNTERS] = { };
+        AtomicHistogram       histograms[HISTOGRAMS];
+    };
+
+    // Single writer per shard: no atomic read-modify-write needed.
+    static void Bump(std::atomic<uint64_t>& value, uint64_t by)
+    {
+        value.store(value.load(std::memory_order_relaxed) + by, std::memory_order_relaxed);
+    }
+
+    Shard& Local()
+    {
+        // Registry ids are never reused, so entries of destroyed registries
+        // can never be mistaken for a live one.
+        thread_local std::vector<std::pair<uint64_t, Shard*>> cache;
+        for (auto const& [id, shard] : cache)
+            if (id == _id)
+                return *shard;
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        _shards.push_back(std::make_unique<Shard>());
+        cache.emplace_back(_id, _shards.back().get());
+        return *_shards.back();
+    }
+
+    static uint64_t NextId()
+    {
+        static std::atomic<uint64_t> next{ 0 };
+        return ++next;
+    }
+
+    uint64_t const                      _id;
+    mutable std::mutex                  _mutex;
+    std::vector<std::unique_ptr<Shard>> _shards;
+};
+
+/// Records the time since construction, in microseconds, into a histogram.
+template <typename Registry>
+class ScopedMetricTimer
+{
+public:
+    ScopedMetricTimer(Registry& registry, uint32_t histogram)
+        : _registry(registry), _histogram(histogram), _start(std::chrono::steady_clock::now()) { }
+
+    ~ScopedMetricTimer()
+    {
+        _registry.Record(_histogram, uint64_t(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - _start).count()));
+    }
+
+    ScopedMetricTimer(ScopedMetricTimer const&) = delete;
+    ScopedMetricTimer& operator=(ScopedMetricTimer const&) = delete;
+
+private:
+    Registry&                             _registry;
+    uint32_t                              _histogram;
+    std::chrono::steady_clock::time_point _start;
+};
+
+#endif // _METRICS_REGISTRY_H_
@@ -0,0 +1,161 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _QUEUE_ETA_MODEL_H_
+#define _QUEUE_ETA_MODEL_H_
+
+#include "LatencyHistogram.h"
+
+#include <cmath>
+#include <cstdint>
+
+/// Event rate with exponential decay: recent events weigh more, and an event
+/// from one half-life ago counts half. Add() and Rate() are O(1).
+class DecayedRate
+{
+public:
+    void Add(uint64_t nowMs, double halfLifeMs)
+    {
+        Decay(nowMs, halfLifeMs);
+        _value += 1.0;
+        if (!_firstMs)
+            _firstMs = nowMs ? nowMs : 1;
+    }
+
+    /// Events per second. While the model has seen less than one decay
+    /// constant of history the rate is taken over the observed span instead,
+    /// so a fresh model is not biased low.
+    double Rate(uint64_t nowMs, double halfLifeMs) const
+    {
+        if (!_firstMs)
+            return 0.0;
+
+        double const tau   = halfLifeMs / std::log(2.0);
+        double const value = _value * Factor(nowMs, halfLifeMs);
+        double const span  = std::fmin(tau, std::fmax(double(nowMs - _firstMs), 1000.0));
+        return value * 1000.0 / span;
+    }
+
+private:
+    void Decay(uint64_t nowMs, double halfLifeMs)
+    {
+        _value *= Factor(nowMs, halfLifeMs);
+        _lastMs = nowMs;
+    }
+
+    double Factor(uint64_t nowMs, double halfLifeMs) const
+    {
+        if (nowMs <= _lastMs || halfLifeMs <= 0.0)
+            return 1.0;
+
+        return std::exp2(-double(nowMs - _lastMs) / halfLifeMs);
+    }
+
+    double   _value   = 0.0;
+    uint64_t _lastMs  = 0;
+    uint64_t _firstMs = 0;
+};
+
+/// Role-aware wait time model for one solo queue bracket.
+///
+/// Tracks, per role, the decayed rate at which players join and at which
+/// they are matched, plus the wait times of matched players in a two
+/// generation histogram (the older generation is dropped every half-life).
+/// A player with N players of the same role ahead of them is expected to
+/// wait (N + 1) / matchRate; before any match has been seen the recent wait
+/// time median is used instead.
+class QueueEtaModel
+{
+public:
+    static constexpr uint32_t ROLES = 3; //< MELEE, RANGE, HEALER
+
+    explicit QueueEtaModel(uint32_t halfLifeSec = 900) { SetHalfLife(halfLifeSec); }
+
+    void SetHalfLife(uint32_t halfLifeSec) { _halfLifeMs = double(halfLifeSec ? halfLifeSec : 1) * 1000.0; }
+
+    void OnJoin(uint32_t role, uint64_t nowMs)
+    {
+        if (role < ROLES)
+            _roles[role].arrivals.Add(nowMs, _halfLifeMs);
+    }
+
+    void OnMatched(uint32_t role, uint64_t nowMs, uint64_t waitedMs)
+    {
+        if (role >= ROLES)
+            return;
+
+        Role& r = _roles[role];
+        r.matches.Add(nowMs, _halfLifeMs);
+
+        if (nowMs >= r.generationStartMs + uint64_t(_halfLifeMs))
+        {
+            r.previous = r.current;
+            r.current.Reset();
+            r.generationStartMs = nowMs;
+        }
+
+        r.current.Record(waitedMs / 1000); // seconds keep the buckets meaningful
+    }
+
+    /// Expected remaining wait in ms for a player with @p ahead players of
+    /// the same role queued before them. 0 means no estimate yet.
+    uint64_t EstimateWaitMs(uint32_t role, uint32_t ahead, uint64_t nowMs) const
+    {
+        if (role >= ROLES)
+            return 0;
+
+        double const matchRate = MatchRate(role, nowMs);
+        if (matchRate > 0.0)
+            return uint64_t(double(ahead + 1) / matchRate * 1000.0);
+
+        return WaitPercentileSec(role, 50) * 1000;
+    }
+
+    double ArrivalRate(uint32_t role, uint64_t nowMs) const { return role < ROLES ? _roles[role].arrivals.Rate(nowMs, _halfLifeMs) : 0.0; }
+    double MatchRate(uint32_t role, uint64_t nowMs) const { return role < ROLES ? _roles[role].matches.Rate(nowMs, _halfLifeMs) : 0.0; }
+
+    /// Wait time percentile of recently matched players, in seconds.
+    uint64_t WaitPercentileSec(uint32_t role, double pct) const
+    {
+        if (role >= ROLES)
+            return 0;
+
+        LatencyHistogram merged = _roles[role].current;
+        merged.Merge(_roles[role].previous);
+        return merged.Percentile(pct);
+    }
+
+    uint64_t MatchedSamples(uint32_t role) const
+    {
+        return role < ROLES ? _roles[role].current.Count() + _roles[role].previous.Count() : 0;
+    }
+
+private:
+    struct Role
+    {
+        DecayedRate      arrivals;
+        DecayedRate      matches;
+        LatencyHistogram current;
+        LatencyHistogram previous;
+        uint64_t         generationStartMs = 0;
+    };
+
+    double _halfLifeMs = 900000.0;
+    Role   _roles[ROLES];
+};
+
+#endif // _QUEUE_ETA_MODEL_H_
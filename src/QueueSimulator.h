@@ -0,0 +1,330 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _QUEUE_SIMULATOR_H_
+#define _QUEUE_SIMULATOR_H_
+
+#include "LatencyHistogram.h"
+#include "MatchmakingComposer.h"
+
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <random>
+#include <vector>
+
+/// One player joining the simulated queue.
+struct SimArrival
+{
+    uint64_t   timeMs  = 0;
+    PlayerRole role    = PlayerRole::DPS;
+    uint32_t   mmr     = 1500;
+    uint8_t    classId = 1;
+};
+
+/// Matchmaking settings under evaluation; mirrors the Solo.3v3.* options.
+struct SimSettings
+{
+    uint32_t teamSize             = 3;
+    bool     filterTalents        = true;
+    uint32_t allDpsTimerMs        = 0;     //< Solo.3v3.FilterTalents.AllDPSTimer; 0 = all-DPS eligible at join
+    uint8_t  preventClassStacking = 0;
+    uint32_t classStackMask       = 0;
+    uint64_t meanPatienceMs       = 0;     //< mean time before a player gives up (exponential); 0 = never
+};
+
+/// Synthetic arrival process: Poisson arrivals with a role mix, a normal MMR
+/// distribution and a weighted class distribution. Healers only draw
+/// healing-capable classes.
+class SimArrivalGenerator
+{
+public:
+    static constexpr uint8_t MAX_CLASS = 11;
+
+    SimArrivalGenerator(double arrivalsPerMinute, double healerShare, double mmrMean, double mmrStdDev,
+        std::vector<double> classWeights, uint64_t seed)
+        : _rng(seed), _interArrival(arrivalsPerMinute > 0.0 ? arrivalsPerMinute / 60000.0 : 1e-12),
+        _healer(std::clamp(healerShare, 0.0, 1.0)), _mmr(mmrMean, mmrStdDev)
+    {
+        // Class 10 does not exist; weights are indexed by classId - 1.
+        classWeights.resize(MAX_CLASS, 0.0);
+        classWeights[9] = 0.0;
+        std::vector<double> healerWeights(MAX_CLASS, 0.0);
+        for (uint8_t classId : { 2, 5, 7, 11 })
+            healerWeights[classId - 1] = classWeights[classId - 1];
+
+        if (std::all_of(classWeights.begin(), classWeights.end(), [](double w) { return w <= 0.0; }))
+            for (uint8_t i = 0; i < MAX_CLASS; ++i)
+                classWeights[i] = i == 9 ? 0.0 : 1.0;
+        if (std::all_of(healerWeights.begin(), healerWeights.end(), [](double w) { return w <= 0.0; }))
+            for (uint8_t classId : { 2, 5, 7, 11 })
+                healerWeights[classId - 1] = 1.0;
+
+        _dpsClass    = std::discrete_distribution<uint32_t>(classWeights.begin(), classWeights.end());
+        _healerClass = std::discrete_distribution<uint32_t>(healerWeights.begin(), healerWeights.end());
+    }
+
+    SimArrival Next()
+    {
+        _nowMs += uint64_t(_interArrival(_rng)) + 1;
+
+        SimArrival arrival;
+        arrival.timeMs  = _nowMs;
+        arrival.role    = _healer(_rng) ? PlayerRole::HEALER : PlayerRole::DPS;
+        arrival.mmr     = uint32_t(std::max(0.0, _mmr(_rng)));
+        arrival.classId = uint8_t((arrival.role == PlayerRole::HEALER ? _healerClass(_rng) : _dpsClass(_rng)) + 1);
+        return arrival;
+    }
+
+private:
+    std::mt19937_64                         _rng;
+    std::exponential_distribution<double>   _interArrival;
+    std::bernoulli_distribution             _healer;
+    std::normal_distribution<double>        _mmr;
+    std::discrete_distribution<uint32_t>    _dpsClass;
+    std::discrete_distribution<uint32_t>    _healerClass;
+    uint64_t                                _nowMs = 0;
+};
+
+/// Results of one simulation run. Waits are in seconds.
+struct SimReport
+{
+    uint64_t         simulatedMs      = 0;
+    uint64_t         arrivals[2]      = { };  //< indexed by PlayerRole
+    uint64_t         abandoned[2]     = { };
+    uint64_t         stillQueued[2]   = { };
+    uint64_t         matches          = 0;
+    uint64_t         allDpsMatches    = 0;
+    uint64_t         passes           = 0;
+    uint64_t         noSplitPasses    = 0;    //< a full selection had no legal split (class stacking)
+    uint64_t         healerStarvedMs  = 0;    //< time with enough DPS for a match waiting on healers
+    LatencyHistogram waitSec[2];
+    LatencyHistogram mmrDiff;
+};
+
+/// Event-driven simulation of the solo queue matchmaker.
+///
+/// Simulated time jumps from one event to the next (arrival, AllDPS timer
+/// expiry, player giving up), and a matchmaking pass runs after each event
+/// until it stops forming matches, the same way CheckSolo3v3Arena is re-run
+/// whenever the queue changes. Selection and team split are delegated to
+/// MatchmakingComposer.
+///
+/// Only the oldest 2 healers and oldest 2 * teamSize DPS are handed to the
+/// composer: its selection only ever takes FIFO prefixes of the role
+/// buckets, so the result is the same as passing the whole queue, and a
+/// pass costs O(1) however long the DPS backlog grows.
+class QueueSimulator
+{
+public:
+    explicit QueueSimulator(SimSettings const& settings, uint64_t seed = 1)
+        : _settings(settings), _rng(seed) { }
+
+    /// Runs until @p next returns false or the next event is later than
+    /// @p endMs. Players still queued at the end are reported, not counted
+    /// as waits. A simulator runs once.
+    SimReport Run(std::function<bool(SimArrival&)> const& next, uint64_t endMs)
+    {
+        SimArrival arrival;
+        bool haveArrival = next(arrival);
+
+        for (;;)
+        {
+            uint64_t eventMs = std::numeric_limits<uint64_t>::max();
+            if (haveArrival)
+                eventMs = arrival.timeMs;
+            if (!_timers.empty())
+                eventMs = std::min(eventMs, _timers.top());
+            if (!_leaves.empty())
+                eventMs = std::min(eventMs, _leaves.top().first);
+
+            if (eventMs > endMs || eventMs == std::numeric_limits<uint64_t>::max())
+                break;
+
+            Advance(eventMs);
+
+            if (haveArrival && arrival.timeMs == eventMs)
+            {
+                Join(arrival);
+                haveArrival = next(arrival);
+            }
+            else if (!_timers.empty() && _timers.top() == eventMs)
+                _timers.pop();
+            else
+            {
+                Leave(_leaves.top().second);
+                _leaves.pop();
+            }
+
+            while (TryMatch()) { }
+        }
+
+        Advance(std::max(_now, endMs == std::numeric_limits<uint64_t>::max() ? _now : endMs));
+        _report.simulatedMs    = _now;
+        _report.stillQueued[0] = _queued[0];
+        _report.stillQueued[1] = _queued[1];
+        return _report;
+    }
+
+private:
+    struct Queued
+    {
+        uint32_t   id;
+        uint64_t   joinMs;
+        uint32_t   mmr;
+        PlayerRole role;
+        uint8_t    classId;
+    };
+
+    void Advance(uint64_t toMs)
+    {
+        if (toMs <= _now)
+            return;
+
+        if (_settings.filterTalents && _queued[0] >= _settings.teamSize * 2 - 2 && _queued[1] < 2)
+            _report.healerStarvedMs += toMs - _now;
+        _now = toMs;
+    }
+
+    void Join(SimArrival const& arrival)
+    {
+        uint32_t const role = uint32_t(arrival.role);
+        uint32_t const id   = _nextId++;
+
+        _buckets[role].push_back({ id, arrival.timeMs, arrival.mmr, arrival.role, arrival.classId });
+        _live.push_back(true);
+        ++_queued[role];
+        ++_report.arrivals[role];
+
+        if (arrival.role == PlayerRole::DPS && _settings.filterTalents && _settings.allDpsTimerMs)
+            _timers.push(arrival.timeMs + _settings.allDpsTimerMs);
+
+        if (_settings.meanPatienceMs)
+        {
+            std::exponential_distribution<double> patience(1.0 / double(_settings.meanPatienceMs));
+            _leaves.push({ arrival.timeMs + uint64_t(patience(_rng)) + 1, (uint64_t(role) << 32) | id });
+        }
+    }
+
+    void Leave(uint64_t key)
+    {
+        uint32_t const role = uint32_t(key >> 32);
+        uint32_t const id = uint32_t(key);
+        if (_live[id])
+        {
+            _live[id] = false;
+            --_queued[role];
+            ++_report.abandoned[role];
+        }
+    }
+
+    /// Appends up to @p count live players from the front of @p role's
+    /// bucket, dropping players who already left or were matched.
+    void Window(uint32_t role, uint32_t count, std::vector<Queued>& out)
+    {
+        std::deque<Queued>& bucket = _buckets[role];
+        while (!bucket.empty() && !_live[bucket.front().id])
+            bucket.pop_front();
+
+        for (auto itr = bucket.begin(); itr != bucket.end() && count; ++itr)
+        {
+            if (!_live[itr->id])
+                continue;
+
+            out.push_back(*itr);
+            --count;
+        }
+    }
+
+    bool TryMatch()
+    {
+        uint32_t const players = _settings.teamSize * 2;
+        if (_queued[0] + _queued[1] < players)
+            return false;
+
+        // Queues the composer is certain to reject, skipped for speed.
+        uint64_t const healers = _queued[uint32_t(PlayerRole::HEALER)];
+        if (_settings.filterTalents && _settings.teamSize > 1 &&
+            (healers == 1 || (healers >= 2 && _queued[0] < players - 2)))
+            return false;
+
+        _window.clear();
+        Window(uint32_t(PlayerRole::HEALER), _settings.filterTalents ? 2 : players, _window);
+        Window(uint32_t(PlayerRole::DPS), players, _window);
+        std::sort(_window.begin(), _window.end(), [](Queued const& a, Queued const& b)
+        {
+            return a.joinMs != b.joinMs ? a.joinMs < b.joinMs : a.id < b.id;
+        });
+        if (!_settings.filterTalents && _window.size() > players)
+            _window.resize(players);
+
+        // The composer works on 32-bit ms; rebase on the oldest player.
+        uint64_t const base = _window.front().joinMs;
+        _candidates.clear();
+        for (Queued const& q : _window)
+            _candidates.push_back({ q.id, q.role, q.mmr, uint32_t(q.joinMs - base), q.classId });
+
+        ++_report.passes;
+        uint32_t const now = uint32_t(std::min<uint64_t>(_now - base, std::numeric_limits<uint32_t>::max()));
+        bool allDps = false;
+        if (!_composer.SelectCandidates(_candidates, _settings.teamSize, _settings.filterTalents, _settings.allDpsTimerMs,
+            now, _selected, allDps))
+            return false;
+
+        TeamSplitResult const split = _composer.FindBestTeamSplit(_selected, _settings.teamSize, _settings.filterTalents, allDps,
+            _settings.preventClassStacking, _settings.classStackMask);
+        if (!split.valid)
+        {
+            // The server keeps picking the same players until the queue changes.
+            ++_report.noSplitPasses;
+            return false;
+        }
+
+        for (QueuedCandidate const& c : _selected)
+        {
+            uint32_t const role = uint32_t(c.role);
+            _live[c.id] = false;
+            --_queued[role];
+            _report.waitSec[role].Record((now - c.joinTime) / 1000);
+        }
+
+        ++_report.matches;
+        if (allDps)
+            ++_report.allDpsMatches;
+        _report.mmrDiff.Record(split.mmrDiff);
+        return true;
+    }
+
+    SimSettings                     _settings;
+    MatchmakingComposer             _composer;
+    std::mt19937_64                 _rng;
+    SimReport                       _report;
+    uint64_t                        _now    = 0;
+    uint32_t                        _nextId = 0;
+    uint64_t                        _queued[2] = { };
+    std::deque<Queued>              _buckets[2];
+    std::vector<bool>               _live;    //< indexed by id: still queued
+    std::priority_queue<uint64_t, std::vector<uint64_t>, std::greater<uint64_t>> _timers;
+    std::priority_queue<std::pair<uint64_t, uint64_t>, std::vector<std::pair<uint64_t, uint64_t>>, std::greater<std::pair<uint64_t, uint64_t>>> _leaves;
+    std::vector<Queued>             _window;
+    std::vector<QueuedCandidate>    _candidates;
+    std::vector<QueuedCandidate>    _selected;
+};
+
+#endif // _QUEUE_SIMULATOR_H_
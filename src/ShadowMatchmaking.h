@@ -0,0 +1,320 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _SHADOW_MATCHMAKING_H_
+#define _SHADOW_MATCHMAKING_H_
+
+#include "BoundedMpmcQueue.h"
+#include "InMemorySoloQueue.h"
+#include "LatencyHistogram.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <thread>
+
+/// Queue candidates as one CheckSolo3v3Arena pass saw them.
+struct ShadowSnapshot
+{
+    uint32_t                          takenMs = 0;   //< same clock as the entries' joinTime
+    uint32_t                          bracket = 0;
+    bool                              rated   = false;
+    std::vector<InMemoryQueuedPlayer> entries;       //< in queue order
+};
+
+/// A matchmaking policy evaluated in shadow: matchmaker options plus an
+/// optional MMR window on the selected players.
+struct ShadowPolicy
+{
+    std::string          name;
+    SoloMatchmakerConfig config;
+    uint32_t             maxMmrSpread = 0; //< highest minus lowest selected MMR; 0 = no window
+};
+
+/// What a policy would have done with the snapshots it saw.
+struct ShadowPolicyStats
+{
+    std::string      name;
+    uint64_t         snapshots     = 0;
+    uint64_t         matches       = 0;     //< would have formed
+    uint64_t         allDpsMatches = 0;
+    uint64_t         stops[AUDIT_REASON_NO_SPLIT + 1] = { }; //< why a snapshot stopped forming matches
+    uint64_t         windowStops   = 0;     //< stopped by maxMmrSpread
+    LatencyHistogram mmrDiff;               //< |team MMR sum difference| per match
+    LatencyHistogram waitSec;               //< wait of each selected player at snapshot time
+    LatencyHistogram evalUs;                //< cost of evaluating one snapshot
+};
+
+/// Shadow evaluation of matchmaking policies. The world thread hands over
+/// queue snapshots with Submit(), which never blocks: when the background
+/// thread is behind, snapshots are dropped and counted. The thread matches
+/// each snapshot to exhaustion with every policy on a private
+/// InMemorySoloQueue, so nothing it does reaches the live queue.
+class ShadowMatchmaking
+{
+public:
+    explicit ShadowMatchmaking(std::size_t capacity = 4) : _queue(capacity) { }
+    ~ShadowMatchmaking() { Stop(); }
+
+    ShadowMatchmaking(ShadowMatchmaking const&) = delete;
+    ShadowMatchmaking& operator=(ShadowMatchmaking const&) = delete;
+
+    /// Starts the evaluation thread; at most @p maxMatches matches are formed
+    /// per snapshot and policy.
+    void Start(std::vector<ShadowPolicy> const& policies, uint32_t maxMatches)
+    {
+        Stop();
+        _policies   = policies;
+        _maxMatches = maxMatches ? maxMatches : 1;
+        {
+            std::lock_guard<std::mutex> lock(_statsLock);
+            _stats.assign(policies.size(), ShadowPolicyStats());
+            for (std::size_t i = 0; i < policies.size(); ++i)
+                _stats[i].name = policies[i].name;
+        }
+        _stop.store(false, std::memory_order_relaxed);
+        _running.store(true, std::memory_order_release);
+        _thread = std::thread([this]() { Run(); });
+    }
+
+    /// Evaluates everything already submitted, then joins the thread.
+    void Stop()
+    {
+        if (!_thread.joinable())
+            return;
+
+        _stop.store(true, std::memory_order_release);
+        _thread.join();
+        _running.store(false, std::memory_order_release);
+    }
+
+    bool IsRunning() const { return _running.load(std::memory_order_acquire); }
+
+    bool Submit(ShadowSnapshot&& snapshot)
+    {
+        if (_queue.TryPush(std::move(snapshot)))
+            return true;
+
+        _dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    uint64_t Evaluated() const { return _evaluated.load(std::memory_order_relaxed); }
+    uint64_t Dropped()   const { return _dropped.load(std::memory_order_relaxed); }
+
+    /// Copies the per-policy results so far, in policy order.
+    void Collect(std::vector<ShadowPolicyStats>& out) const
+    {
+        std::lock_guard<std::mutex> lock(_statsLock);
+        out = _stats;
+    }
+
+    /// Matches @p snapshot to exhaustion with @p policy, adding to @p stats.
+    static void Evaluate(ShadowPolicy const& policy, ShadowSnapshot const& snapshot, uint32_t maxMatches,
+        ShadowPolicyStats& stats)
+    {
+        auto const start = std::chrono::steady_clock::now();
+
+        InMemorySoloQueue queue;
+        for (InMemoryQueuedPlayer player : snapshot.entries)
+        {
+            player.bracket = snapshot.bracket;
+            player.rated   = snapshot.rated;
+            queue.Add(player);
+        }
+
+        SoloMatchmaker<InMemorySoloQueue> matchmaker(queue, policy.config);
+        SoloMatchResult<InMemorySoloQueue> result;
+        uint32_t matches = 0;
+        for (; matches < maxMatches; ++matches)
+        {
+            if (!matchmaker.Check(snapshot.bracket, snapshot.rated, result))
+            {
+                ++stats.stops[result.reason];
+                break;
+            }
+
+            uint32_t low = UINT32_MAX, high = 0;
+            int64_t  sums[2] = { 0, 0 };
+            for (uint8_t team : { SOLO_TEAM_ALLIANCE, SOLO_TEAM_HORDE })
+            {
+                for (InMemoryQueuedPlayer const* player : queue.Pool(team))
+                {
+                    low  = std::min(low, player->mmr);
+                    high = std::max(high, player->mmr);
+                    sums[team] += player->mmr;
+                }
+            }
+
+            if (policy.maxMmrSpread && high - low > policy.maxMmrSpread)
+            {
+                ++stats.windowStops;
+                break;
+            }
+
+            ++stats.matches;
+            stats.allDpsMatches += result.allDpsMatch;
+            stats.mmrDiff.Record(uint64_t(std::llabs(sums[SOLO_TEAM_ALLIANCE] - sums[SOLO_TEAM_HORDE])));
+            for (uint8_t team : { SOLO_TEAM_ALLIANCE, SOLO_TEAM_HORDE })
+                for (InMemoryQueuedPlayer const* player : queue.Pool(team))
+                    stats.waitSec.Record(snapshot.takenMs >= player->joinTime ? (snapshot.takenMs - player->joinTime) / 1000 : 0);
+            queue.RemovePooled();
+        }
+
+        ++stats.snapshots;
+        stats.evalUs.Record(uint64_t(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start).count()));
+    }
+
+    /// Parses "name:Key=value,Key=value; name2:..." on top of @p base. Keys:
+    /// FilterTalents, PreventClassStacking, PreventClassStacking.Classes and
+    /// MaxMMRSpread. Returns false and names the bad part in @p error.
+    static bool ParsePolicies(std::string const& spec, SoloMatchmakerConfig const& base, std::vector<ShadowPolicy>& out,
+        std::string& error)
+    {
+        for (std::string const& item : Split(spec, ';'))
+        {
+            std::string const policySpec = Trim(item);
+            if (policySpec.empty())
+                continue;
+
+            ShadowPolicy policy;
+            policy.config = base;
+
+            std::size_t const colon = policySpec.find(':');
+            policy.name = Trim(policySpec.substr(0, colon));
+            if (policy.name.empty())
+            {
+                error = "unnamed policy '" + policySpec + "'";
+                return false;
+            }
+
+            std::string const settings = colon == std::string::npos ? std::string() : policySpec.substr(colon + 1);
+            for (std::string const& setting : Split(settings, ','))
+            {
+                if (Trim(setting).empty())
+                    continue;
+
+                std::size_t const eq = setting.find('=');
+                std::string const key = Trim(setting.substr(0, eq));
+                char* end = nullptr;
+                std::string const text = eq == std::string::npos ? std::string() : Trim(setting.substr(eq + 1));
+                unsigned long const value = std::strtoul(text.c_str(), &end, 10);
+                if (text.empty() || *end)
+                {
+                    error = policy.name + ": bad value in '" + Trim(setting) + "'";
+                    return false;
+                }
+
+                if (key == "FilterTalents")
+                    policy.config.filterTalents = value != 0;
+                else if (key == "PreventClassStacking")
+                    policy.config.preventClassStacking = uint8_t(value);
+                else if (key == "PreventClassStacking.Classes")
+                    policy.config.classStackMask = uint32_t(value);
+                else if (key == "MaxMMRSpread")
+                    policy.maxMmrSpread = uint32_t(value);
+                else
+                {
+                    error = policy.name + ": unknown key '" + key + "'";
+                    return false;
+                }
+            }
+
+            out.push_back(policy);
+        }
+        return true;
+    }
+
+private:
+    static std::vector<std::string> Split(std::string const& text, char separator)
+    {
+        std::vector<std::string> parts;
+        std::size_t start = 0;
+        for (std::size_t pos; (pos = text.find(separator, start)) != std::string::npos; start = pos + 1)
+            parts.push_back(text.substr(start, pos - start));
+        parts.push_back(text.substr(start));
+        return parts;
+    }
+
+    static std::string Trim(std::string const& text)
+    {
+        std::size_t const first = text.find_first_not_of(" \t");
+        if (first == std::string::npos)
+            return std::string();
+        return text.substr(first, text.find_last_not_of(" \t") - first + 1);
+    }
+
+    void Run()
+    {
+        std::vector<ShadowPolicyStats> batch(_policies.size());
+        for (;;)
+        {
+            bool const stopping = _stop.load(std::memory_order_acquire);
+
+            ShadowSnapshot snapshot;
+            if (!_queue.TryPop(snapshot))
+            {
+                if (stopping)
+                    break;
+
+                std::this_thread::sleep_for(std::chrono::milliseconds(50));
+                continue;
+            }
+
+            // Evaluate outside the lock; readers only wait for the merge.
+            for (std::size_t i = 0; i < _policies.size(); ++i)
+            {
+                batch[i] = ShadowPolicyStats();
+                Evaluate(_policies[i], snapshot, _maxMatches, batch[i]);
+            }
+
+            std::lock_guard<std::mutex> lock(_statsLock);
+            for (std::size_t i = 0; i < _policies.size(); ++i)
+                Merge(_stats[i], batch[i]);
+            _evaluated.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    static void Merge(ShadowPolicyStats& into, ShadowPolicyStats const& from)
+    {
+        into.snapshots     += from.snapshots;
+        into.matches       += from.matches;
+        into.allDpsMatches += from.allDpsMatches;
+        into.windowStops   += from.windowStops;
+        for (std::size_t i = 0; i < sizeof(into.stops) / sizeof(into.stops[0]); ++i)
+            into.stops[i] += from.stops[i];
+        into.mmrDiff.Merge(from.mmrDiff);
+        into.waitSec.Merge(from.waitSec);
+        into.evalUs.Merge(from.evalUs);
+    }
+
+    BoundedMpmcQueue<ShadowSnapshot> _queue;
+    std::vector<ShadowPolicy>        _policies;
+    uint32_t                         _maxMatches = 1;
+    std::vector<ShadowPolicyStats>   _stats;
+    mutable std::mutex               _statsLock;
+    std::thread                      _thread;
+    std::atomic<bool>                _stop{ false };
+    std::atomic<bool>                _running{ false };
+    std::atomic<uint64_t>            _evaluated{ 0 };
+    std::atomic<uint64_t>            _dropped{ 0 };
+};
+
+#endif // _SHADOW_MATCHMAKING_H_
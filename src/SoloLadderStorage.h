@@ -0,0 +1,264 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _SOLO_LADDER_STORAGE_H_
+#define _SOLO_LADDER_STORAGE_H_
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+constexpr uint32_t SOLO_RATING_DEFAULT = 1500;
+constexpr uint32_t SOLO_RATING_MAX     = 5000;
+
+/// One player's solo ladder standing.
+struct SoloLadderRow
+{
+    uint32_t rating = SOLO_RATING_DEFAULT;
+    uint32_t mmr    = SOLO_RATING_DEFAULT;
+    uint32_t games  = 0;
+    uint32_t wins   = 0;
+    uint32_t losses = 0;
+};
+
+/// A relative ladder change: rating and MMR move by the same delta, the
+/// counters are added.
+struct SoloLadderUpdate
+{
+    int32_t  delta  = 0;
+    uint32_t games  = 0;
+    uint32_t wins   = 0;
+    uint32_t losses = 0;
+};
+
+struct SoloLadderBatchRow
+{
+    uint32_t         guid = 0;
+    SoloLadderUpdate update;
+};
+
+/// Rating rules of the solo ladder, shared by every storage backend.
+namespace SoloLadder
+{
+    /// Elo expectation of @p playerMmr against @p opponentMmr.
+    inline float ExpectedScore(uint32_t playerMmr, uint32_t opponentMmr)
+    {
+        float const difference = float(int32_t(opponentMmr) - int32_t(playerMmr));
+        return 1.0f / (1.0f + std::pow(10.0f, difference / 400.0f));
+    }
+
+    /// Rating change of a won or lost match.
+    inline int32_t MatchDelta(uint32_t playerMmr, uint32_t opponentMmr, int32_t kFactor, bool isWin)
+    {
+        float const score = isWin ? 1.0f : 0.0f;
+        return int32_t(std::lround(float(kFactor) * (score - ExpectedScore(playerMmr, opponentMmr))));
+    }
+
+    /// @p value moved by @p delta, kept within [0, SOLO_RATING_MAX].
+    inline uint32_t ApplyDelta(uint32_t value, int32_t delta)
+    {
+        return uint32_t(std::clamp<int64_t>(int64_t(value) + delta, 0, SOLO_RATING_MAX));
+    }
+
+    /// @p row after @p update.
+    inline void Apply(SoloLadderRow& row, SoloLadderUpdate const& update)
+    {
+        row.rating  = ApplyDelta(row.rating, update.delta);
+        row.mmr     = ApplyDelta(row.mmr, update.delta);
+        row.games  += update.games;
+        row.wins   += update.wins;
+        row.losses += update.losses;
+    }
+}
+
+/// Where the solo ladder lives, keyed by character guid (low part). Every
+/// call is made from the world thread; LoadAsync() callbacks run from
+/// ProcessCallbacks(), also on the world thread.
+class SoloLadderStorage
+{
+public:
+    using LoadCallback = std::function<void(bool found, SoloLadderRow const& row)>;
+
+    virtual ~SoloLadderStorage() = default;
+
+    /// False while the backend cannot be used, e.g. its table is missing.
+    virtual bool Available() = 0;
+
+    /// Reads the row of @p guid; false when there is none.
+    virtual bool Load(uint32_t guid, SoloLadderRow& row) = 0;
+    virtual void LoadAsync(uint32_t guid, LoadCallback callback) = 0;
+
+    /// Creates a default row for @p guid unless it already has one.
+    virtual void Create(uint32_t guid, uint32_t now) = 0;
+
+    /// Applies @p update to the row of @p guid, creating it from the
+    /// defaults first. Must be safe against a concurrent update of the same
+    /// row: both deltas are kept.
+    virtual void Update(uint32_t guid, SoloLadderUpdate const& update, uint32_t now) = 0;
+
+    /// Applies one update per row (at most one row per guid), as Update()
+    /// would. Returns the number of statements it took the backend.
+    virtual uint32_t UpdateBatch(std::vector<SoloLadderBatchRow> const& rows, uint32_t now)
+    {
+        for (SoloLadderBatchRow const& row : rows)
+            Update(row.guid, row.update, now);
+        return uint32_t(rows.size());
+    }
+
+    /// Runs the callbacks of finished LoadAsync() calls.
+    virtual void ProcessCallbacks() { }
+};
+
+/// Ladder kept in process memory, for tests, benchmarks and staging servers.
+/// Lost on restart.
+class InMemorySoloLadderStorage : public SoloLadderStorage
+{
+public:
+    bool Available() override { return _available; }
+
+    bool Load(uint32_t guid, SoloLadderRow& row) override
+    {
+        auto const itr = _rows.find(guid);
+        if (itr == _rows.end())
+            return false;
+
+        row = itr->second.row;
+        return true;
+    }
+
+    void LoadAsync(uint32_t guid, LoadCallback callback) override
+    {
+        SoloLadderRow row;
+        bool const found = Load(guid, row);
+        callback(found, row);
+    }
+
+    void Create(uint32_t guid, uint32_t now) override
+    {
+        _rows.emplace(guid, StoredRow{ SoloLadderRow(), now });
+    }
+
+    void Update(uint32_t guid, SoloLadderUpdate const& update, uint32_t now) override
+    {
+        StoredRow& stored = _rows.emplace(guid, StoredRow{ SoloLadderRow(), now }).first->second;
+        SoloLadder::Apply(stored.row, update);
+        stored.lastUpdate = now;
+    }
+
+    void SetAvailable(bool available) { _available = available; }
+    std::size_t Size() const { return _rows.size(); }
+
+private:
+    struct StoredRow
+    {
+        SoloLadderRow row;
+        uint32_t      lastUpdate = 0;
+    };
+
+    std::unordered_map<uint32_t, StoredRow> _rows;
+    bool                                    _available = true;
+};
+
+enum SoloLadderOp : uint8_t
+{
+    SOLO_LADDER_OP_AVAILABLE = 0,
+    SOLO_LADDER_OP_LOAD,
+    SOLO_LADDER_OP_LOAD_ASYNC,        //< from the call to its callback
+    SOLO_LADDER_OP_CREATE,
+    SOLO_LADDER_OP_UPDATE,
+    SOLO_LADDER_OP_UPDATE_BATCH,
+    MAX_SOLO_LADDER_OP
+};
+
+/// Times every call into another storage and reports it to a sink, in
+/// microseconds. The wrapped storage must outlive this one.
+class TimedSoloLadderStorage : public SoloLadderStorage
+{
+public:
+    using Sink = std::function<void(SoloLadderOp op, uint64_t us)>;
+
+    TimedSoloLadderStorage(SoloLadderStorage& storage, Sink sink) : _storage(storage), _sink(std::move(sink)) { }
+
+    bool Available() override
+    {
+        auto const start = Clock::now();
+        bool const available = _storage.Available();
+        Report(SOLO_LADDER_OP_AVAILABLE, start);
+        return available;
+    }
+
+    bool Load(uint32_t guid, SoloLadderRow& row) override
+    {
+        auto const start = Clock::now();
+        bool const found = _storage.Load(guid, row);
+        Report(SOLO_LADDER_OP_LOAD, start);
+        return found;
+    }
+
+    void LoadAsync(uint32_t guid, LoadCallback callback) override
+    {
+        auto const start = Clock::now();
+        _storage.LoadAsync(guid, [this, start, callback = std::move(callback)](bool found, SoloLadderRow const& row)
+        {
+            Report(SOLO_LADDER_OP_LOAD_ASYNC, start);
+            callback(found, row);
+        });
+    }
+
+    void Create(uint32_t guid, uint32_t now) override
+    {
+        auto const start = Clock::now();
+        _storage.Create(guid, now);
+        Report(SOLO_LADDER_OP_CREATE, start);
+    }
+
+    void Update(uint32_t guid, SoloLadderUpdate const& update, uint32_t now) override
+    {
+        auto const start = Clock::now();
+        _storage.Update(guid, update, now);
+        Report(SOLO_LADDER_OP_UPDATE, start);
+    }
+
+    uint32_t UpdateBatch(std::vector<SoloLadderBatchRow> const& rows, uint32_t now) override
+    {
+        auto const start = Clock::now();
+        uint32_t const statements = _storage.UpdateBatch(rows, now);
+        Report(SOLO_LADDER_OP_UPDATE_BATCH, start);
+        return statements;
+    }
+
+    void ProcessCallbacks() override { _storage.ProcessCallbacks(); }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    void Report(SoloLadderOp op, Clock::time_point start) const
+    {
+        if (_sink)
+            _sink(op, uint64_t(std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count()));
+    }
+
+    SoloLadderStorage& _storage;
+    Sink               _sink;
+};
+
+#endif // _SOLO_LADDER_STORAGE_H_
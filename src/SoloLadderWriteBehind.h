@@ -0,0 +1,172 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _SOLO_LADDER_WRITE_BEHIND_H_
+#define _SOLO_LADDER_WRITE_BEHIND_H_
+
+#include "SoloLadderStorage.h"
+
+#include <chrono>
+#include <unordered_map>
+#include <vector>
+
+/// One flush of a WriteBehindSoloLadderStorage.
+struct SoloLadderFlush
+{
+    uint32_t rows       = 0;
+    uint32_t updates    = 0; //< Update() calls merged into the rows
+    uint32_t statements = 0; //< as reported by the backend
+    uint64_t us         = 0; //< time spent handing the batch to the backend
+};
+
+/// Write-behind in front of another ladder storage. Update() only merges the
+/// change into a pending entry per guid: rating deltas are summed and the
+/// counters added. The pending rows go to the backend in one UpdateBatch()
+/// once the oldest has waited maxDelayMs (checked by FlushIfDue) or
+/// maxPendingRows guids are pending, and always on Flush().
+///
+/// Reads see the pending changes, assuming the backend runs its writes and
+/// async loads in the order they were issued. Summed deltas are clamped once
+/// per flush rather than once per match, which only differs for a player who
+/// would have hit 0 or SOLO_RATING_MAX in between.
+class WriteBehindSoloLadderStorage : public SoloLadderStorage
+{
+public:
+    using FlushSink = std::function<void(SoloLadderFlush const& flush)>;
+
+    WriteBehindSoloLadderStorage(SoloLadderStorage& backend, uint32_t maxDelayMs, uint32_t maxPendingRows, FlushSink sink = nullptr)
+        : _backend(backend), _maxDelayMs(maxDelayMs), _maxPendingRows(maxPendingRows ? maxPendingRows : 1), _sink(std::move(sink)) { }
+
+    bool Available() override { return _backend.Available(); }
+
+    bool Load(uint32_t guid, SoloLadderRow& row) override
+    {
+        bool const found = _backend.Load(guid, row);
+        return ApplyPending(guid, row) || found;
+    }
+
+    void LoadAsync(uint32_t guid, LoadCallback callback) override
+    {
+        // The load sees what was flushed before it was issued, so the changes
+        // pending at this point are added to its result. Later ones are not,
+        // just as a load straight from the backend would not see them.
+        auto const itr = _pending.find(guid);
+        bool const pending = itr != _pending.end();
+        SoloLadderUpdate const unwritten = pending ? itr->second.update : SoloLadderUpdate();
+        _backend.LoadAsync(guid, [pending, unwritten, callback = std::move(callback)](bool found, SoloLadderRow const& loaded)
+        {
+            SoloLadderRow row = loaded;
+            if (pending)
+                SoloLadder::Apply(row, unwritten);
+            callback(found || pending, row);
+        });
+    }
+
+    void Create(uint32_t guid, uint32_t now) override { _backend.Create(guid, now); }
+
+    void Update(uint32_t guid, SoloLadderUpdate const& update, uint32_t now) override
+    {
+        if (_pending.empty())
+            _oldestMs = _nowMs;
+
+        Pending& pending = _pending[guid];
+        pending.update.delta   = int32_t(std::clamp<int64_t>(int64_t(pending.update.delta) + update.delta,
+            -int64_t(SOLO_RATING_MAX), SOLO_RATING_MAX));
+        pending.update.games  += update.games;
+        pending.update.wins   += update.wins;
+        pending.update.losses += update.losses;
+        ++pending.merged;
+        _lastUpdate = now;
+
+        if (_pending.size() >= _maxPendingRows)
+            Flush();
+    }
+
+    uint32_t UpdateBatch(std::vector<SoloLadderBatchRow> const& rows, uint32_t now) override
+    {
+        for (SoloLadderBatchRow const& row : rows)
+            Update(row.guid, row.update, now);
+        return 0;
+    }
+
+    void ProcessCallbacks() override { _backend.ProcessCallbacks(); }
+
+    /// Flushes when the oldest pending change has waited maxDelayMs at
+    /// @p nowMs (any monotonic millisecond clock).
+    void FlushIfDue(uint64_t nowMs)
+    {
+        _nowMs = nowMs;
+        if (!_pending.empty() && nowMs - _oldestMs >= _maxDelayMs)
+            Flush();
+    }
+
+    /// Writes every pending change now.
+    void Flush()
+    {
+        if (_pending.empty())
+            return;
+
+        SoloLadderFlush flush;
+        _batch.clear();
+        _batch.reserve(_pending.size());
+        for (auto const& [guid, pending] : _pending)
+        {
+            _batch.push_back({ guid, pending.update });
+            flush.updates += pending.merged;
+        }
+        _pending.clear();
+        flush.rows = uint32_t(_batch.size());
+
+        auto const start = std::chrono::steady_clock::now();
+        flush.statements = _backend.UpdateBatch(_batch, _lastUpdate);
+        flush.us = uint64_t(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+
+        if (_sink)
+            _sink(flush);
+    }
+
+    std::size_t PendingRows() const { return _pending.size(); }
+
+private:
+    struct Pending
+    {
+        SoloLadderUpdate update;
+        uint32_t         merged = 0;
+    };
+
+    bool ApplyPending(uint32_t guid, SoloLadderRow& row) const
+    {
+        auto const itr = _pending.find(guid);
+        if (itr == _pending.end())
+            return false;
+
+        SoloLadder::Apply(row, itr->second.update);
+        return true;
+    }
+
+    SoloLadderStorage&                    _backend;
+    uint32_t                              _maxDelayMs;
+    uint32_t                              _maxPendingRows;
+    FlushSink                             _sink;
+    std::unordered_map<uint32_t, Pending> _pending;
+    std::vector<SoloLadderBatchRow>       _batch;
+    uint64_t                              _nowMs      = 0;
+    uint64_t                              _oldestMs   = 0;
+    uint32_t                              _lastUpdate = 0;
+};
+
+#endif // _SOLO_LADDER_WRITE_BEHIND_H_
@@ -0,0 +1,492 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _SOLO_MATCHMAKER_H_
+#define _SOLO_MATCHMAKER_H_
+
+#include "MatchmakingAudit.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+/// Roles as counted by the solo queue; same values as Solo3v3TalentCat.
+enum SoloRole : uint8_t
+{
+    SOLO_ROLE_MELEE  = 0,
+    SOLO_ROLE_RANGE  = 1,
+    SOLO_ROLE_HEALER = 2
+};
+
+/// Queue buckets and teams, numbered like BattlegroundQueueGroupTypes and
+/// TeamId in the core.
+enum SoloQueueBucket : uint8_t
+{
+    SOLO_BUCKET_PREMADE_ALLIANCE = 0,
+    SOLO_BUCKET_PREMADE_HORDE    = 1,
+    SOLO_BUCKET_NORMAL_ALLIANCE  = 2,
+    SOLO_BUCKET_NORMAL_HORDE     = 3
+};
+
+enum SoloQueueTeam : uint8_t
+{
+    SOLO_TEAM_ALLIANCE = 0,
+    SOLO_TEAM_HORDE    = 1
+};
+
+/// Matchmaking options, read from Solo.3v3.* by the production caller.
+struct SoloMatchmakerConfig
+{
+    uint32_t minPlayers           = 3;     //< players per team (1 when arena testing)
+    bool     filterTalents        = false;
+    bool     avoidIgnore          = true;
+    uint8_t  preventClassStacking = 0;
+    uint32_t classStackMask       = 0;
+};
+
+/// One queued player as seen by the matchmaker.
+template <typename Binding>
+struct SoloCandidate
+{
+    typename Binding::GroupHandle  group{};
+    typename Binding::PlayerHandle player{};
+    uint64_t                       id          = 0;     //< raw guid
+    uint8_t                        role        = SOLO_ROLE_MELEE;
+    uint32_t                       mmr         = 0;
+    uint8_t                        classId     = 0;
+    bool                           allDpsReady = false;
+};
+
+/// Outcome of one matchmaking pass.
+template <typename Binding>
+struct SoloMatchResult
+{
+    MatchmakingAuditReason              reason      = AUDIT_REASON_OK; //< why no match was formed
+    uint32_t                            candidates  = 0;
+    bool                                allDpsMatch = false;
+    std::vector<SoloCandidate<Binding>> selected;
+    std::vector<uint32_t>               team1;      //< indices into selected; empty unless a match formed
+    uint32_t                            phases      = 0;   //< number of phaseUs entries filled
+    uint64_t                            phaseUs[3]  = { }; //< collect, select, split
+};
+
+/// The solo 3v3 matchmaking pass (CheckSolo3v3Arena) over an engine facade.
+///
+/// A binding adapts the queue to the matchmaker:
+///
+///   using GroupHandle  = ...;  // queued group (GroupQueueInfo*)
+///   using PlayerHandle = ...;  // player, only passed back to Ignores()
+///   using Bucket       = ...;  // JoinTime-ordered list of GroupHandle
+///   Bucket& Queued(uint32_t bracket, uint8_t bucket);
+///   bool Describe(GroupHandle, SoloCandidate<Binding>&); // false: not matchable now
+///   bool Ignores(PlayerHandle, PlayerHandle);            // either ignores the other
+///   uint32_t JoinTime(GroupHandle);
+///   uint8_t Team(GroupHandle);
+///   void SetTeam(GroupHandle, uint8_t team, uint8_t bucket);
+///   void ResetPools();
+///   void AddToPool(uint8_t team, GroupHandle, uint32_t minPlayers);
+///
+/// Solo3v3::QueueBinding binds it to BattlegroundQueue; InMemorySoloQueue is
+/// a fake for tests and load generation.
+template <typename Binding>
+class SoloMatchmaker
+{
+public:
+    using Group     = typename Binding::GroupHandle;
+    using Candidate = SoloCandidate<Binding>;
+    using Result    = SoloMatchResult<Binding>;
+
+    /// Buffers reused by every pass. Keeping one alive across passes (and
+    /// reusing the Result) makes a steady-state pass allocation-free apart
+    /// from the Bucket nodes of groups moved to the other faction.
+    struct Scratch
+    {
+        std::vector<Candidate> candidates, healers, dps, timedDps;
+        std::vector<uint32_t>  combo, team2, bestTeam1, team2Indices;
+    };
+
+    SoloMatchmaker(Binding& binding, SoloMatchmakerConfig const& config, Scratch* scratch = nullptr)
+        : _binding(binding), _config(config), _scratch(scratch ? *scratch : _ownScratch) { }
+
+    /// Selects a match from @p bracket and fills the two selection pools,
+    /// moving players between faction buckets as needed. Every team split
+    /// considered is appended to @p auditSplits when given.
+    bool Check(uint32_t bracket, bool isRated, Result& result, std::vector<MatchmakingAuditRecord>* auditSplits = nullptr)
+    {
+        _binding.ResetPools();
+
+        result.reason      = AUDIT_REASON_OK;
+        result.candidates  = 0;
+        result.allDpsMatch = false;
+        result.phases      = 0;
+        result.selected.clear();
+        result.team1.clear();
+
+        uint32_t const minPlayers        = _config.minPlayers;
+        uint8_t  const allianceGroupType = isRated ? SOLO_BUCKET_PREMADE_ALLIANCE : SOLO_BUCKET_NORMAL_ALLIANCE;
+        uint8_t  const hordeGroupType    = isRated ? SOLO_BUCKET_PREMADE_HORDE    : SOLO_BUCKET_NORMAL_HORDE;
+
+        auto phaseStart = std::chrono::steady_clock::now();
+        auto endPhase = [&result, &phaseStart]()
+        {
+            auto const now = std::chrono::steady_clock::now();
+            result.phaseUs[result.phases++] = uint64_t(std::chrono::duration_cast<std::chrono::microseconds>(now - phaseStart).count());
+            phaseStart = now;
+        };
+
+        // === Phase 1: collect all eligible candidates in queue order (FIFO) ===
+        std::vector<Candidate>& allCandidates = _scratch.candidates;
+        allCandidates.clear();
+        for (uint8_t groupType : { allianceGroupType, hordeGroupType })
+        {
+            for (Group g : _binding.Queued(bracket, groupType))
+            {
+                Candidate candidate;
+                candidate.group = g;
+                if (!_binding.Describe(g, candidate))
+                    continue;
+
+                if (!_config.filterTalents)
+                    candidate.role = SOLO_ROLE_MELEE;
+                allCandidates.push_back(candidate);
+            }
+        }
+
+        endPhase();
+        result.candidates = uint32_t(allCandidates.size());
+
+        if (allCandidates.size() < minPlayers * 2)
+        {
+            result.reason = AUDIT_REASON_TOO_FEW;
+            return false;
+        }
+
+        // === Phase 2: select candidates that form a valid match (composition-aware, FIFO) ===
+        std::vector<Candidate>& selected = result.selected;
+        selected.reserve(minPlayers * 2);
+        MatchmakingAuditReason reason = AUDIT_REASON_ROLE_SHORTAGE;
+
+        if (!_config.filterTalents)
+        {
+            // No role filtering: take the first MinPlayers*2 players
+            selected.assign(allCandidates.begin(), allCandidates.begin() + minPlayers * 2);
+        }
+        else
+        {
+            std::vector<Candidate>& healers = _scratch.healers;
+            std::vector<Candidate>& dps     = _scratch.dps;
+            healers.clear();
+            dps.clear();
+            for (Candidate const& c : allCandidates)
+            {
+                if (c.role == SOLO_ROLE_HEALER) healers.push_back(c);
+                else                            dps.push_back(c);
+            }
+
+            // For MinPlayers==1 (arena testing) no healer requirement; otherwise 1 healer per team.
+            uint32_t const healersNeeded = (minPlayers > 1) ? 2 : 0;
+            uint32_t const dpsNeeded     = minPlayers * 2 - healersNeeded;
+
+            if (healers.size() >= healersNeeded && dps.size() >= dpsNeeded)
+            {
+                // Standard: take oldest healers and oldest DPS (FIFO within each role bucket)
+                for (uint32_t i = 0; i < healersNeeded; ++i) selected.push_back(healers[i]);
+                for (uint32_t i = 0; i < dpsNeeded;     ++i) selected.push_back(dps[i]);
+            }
+            else if (healers.empty())
+            {
+                // All-DPS fallback: only include DPS players promoted by their AllDPS timer
+                std::vector<Candidate>& timedDps = _scratch.timedDps;
+                timedDps.clear();
+                for (Candidate const& c : dps)
+                    if (c.allDpsReady)
+                        timedDps.push_back(c);
+
+                if (timedDps.size() >= minPlayers * 2)
+                {
+                    for (uint32_t i = 0; i < minPlayers * 2; ++i)
+                        selected.push_back(timedDps[i]);
+                    result.allDpsMatch = true;
+                }
+                else
+                    reason = AUDIT_REASON_ALL_DPS_WAIT;
+            }
+            else if (healers.size() == 1)
+            {
+                // 1 healer present: unbalanced composition, cannot form a valid match — fall through.
+                reason = AUDIT_REASON_ONE_HEALER;
+            }
+        }
+
+        endPhase();
+
+        if (selected.size() < minPlayers * 2)
+        {
+            result.reason = reason;
+            return false;
+        }
+
+        // === Phase 3: exhaustive search for the MMR-balanced team split ===
+        // For 6 players / teamSize=3: C(6,3)=20 combinations, a few µs (tests/bench BM_FindBestTeamSplit).
+        // Primary:   minimise |sum_mmr_team1 - sum_mmr_team2|
+        // Secondary: minimise mutual-ignore pairs within teams (avoidIgnore tie-breaker)
+        uint32_t const n        = uint32_t(selected.size());
+        uint32_t const teamSize = minPlayers;
+
+        std::vector<uint32_t>& bestTeam1 = _scratch.bestTeam1;
+        bool     haveBest    = false;
+        uint64_t bestDiff    = 0;
+        int      bestIgnores = 0;
+
+        std::vector<uint32_t>& combo = _scratch.combo;
+        combo.resize(teamSize);
+        EnumerateCombinations(0, 0, combo, selected, teamSize, n, result.allDpsMatch, bestTeam1, haveBest, bestDiff, bestIgnores, auditSplits);
+
+        if (!haveBest)
+        {
+            endPhase();
+            result.reason = AUDIT_REASON_NO_SPLIT;
+            return false;
+        }
+
+        // Build team2 as complement of bestTeam1
+        std::vector<uint32_t>& team2Indices = _scratch.team2Indices;
+        team2Indices.clear();
+        {
+            uint32_t ci = 0;
+            for (uint32_t i = 0; i < n; ++i)
+            {
+                if (ci < uint32_t(bestTeam1.size()) && bestTeam1[ci] == i) { ++ci; continue; }
+                team2Indices.push_back(i);
+            }
+        }
+
+        // === Phase 4: assign to selection pools, reclassifying faction bucket if needed ===
+        AssignToPool(bestTeam1,    selected, SOLO_TEAM_ALLIANCE, bracket, allianceGroupType, hordeGroupType);
+        AssignToPool(team2Indices, selected, SOLO_TEAM_HORDE,    bracket, allianceGroupType, hordeGroupType);
+
+        endPhase();
+        result.reason = AUDIT_REASON_OK;
+        result.team1.assign(bestTeam1.begin(), bestTeam1.end());
+        return true;
+    }
+
+    /// Moves a queued group to @p team's bucket, keeping JoinTime order.
+    void MoveGroupToTeam(Group group, uint32_t bracket, uint8_t team, uint8_t allianceGroupType, uint8_t hordeGroupType)
+    {
+        if (_binding.Team(group) == team)
+            return;
+
+        uint8_t const srcGroupType    = (_binding.Team(group) == SOLO_TEAM_ALLIANCE) ? allianceGroupType : hordeGroupType;
+        uint8_t const targetGroupType = (team == SOLO_TEAM_ALLIANCE) ? allianceGroupType : hordeGroupType;
+
+        _binding.SetTeam(group, team, targetGroupType);
+
+        // Re-insert into destination bucket in JoinTime order to preserve FIFO fairness
+        auto& dstList = _binding.Queued(bracket, targetGroupType);
+        auto& srcList = _binding.Queued(bracket, srcGroupType);
+        uint32_t const joinTime = _binding.JoinTime(group);
+
+        auto insertPos = dstList.begin();
+        while (insertPos != dstList.end() && _binding.JoinTime(*insertPos) <= joinTime)
+            ++insertPos;
+
+        dstList.insert(insertPos, group);
+        srcList.erase(std::find(srcList.begin(), srcList.end(), group));
+    }
+
+    /// Returns true when the team at @p indices contains two players of the
+    /// same class that violate the configured stacking level and class mask.
+    static bool HasClassStackingConflict(std::vector<uint32_t> const& indices, std::vector<Candidate> const& selected,
+        uint8_t preventLevel, uint32_t classMask)
+    {
+        for (uint32_t i = 0; i < indices.size(); ++i)
+        {
+            for (uint32_t j = i + 1; j < indices.size(); ++j)
+            {
+                Candidate const& a = selected[indices[i]];
+                Candidate const& b = selected[indices[j]];
+
+                if (a.classId != b.classId)
+                    continue;
+
+                // Apply optional class filter; 0 means all classes are checked
+                if (classMask != 0 && !(classMask & ClassIdToMaskBit(a.classId)))
+                    continue;
+
+                bool aIsMelee  = (a.role == SOLO_ROLE_MELEE);
+                bool aIsRange  = (a.role == SOLO_ROLE_RANGE);
+                bool aIsHealer = (a.role == SOLO_ROLE_HEALER);
+                bool bIsMelee  = (b.role == SOLO_ROLE_MELEE);
+                bool bIsRange  = (b.role == SOLO_ROLE_RANGE);
+                bool bIsHealer = (b.role == SOLO_ROLE_HEALER);
+
+                switch (preventLevel)
+                {
+                    case 1: return true;                                                                               // all roles
+                    case 2: if (aIsMelee  && bIsMelee)                              return true; break;               // melee only
+                    case 3: if (aIsRange  && bIsRange)                              return true; break;               // ranged only
+                    case 4: if ((aIsMelee || aIsRange)  && (bIsMelee || bIsRange))  return true; break;               // any DPS
+                    case 5: if ((aIsMelee || aIsHealer) && (bIsMelee || bIsHealer)) return true; break;               // melee + healer
+                    case 6: if ((aIsRange  || aIsHealer) && (bIsRange  || bIsHealer)) return true; break;             // ranged + healer
+                    default: break;
+                }
+            }
+        }
+        return false;
+    }
+
+    /// Converts a WoW class ID (1–11) to its bit position for the
+    /// Solo.3v3.PreventClassStacking.Classes bitmask.
+    /// Mirrors 1<<(classId-1) for classes 1-9; Druid (11) maps to bit 10.
+    static uint32_t ClassIdToMaskBit(uint8_t classId)
+    {
+        if (classId >= 1 && classId <= 9)
+            return 1u << (classId - 1);
+        if (classId == 11) // CLASS_DRUID — skip the unused slot 10
+            return 1u << 10;
+        return 0;
+    }
+
+private:
+    int CountIgnorePairs(std::vector<uint32_t> const& indices, std::vector<Candidate> const& selected)
+    {
+        if (!_config.avoidIgnore)
+            return 0;
+
+        int pairs = 0;
+        for (uint32_t i = 0; i < indices.size(); ++i)
+            for (uint32_t j = i + 1; j < indices.size(); ++j)
+                if (_binding.Ignores(selected[indices[i]].player, selected[indices[j]].player))
+                    ++pairs;
+        return pairs;
+    }
+
+    void EnumerateCombinations(
+        uint32_t start,
+        uint32_t depth,
+        std::vector<uint32_t>& combo,
+        std::vector<Candidate> const& selected,
+        uint32_t teamSize,
+        uint32_t n,
+        bool allDpsMatch,
+        std::vector<uint32_t>& bestTeam1,
+        bool& haveBest,
+        uint64_t& bestDiff,
+        int& bestIgnores,
+        std::vector<MatchmakingAuditRecord>* auditSplits)
+    {
+        if (depth == teamSize)
+        {
+            // Scored and rejected splits are recorded for the audit journal, keyed by team1's index mask.
+            auto auditSplit = [&](MatchmakingAuditReason reason, uint64_t diff, int ign)
+            {
+                if (!auditSplits)
+                    return;
+
+                MatchmakingAuditRecord record;
+                record.type   = AUDIT_SPLIT;
+                record.reason = reason;
+                record.value  = diff;
+                record.mmr    = uint32_t(ign);
+                for (uint32_t i : combo)
+                    record.mask |= uint16_t(1u << i);
+                auditSplits->push_back(record);
+            };
+
+            // Build team2 as the complement of combo within [0, n)
+            std::vector<uint32_t>& team2 = _scratch.team2;
+            team2.clear();
+            uint32_t ci = 0;
+            for (uint32_t i = 0; i < n; ++i)
+            {
+                if (ci < teamSize && combo[ci] == i) { ++ci; continue; }
+                team2.push_back(i);
+            }
+
+            // Composition validation (filterTalents only)
+            if (_config.filterTalents)
+            {
+                uint32_t h1 = 0, h2 = 0;
+                for (uint32_t i : combo) if (selected[i].role == SOLO_ROLE_HEALER) ++h1;
+                for (uint32_t i : team2) if (selected[i].role == SOLO_ROLE_HEALER) ++h2;
+
+                if ((allDpsMatch && (h1 != 0 || h2 != 0)) || (!allDpsMatch && (h1 != 1 || h2 != 1)))
+                {
+                    auditSplit(AUDIT_REASON_SPLIT_COMPOSITION, 0, 0);
+                    return;
+                }
+            }
+
+            // Class stacking constraint: reject splits that place same-class players
+            // on the same team when the configured level applies to their roles.
+            if (_config.preventClassStacking > 0)
+            {
+                if (HasClassStackingConflict(combo, selected, _config.preventClassStacking, _config.classStackMask) ||
+                    HasClassStackingConflict(team2, selected, _config.preventClassStacking, _config.classStackMask))
+                {
+                    auditSplit(AUDIT_REASON_SPLIT_CLASS_STACK, 0, 0);
+                    return;
+                }
+            }
+
+            // MMR balance score
+            int64_t sum1 = 0, sum2 = 0;
+            for (uint32_t i : combo) sum1 += selected[i].mmr;
+            for (uint32_t i : team2) sum2 += selected[i].mmr;
+            uint64_t diff = static_cast<uint64_t>(sum1 > sum2 ? sum1 - sum2 : sum2 - sum1);
+
+            // Ignore-pair count as tie-breaker
+            int ign = CountIgnorePairs(combo, selected) + CountIgnorePairs(team2, selected);
+            auditSplit(AUDIT_REASON_OK, diff, ign);
+
+            if (!haveBest || diff < bestDiff || (diff == bestDiff && ign < bestIgnores))
+            {
+                haveBest    = true;
+                bestDiff    = diff;
+                bestIgnores = ign;
+                bestTeam1.assign(combo.begin(), combo.end());
+            }
+            return;
+        }
+
+        for (uint32_t i = start; i <= n - (teamSize - depth); ++i)
+        {
+            combo[depth] = i;
+            EnumerateCombinations(i + 1, depth + 1, combo, selected, teamSize, n, allDpsMatch, bestTeam1, haveBest, bestDiff, bestIgnores, auditSplits);
+        }
+    }
+
+    void AssignToPool(std::vector<uint32_t> const& indices, std::vector<Candidate> const& selected, uint8_t poolTeam,
+        uint32_t bracket, uint8_t allianceGroupType, uint8_t hordeGroupType)
+    {
+        for (uint32_t idx : indices)
+        {
+            Candidate const& c = selected[idx];
+            MoveGroupToTeam(c.group, bracket, poolTeam, allianceGroupType, hordeGroupType);
+            _binding.AddToPool(poolTeam, c.group, _config.minPlayers);
+        }
+    }
+
+    Binding&             _binding;
+    SoloMatchmakerConfig _config;
+    Scratch              _ownScratch;
+    Scratch&             _scratch;
+};
+
+#endif // _SOLO_MATCHMAKER_H_
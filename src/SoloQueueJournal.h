@@ -0,0 +1,339 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _SOLO_QUEUE_JOURNAL_H_
+#define _SOLO_QUEUE_JOURNAL_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/// One solo queue join as persisted in the journal. Join time is wall clock
+/// (ms since epoch) so it survives a restart of the game clock.
+struct SoloJournalEntry
+{
+    uint64_t guid       = 0;
+    uint64_t joinWallMs = 0;
+    uint32_t rating     = 0;
+    uint32_t mmr        = 0;
+    uint8_t  role       = 0;
+    uint8_t  classId    = 0;
+    uint8_t  bracketId  = 0;
+    bool     rated      = false;
+
+    bool operator==(SoloJournalEntry const& other) const
+    {
+        return guid == other.guid && joinWallMs == other.joinWallMs && rating == other.rating && mmr == other.mmr &&
+            role == other.role && classId == other.classId && bracketId == other.bracketId && rated == other.rated;
+    }
+};
+
+/// Append-only binary journal of solo queue joins and leaves.
+///
+/// File layout: an 8 byte header ("SQJ" + version + 4 reserved bytes)
+/// followed by fixed-size little-endian records:
+///
+///   type:1 guid:8 joinWallMs:8 rating:4 mmr:4 role:1 class:1 bracket:1 flags:1 checksum:4
+///
+/// A leave record only carries the guid. Replay stops at the first record
+/// whose checksum does not match, so a write torn by a crash only loses the
+/// tail. Compact() rewrites the file with one join record per live entry
+/// (through a temporary file and rename) once leaves and superseded joins
+/// dominate it.
+class SoloQueueJournal
+{
+public:
+    static constexpr uint8_t  VERSION      = 1;
+    static constexpr size_t   HEADER_SIZE  = 8;
+    static constexpr size_t   RECORD_SIZE  = 33;
+
+    enum RecordType : uint8_t
+    {
+        RECORD_JOIN  = 1,
+        RECORD_LEAVE = 2
+    };
+
+    using EntryMap = std::unordered_map<uint64_t, SoloJournalEntry>;
+
+    SoloQueueJournal() = default;
+    ~SoloQueueJournal() { Close(); }
+
+    SoloQueueJournal(SoloQueueJournal const&) = delete;
+    SoloQueueJournal& operator=(SoloQueueJournal const&) = delete;
+
+    /// Opens (or creates) @p path and replays it. Returns false if the file
+    /// cannot be opened for writing; a corrupt tail is dropped, not an error.
+    bool Open(std::string const& path)
+    {
+        Close();
+        _path = path;
+        _live.clear();
+        _records = 0;
+
+        std::vector<uint8_t> data;
+        if (std::FILE* in = std::fopen(path.c_str(), "rb"))
+        {
+            std::fseek(in, 0, SEEK_END);
+            long const size = std::ftell(in);
+            std::fseek(in, 0, SEEK_SET);
+            if (size > 0)
+            {
+                data.resize(size_t(size));
+                data.resize(std::fread(data.data(), 1, data.size(), in));
+            }
+            std::fclose(in);
+        }
+
+        size_t const valid = Replay(data.data(), data.size(), _live, &_records);
+        if (valid != data.size() || data.empty())
+        {
+            // Missing, foreign or torn file: rewrite it from what replayed.
+            return Compact();
+        }
+
+        _file = std::fopen(path.c_str(), "ab");
+        return _file != nullptr;
+    }
+
+    void Close()
+    {
+        if (_file)
+        {
+            std::fclose(_file);
+            _file = nullptr;
+        }
+    }
+
+    bool IsOpen() const { return _file != nullptr; }
+
+    void AppendJoin(SoloJournalEntry const& entry)
+    {
+        _live[entry.guid] = entry;
+        Append(RECORD_JOIN, entry);
+    }
+
+    void AppendLeave(uint64_t guid)
+    {
+        if (!_live.erase(guid))
+            return;
+
+        SoloJournalEntry entry;
+        entry.guid = guid;
+        Append(RECORD_LEAVE, entry);
+    }
+
+    /// Hands buffered records to the OS; call once per update, not per record.
+    void Flush()
+    {
+        if (_file && _dirty)
+            std::fflush(_file);
+
+        _dirty = false;
+    }
+
+    /// True once the file holds more than @p ratio records per live entry
+    /// (and at least @p minRecords records).
+    bool ShouldCompact(uint32_t ratio = 4, uint64_t minRecords = 1024) const
+    {
+        return _records >= minRecords && _records > uint64_t(_live.size()) * ratio;
+    }
+
+    /// Rewrites the journal with one join record per live entry.
+    bool Compact()
+    {
+        Close();
+
+        std::string const tmpPath = _path + ".tmp";
+        std::FILE* out = std::fopen(tmpPath.c_str(), "wb");
+        if (!out)
+            return false;
+
+        std::vector<uint8_t> buffer;
+        buffer.reserve(HEADER_SIZE + _live.size() * RECORD_SIZE);
+        EncodeHeader(buffer);
+        for (auto const& [guid, entry] : _live)
+            EncodeRecord(RECORD_JOIN, entry, buffer);
+
+        bool const written = std::fwrite(buffer.data(), 1, buffer.size(), out) == buffer.size();
+        std::fclose(out);
+
+        if (!written || std::rename(tmpPath.c_str(), _path.c_str()) != 0)
+        {
+            std::remove(tmpPath.c_str());
+            return false;
+        }
+
+        _records = _live.size();
+        _file = std::fopen(_path.c_str(), "ab");
+        return _file != nullptr;
+    }
+
+    EntryMap const& Live() const { return _live; }
+    uint64_t RecordCount() const { return _records; }
+
+    /// Sorts @p entries oldest join first and returns their join times on a
+    /// game clock that reads @p gameMs at wall clock @p nowWallMs, in the
+    /// same order. Queue time spent before the restart still counts, so a
+    /// join t ms ago maps to gameMs - t. Joins older than the game clock
+    /// cannot go below 0; the times are kept strictly increasing instead so
+    /// those players keep their FIFO order.
+    static std::vector<uint32_t> GameJoinTimes(std::vector<SoloJournalEntry>& entries, uint64_t nowWallMs, uint32_t gameMs)
+    {
+        std::sort(entries.begin(), entries.end(), [](SoloJournalEntry const& a, SoloJournalEntry const& b)
+        {
+            return a.joinWallMs != b.joinWallMs ? a.joinWallMs < b.joinWallMs : a.guid < b.guid;
+        });
+
+        std::vector<uint32_t> times;
+        times.reserve(entries.size());
+        for (SoloJournalEntry const& entry : entries)
+        {
+            uint64_t const waited = nowWallMs > entry.joinWallMs ? nowWallMs - entry.joinWallMs : 0;
+            uint32_t time = waited < gameMs ? uint32_t(gameMs - waited) : 0;
+            if (!times.empty() && time <= times.back())
+                time = times.back() + 1;
+            times.push_back(time);
+        }
+        return times;
+    }
+
+    // ---- Encoding (exposed for tests) ----
+
+    static void EncodeHeader(std::vector<uint8_t>& out)
+    {
+        out.push_back('S');
+        out.push_back('Q');
+        out.push_back('J');
+        out.push_back(VERSION);
+        out.insert(out.end(), 4, 0);
+    }
+
+    static void EncodeRecord(uint8_t type, SoloJournalEntry const& entry, std::vector<uint8_t>& out)
+    {
+        size_t const start = out.size();
+        out.push_back(type);
+        Put(out, entry.guid, 8);
+        Put(out, entry.joinWallMs, 8);
+        Put(out, entry.rating, 4);
+        Put(out, entry.mmr, 4);
+        out.push_back(entry.role);
+        out.push_back(entry.classId);
+        out.push_back(entry.bracketId);
+        out.push_back(entry.rated ? 1 : 0);
+        Put(out, Checksum(out.data() + start, RECORD_SIZE - 4), 4);
+    }
+
+    /// Decodes one record; returns false on a checksum or type mismatch.
+    static bool DecodeRecord(uint8_t const* data, uint8_t& type, SoloJournalEntry& entry)
+    {
+        if (Get(data + RECORD_SIZE - 4, 4) != Checksum(data, RECORD_SIZE - 4))
+            return false;
+
+        type             = data[0];
+        entry.guid       = Get(data + 1, 8);
+        entry.joinWallMs = Get(data + 9, 8);
+        entry.rating     = uint32_t(Get(data + 17, 4));
+        entry.mmr        = uint32_t(Get(data + 21, 4));
+        entry.role       = data[25];
+        entry.classId    = data[26];
+        entry.bracketId  = data[27];
+        entry.rated      = (data[28] & 1) != 0;
+        return type == RECORD_JOIN || type == RECORD_LEAVE;
+    }
+
+    /// Applies the records in @p data to @p live. Returns the number of bytes
+    /// that were valid; anything after that is a torn or foreign tail.
+    static size_t Replay(uint8_t const* data, size_t size, EntryMap& live, uint64_t* records = nullptr)
+    {
+        if (size < HEADER_SIZE || data[0] != 'S' || data[1] != 'Q' || data[2] != 'J' || data[3] != VERSION)
+            return 0;
+
+        size_t offset = HEADER_SIZE;
+        uint64_t count = 0;
+        while (offset + RECORD_SIZE <= size)
+        {
+            uint8_t type = 0;
+            SoloJournalEntry entry;
+            if (!DecodeRecord(data + offset, type, entry))
+                break;
+
+            if (type == RECORD_JOIN)
+                live[entry.guid] = entry;
+            else
+                live.erase(entry.guid);
+
+            offset += RECORD_SIZE;
+            ++count;
+        }
+
+        if (records)
+            *records = count;
+
+        return offset;
+    }
+
+private:
+    void Append(uint8_t type, SoloJournalEntry const& entry)
+    {
+        if (!_file)
+            return;
+
+        _scratch.clear();
+        EncodeRecord(type, entry, _scratch);
+        std::fwrite(_scratch.data(), 1, _scratch.size(), _file);
+        ++_records;
+        _dirty = true;
+    }
+
+    static void Put(std::vector<uint8_t>& out, uint64_t value, uint32_t bytes)
+    {
+        for (uint32_t i = 0; i < bytes; ++i)
+            out.push_back(uint8_t(value >> (8 * i)));
+    }
+
+    static uint64_t Get(uint8_t const* data, uint32_t bytes)
+    {
+        uint64_t value = 0;
+        for (uint32_t i = 0; i < bytes; ++i)
+            value |= uint64_t(data[i]) << (8 * i);
+        return value;
+    }
+
+    // FNV-1a; only needs to catch torn writes, not adversarial edits.
+    static uint32_t Checksum(uint8_t const* data, size_t size)
+    {
+        uint32_t hash = 2166136261u;
+        for (size_t i = 0; i < size; ++i)
+        {
+            hash ^= data[i];
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+    std::string          _path;
+    std::FILE*           _file    = nullptr;
+    bool                 _dirty   = false;
+    uint64_t             _records = 0;
+    EntryMap             _live;
+    std::vector<uint8_t> _scratch;
+};
+
+#endif // _SOLO_QUEUE_JOURNAL_H_
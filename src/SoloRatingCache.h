@@ -0,0 +1,112 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _SOLO_RATING_CACHE_H_
+#define _SOLO_RATING_CACHE_H_
+
+#include "SoloLadderStorage.h"
+
+#include <unordered_map>
+#include <vector>
+
+/// Ladder rows of the players online, keyed by character guid (low part).
+/// A row is requested at login (BeginLoad), becomes readable once the load
+/// returns (Fill) and is dropped at logout (Evict). Match results are applied
+/// in place; one that lands while the row is still loading is kept and
+/// applied on Fill, since the load was issued before the update and cannot
+/// have seen it.
+class SoloRatingCache
+{
+public:
+    /// Starts (or restarts) loading @p guid. Returns the token Fill() must
+    /// present, so a load that was overtaken by a logout or relog is ignored.
+    uint32_t BeginLoad(uint32_t guid)
+    {
+        Entry& entry = _entries[guid];
+        entry = Entry();
+        entry.token = ++_lastToken;
+        return entry.token;
+    }
+
+    /// Stores the loaded @p row. False when the load is stale.
+    bool Fill(uint32_t guid, uint32_t token, SoloLadderRow const& row)
+    {
+        auto const itr = _entries.find(guid);
+        if (itr == _entries.end() || itr->second.token != token || itr->second.ready)
+            return false;
+
+        Entry& entry = itr->second;
+        entry.row   = row;
+        entry.ready = true;
+        for (SoloLadderUpdate const& update : entry.pending)
+            SoloLadder::Apply(entry.row, update);
+        entry.pending.clear();
+        entry.pending.shrink_to_fit();
+        return true;
+    }
+
+    /// The row of @p guid, or nullptr when it is not loaded (yet).
+    SoloLadderRow const* Find(uint32_t guid)
+    {
+        auto const itr = _entries.find(guid);
+        if (itr == _entries.end() || !itr->second.ready)
+        {
+            ++_misses;
+            return nullptr;
+        }
+
+        ++_hits;
+        return &itr->second.row;
+    }
+
+    /// Applies @p update to a loaded or loading row; no-op for players that
+    /// are not cached.
+    void Apply(uint32_t guid, SoloLadderUpdate const& update)
+    {
+        auto const itr = _entries.find(guid);
+        if (itr == _entries.end())
+            return;
+
+        if (itr->second.ready)
+            SoloLadder::Apply(itr->second.row, update);
+        else
+            itr->second.pending.push_back(update);
+    }
+
+    void Evict(uint32_t guid) { _entries.erase(guid); }
+    void Clear() { _entries.clear(); }
+
+    std::size_t Size() const { return _entries.size(); }
+    uint64_t    Hits() const { return _hits; }
+    uint64_t    Misses() const { return _misses; }
+
+private:
+    struct Entry
+    {
+        SoloLadderRow                 row;
+        uint32_t                      token = 0;
+        bool                          ready = false;
+        std::vector<SoloLadderUpdate> pending; //< applied while loading
+    };
+
+    std::unordered_map<uint32_t, Entry> _entries;
+    uint32_t                            _lastToken = 0;
+    uint64_t                            _hits      = 0;
+    uint64_t                            _misses    = 0;
+};
+
+#endif // _SOLO_RATING_CACHE_H_
@@ -0,0 +1,206 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _SYNTHETIC_SOLO_LOAD_H_
+#define _SYNTHETIC_SOLO_LOAD_H_
+
+#include "InMemorySoloQueue.h"
+#include "LatencyHistogram.h"
+#include "QueueSimulator.h"
+
+#include <chrono>
+#include <deque>
+
+/// Shape of a synthetic queue load.
+struct SoloLoadSettings
+{
+    uint32_t            initialEntries    = 0;      //< queued at once when the load starts
+    double              arrivalsPerMinute = 60.0;
+    double              healerShare       = 0.2;
+    double              mmrMean           = 1500.0;
+    double              mmrStdDev         = 200.0;
+    std::vector<double> classWeights;               //< by classId - 1; empty = uniform
+    uint32_t            bracket           = 0;
+    bool                rated             = false;
+    uint32_t            allDpsTimerMs     = 60000;  //< Solo.3v3.FilterTalents.AllDPSTimer; 0 = at join
+    uint32_t            maxQueued         = 50000;  //< arrivals beyond this are dropped
+    uint32_t            passesPerTick     = 1;      //< matchmaking passes per Tick()
+    uint64_t            seed              = 1;
+};
+
+/// Counters and timings of a synthetic load run. Indexed by SoloRole.
+struct SoloLoadStats
+{
+    uint64_t               elapsedMs       = 0;
+    uint64_t               ticks           = 0;
+    uint64_t               injected[3]     = { };
+    uint64_t               dropped         = 0;    //< arrivals refused at maxQueued
+    uint64_t               matches         = 0;
+    uint64_t               allDpsMatches   = 0;
+    uint32_t               queued          = 0;
+    MatchmakingAuditReason lastReason      = AUDIT_REASON_OK;
+    LatencyHistogram       tickUs;                 //< whole Tick(): arrivals, promotion and passes
+    LatencyHistogram       passUs;                 //< one matchmaking pass
+    LatencyHistogram       candidates;
+    LatencyHistogram       waitSec;
+};
+
+/// Synthetic solo queue load: Poisson arrivals with a role mix, MMR and
+/// class distribution are queued in an InMemorySoloQueue and matched by the
+/// same SoloMatchmaker pass CheckSolo3v3Arena runs, so the matchmaking cost
+/// can be measured on a real server without real clients. Formed matches
+/// are removed from the queue as if they had been invited.
+class SyntheticSoloLoad
+{
+public:
+    SyntheticSoloLoad(SoloLoadSettings const& settings, SoloMatchmakerConfig const& config)
+        : _settings(settings), _matchmaker(_queue, config),
+        _arrivals(settings.arrivalsPerMinute, settings.healerShare, settings.mmrMean, settings.mmrStdDev, settings.classWeights, settings.seed),
+        _rng(settings.seed ^ 0x5bd1e995)
+    {
+        SimArrivalGenerator backlog(1.0, settings.healerShare, settings.mmrMean, settings.mmrStdDev, settings.classWeights, settings.seed + 1);
+        for (uint32_t i = 0; i < settings.initialEntries; ++i)
+        {
+            SimArrival arrival = backlog.Next();
+            arrival.timeMs = 0;
+            Inject(arrival);
+        }
+
+        _next = settings.arrivalsPerMinute > 0.0 ? _arrivals.Next() : SimArrival{ std::numeric_limits<uint64_t>::max() };
+    }
+
+    /// Advances the load to @p elapsedMs since it started: queues the
+    /// arrivals due by then and runs up to passesPerTick matchmaking passes.
+    void Tick(uint64_t elapsedMs)
+    {
+        auto const tickStart = std::chrono::steady_clock::now();
+
+        for (; _next.timeMs <= elapsedMs; _next = _arrivals.Next())
+            Inject(_next);
+
+        PromoteAllDps(elapsedMs);
+
+        for (uint32_t pass = 0; pass < _settings.passesPerTick; ++pass)
+        {
+            auto const passStart = std::chrono::steady_clock::now();
+            SoloMatchResult<InMemorySoloQueue>& result = _result;
+            bool const matched = _matchmaker.Check(_settings.bracket, _settings.rated, result);
+            _stats.passUs.Record(MicrosecondsSince(passStart));
+            _stats.candidates.Record(result.candidates);
+            _stats.lastReason = result.reason;
+            if (!matched)
+                break;
+
+            ++_stats.matches;
+            _stats.allDpsMatches += result.allDpsMatch;
+            for (uint8_t team : { SOLO_TEAM_ALLIANCE, SOLO_TEAM_HORDE })
+                for (InMemoryQueuedPlayer const* player : _queue.Pool(team))
+                    _stats.waitSec.Record((elapsedMs - player->joinTime) / 1000);
+            _queue.RemovePooled();
+        }
+
+        ++_stats.ticks;
+        _stats.elapsedMs = elapsedMs;
+        _stats.queued    = _queue.QueuedCount();
+        _stats.tickUs.Record(MicrosecondsSince(tickStart));
+    }
+
+    SoloLoadStats const& Stats() const { return _stats; }
+    SoloLoadSettings const& Settings() const { return _settings; }
+
+private:
+    static uint64_t MicrosecondsSince(std::chrono::steady_clock::time_point start)
+    {
+        return uint64_t(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    void Inject(SimArrival const& arrival)
+    {
+        if (_queue.QueuedCount() >= _settings.maxQueued)
+        {
+            ++_stats.dropped;
+            return;
+        }
+
+        InMemoryQueuedPlayer player;
+        player.id       = ++_lastId;
+        player.bracket  = _settings.bracket;
+        player.rated    = _settings.rated;
+        player.team     = uint8_t(_lastId & 1);
+        player.role     = arrival.role == PlayerRole::HEALER ? SOLO_ROLE_HEALER : DpsRole(arrival.classId);
+        player.mmr      = arrival.mmr;
+        player.classId  = arrival.classId;
+        player.joinTime = uint32_t(arrival.timeMs);
+
+        // Like the server, a zero AllDPS timer promotes DPS as they join.
+        player.allDpsReady = player.role != SOLO_ROLE_HEALER && !_settings.allDpsTimerMs;
+
+        InMemoryQueuedPlayer& queued = _queue.Add(player);
+        ++_stats.injected[player.role];
+        if (player.role != SOLO_ROLE_HEALER && _settings.allDpsTimerMs)
+            _allDpsTimers.push_back({ player.id, &queued });
+    }
+
+    // Hunters, mages and warlocks are ranged; priests, shamans and druids
+    // are split between ranged and melee specs.
+    SoloRole DpsRole(uint8_t classId)
+    {
+        switch (classId)
+        {
+            case 3: case 8: case 9: return SOLO_ROLE_RANGE;
+            case 5: case 7: case 11: return _coin(_rng) ? SOLO_ROLE_RANGE : SOLO_ROLE_MELEE;
+            default: return SOLO_ROLE_MELEE;
+        }
+    }
+
+    // DPS are queued in JoinTime order, so the timers expire front first.
+    // A handle whose id changed was matched and reused by a later arrival.
+    void PromoteAllDps(uint64_t elapsedMs)
+    {
+        while (!_allDpsTimers.empty())
+        {
+            AllDpsTimer const& timer = _allDpsTimers.front();
+            if (timer.player->id == timer.id)
+            {
+                if (uint64_t(timer.player->joinTime) + _settings.allDpsTimerMs > elapsedMs)
+                    break;
+                timer.player->allDpsReady = true;
+            }
+            _allDpsTimers.pop_front();
+        }
+    }
+
+    struct AllDpsTimer
+    {
+        uint64_t              id;
+        InMemoryQueuedPlayer* player;
+    };
+
+    SoloLoadSettings                   _settings;
+    InMemorySoloQueue                  _queue;
+    SoloMatchmaker<InMemorySoloQueue>  _matchmaker;
+    SoloMatchResult<InMemorySoloQueue> _result;
+    SimArrivalGenerator                _arrivals;
+    SimArrival                         _next;
+    std::mt19937_64                    _rng;
+    std::bernoulli_distribution        _coin;
+    std::deque<AllDpsTimer>            _allDpsTimers;
+    uint64_t                           _lastId = 0;
+    SoloLoadStats                      _stats;
+};
+
+#endif // _SYNTHETIC_SOLO_LOAD_H_
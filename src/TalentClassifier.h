@@ -0,0 +1,79 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _TALENT_CLASSIFIER_H_
+#define _TALENT_CLASSIFIER_H_
+
+#include <cstdint>
+#include <vector>
+
+/// Maps talent tabs (TalentTab.dbc ids) to the solo queue role their points
+/// count towards, and picks a player's role from the points spent per role.
+/// Roles are indexed like Solo3v3TalentCat: 0 melee, 1 range, 2 healer.
+///
+/// The tab lists are turned into a flat table once, so looking up a learned
+/// talent's role is a single index instead of three list scans.
+class SoloTalentClassifier
+{
+public:
+    static constexpr uint32_t ROLES = 3;
+    static constexpr int8_t   NONE  = -1;
+
+    /// Each list is terminated by a 0 entry (see SOLO_3V3_TALENTS_*). A tab
+    /// listed twice counts for the first list it appears in.
+    SoloTalentClassifier(uint32_t const* melee, uint32_t const* range, uint32_t const* heal)
+    {
+        uint32_t const* lists[ROLES] = { melee, range, heal };
+        for (uint32_t role = 0; role < ROLES; ++role)
+        {
+            for (uint32_t const* tab = lists[role]; *tab; ++tab)
+            {
+                if (*tab >= _roleByTab.size())
+                    _roleByTab.resize(*tab + 1, NONE);
+                if (_roleByTab[*tab] == NONE)
+                    _roleByTab[*tab] = int8_t(role);
+            }
+        }
+    }
+
+    /// Role that points in @p tab count towards, or NONE.
+    int8_t RoleOf(uint32_t tab) const
+    {
+        return tab < _roleByTab.size() ? _roleByTab[tab] : NONE;
+    }
+
+    /// Role with the most points; ties keep the earlier role and no points
+    /// at all means melee.
+    static uint32_t Pick(uint32_t const (&points)[ROLES])
+    {
+        uint32_t role = 0, best = 0;
+        for (uint32_t i = 0; i < ROLES; ++i)
+        {
+            if (points[i] > best)
+            {
+                role = i;
+                best = points[i];
+            }
+        }
+        return role;
+    }
+
+private:
+    std::vector<int8_t> _roleByTab;
+};
+
+#endif // _TALENT_CLASSIFIER_H_
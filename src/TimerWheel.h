@@ -0,0 +1,164 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _TIMER_WHEEL_H_
+#define _TIMER_WHEEL_H_
+
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/// Hierarchical timer wheel for deadline-driven state machines.
+///
+/// Time is quantised into ticks of @p resolutionMs. Level 0 holds timers due
+/// within the current block of SLOTS ticks; each higher level covers SLOTS
+/// times the range of the one below and is cascaded down when the wheel
+/// reaches it. Scheduling and cancelling are O(1), and Advance() only touches
+/// the slots that were actually passed, so an idle wheel costs nothing.
+///
+/// Timers never fire early: a deadline is rounded up to the next tick.
+/// Deadlines past the top level's range are parked and re-cascaded until due.
+template <typename T, uint32_t SLOT_BITS = 6, uint32_t LEVELS = 4>
+class TimerWheel
+{
+public:
+    using TimerId = uint64_t;
+
+    static constexpr uint32_t SLOTS = 1u << SLOT_BITS;
+    static constexpr uint64_t SLOT_MASK = SLOTS - 1;
+
+    explicit TimerWheel(uint64_t nowMs = 0, uint32_t resolutionMs = 100)
+        : _resolution(resolutionMs ? resolutionMs : 1), _tick(nowMs / _resolution) { }
+
+    /// Schedules @p payload to fire at @p whenMs. Deadlines that are already
+    /// due fire on the next Advance().
+    TimerId Schedule(uint64_t whenMs, T payload)
+    {
+        uint64_t tick = (whenMs + _resolution - 1) / _resolution;
+        if (tick <= _tick)
+            tick = _tick + 1;
+
+        TimerId const id = ++_lastId;
+        _timers.emplace(id, Timer{ tick, std::move(payload) });
+        Place(id, tick);
+        return id;
+    }
+
+    /// Returns false if the timer already fired or was cancelled.
+    bool Cancel(TimerId id)
+    {
+        // The slot keeps the stale id until it is reached; it is skipped then.
+        return _timers.erase(id) != 0;
+    }
+
+    /// Moves the wheel to @p nowMs, calling @p onFire(id, payload) for every
+    /// timer that became due, in deadline order. @p onFire may schedule or
+    /// cancel timers.
+    template <typename F>
+    void Advance(uint64_t nowMs, F&& onFire)
+    {
+        uint64_t const target = nowMs / _resolution;
+
+        while (_tick < target)
+        {
+            if (_timers.empty())
+            {
+                _tick = target;
+                return;
+            }
+
+            ++_tick;
+
+            // Higher levels first, so timers they hand down to a lower level
+            // reaching its wrap point in the same tick are cascaded again.
+            for (uint32_t level = LEVELS - 1; level > 0; --level)
+                if ((_tick & ((uint64_t(1) << (SLOT_BITS * level)) - 1)) == 0)
+                    Cascade(level, (_tick >> (SLOT_BITS * level)) & SLOT_MASK);
+
+            std::vector<TimerId> due;
+            due.swap(_slots[0][_tick & SLOT_MASK]);
+
+            for (TimerId id : due)
+            {
+                auto itr = _timers.find(id);
+                if (itr == _timers.end())
+                    continue;
+
+                if (itr->second.tick != _tick)
+                {
+                    Place(id, itr->second.tick);
+                    continue;
+                }
+
+                T payload = std::move(itr->second.payload);
+                _timers.erase(itr);
+                onFire(id, payload);
+            }
+        }
+    }
+
+    std::size_t Size() const { return _timers.size(); }
+    bool Empty() const { return _timers.empty(); }
+    uint64_t NowTick() const { return _tick; }
+    uint32_t Resolution() const { return _resolution; }
+
+private:
+    struct Timer
+    {
+        uint64_t tick;
+        T        payload;
+    };
+
+    void Place(TimerId id, uint64_t tick)
+    {
+        // The lowest level whose block still contains the current tick.
+        for (uint32_t level = 0; level < LEVELS - 1; ++level)
+        {
+            uint32_t const blockShift = SLOT_BITS * (level + 1);
+            if ((tick >> blockShift) == (_tick >> blockShift))
+            {
+                _slots[level][(tick >> (SLOT_BITS * level)) & SLOT_MASK].push_back(id);
+                return;
+            }
+        }
+
+        _slots[LEVELS - 1][(tick >> (SLOT_BITS * (LEVELS - 1))) & SLOT_MASK].push_back(id);
+    }
+
+    void Cascade(uint32_t level, uint64_t slot)
+    {
+        std::vector<TimerId> moving;
+        moving.swap(_slots[level][slot]);
+
+        for (TimerId id : moving)
+        {
+            auto itr = _timers.find(id);
+            if (itr != _timers.end())
+                Place(id, itr->second.tick);
+        }
+    }
+
+    uint32_t _resolution;
+    uint64_t _tick;
+    TimerId  _lastId = 0;
+    std::unordered_map<TimerId, Timer> _timers;
+    std::array<std::array<std::vector<TimerId>, SLOTS>, LEVELS> _slots;
+};
+
+#endif // _TIMER_WHEEL_H_
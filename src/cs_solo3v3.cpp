@@ -1,8 +1,10 @@
 #include "Chat.h"
 #include "ObjectMgr.h"
 #include "Player.h"
+#include "StringConvert.h"
 #include "Tokenize.h"
 #include "DatabaseEnv.h"
+#include "GameTime.h"
 #include "Config.h"
 #include "BattlegroundMgr.h"
 #include "CommandScript.h"
@@ -22,6 +24,13 @@ public:
             { "rated",       HandleQueueArena3v3Rated,         SEC_PLAYER,        Console::No },
             { "unrated",     HandleQueueArena3v3UnRated,       SEC_PLAYER,        Console::No },
             { "stats",       HandleQueueArenaSolo3v3Stats,     SEC_PLAYER,        Console::No },
+            { "accept",      HandleQueueArenaSolo3v3Accept,    SEC_PLAYER,        Console::No },
+            { "decline",     HandleQueueArenaSolo3v3Decline,   SEC_PLAYER,        Console::No },
+            { "pool",        HandleQueueArenaSolo3v3Pool,      SEC_GAMEMASTER,    Console::Yes },
+            { "admission",   HandleQueueArenaSolo3v3Admission, SEC_GAMEMASTER,    Console::Yes },
+            { "eta",         HandleQueueArenaSolo3v3Eta,       SEC_PLAYER,        Console::Yes },
+            { "metrics",     HandleQueueArenaSolo3v3Metrics,   SEC_GAMEMASTER,    Console::Yes },
+            { "load",        HandleQueueArenaSolo3v3Load,      SEC_GAMEMASTER,    Console::Yes },
         };
 
         static ChatCommandTable SoloCommandTable =
@@ -92,8 +101,9 @@ public:
         if (!SoloCommand.ArenaCheckFullEquipAndTalents(player))
             return false;
 
-        if (SoloCommand.JoinQueueArena(player, nullptr, isRated))
-            handler->PSendSysMessage("You have joined the solo 3v3 arena queue {}.", isRated ? "rated" : "unrated");
+        // A successful join is reported once it completes.
+        if (!SoloCommand.JoinQueueArena(player, nullptr, isRated))
+            handler->SendSysMessage("Something went wrong while joining queue. Already in another queue?");
 
         return true;
     }
@@ -109,7 +119,11 @@ public:
         uint32 games = 0;
         uint32 wins = 0;
         uint32 losses = 0;
-        sSolo->GetSoloStats(player, rating, mmr, games, wins, losses);
+        if (!sSolo->GetSoloStats(player, rating, mmr, games, wins, losses))
+        {
+            handler->SendSysMessage("Solo 3v3 statistics are not available yet, try again in a moment.");
+            return true;
+        }
 
         handler->PSendSysMessage(
             "=== Solo 3v3 Statistics ===\nRating: {}\nMMR: {}\nGames: {}\nWins: {}\nLosses: {}",
@@ -117,6 +131,218 @@ public:
         return true;
     }
 
+    static bool HandleQueueArenaSolo3v3Accept(ChatHandler* handler, const char* /*args*/)
+    {
+        Player* player = handler->GetSession()->GetPlayer();
+        if (!player)
+            return false;
+
+        sSolo->RespondToReadyCheck(player, true);
+        return true;
+    }
+
+    static bool HandleQueueArenaSolo3v3Decline(ChatHandler* handler, const char* /*args*/)
+    {
+        Player* player = handler->GetSession()->GetPlayer();
+        if (!player)
+            return false;
+
+        sSolo->RespondToReadyCheck(player, false);
+        return true;
+    }
+
+    static bool HandleQueueArenaSolo3v3Pool(ChatHandler* handler, const char* /*args*/)
+    {
+        Solo3v3InstancePoolStats stats;
+        sSolo->GetInstancePoolStats(stats);
+
+        uint64 const claims = stats.hits + stats.misses;
+        handler->PSendSysMessage(
+            "=== Solo 3v3 Instance Pool ===\nIdle: {} across {} bracket(s) (target {} each)\nClaims: {} (hits {}, misses {}, hit rate {}%)\nCreated: {}",
+            stats.idle, stats.brackets, sConfigMgr->GetOption<uint32>("Solo.3v3.InstancePool.Size", 0),
+            claims, stats.hits, stats.misses, claims ? stats.hits * 100 / claims : 0, stats.created);
+        handler->PSendSysMessage(
+            "Creation latency (us): p50 {} p90 {} p99 {} max {} (n={})",
+            stats.createLatencyUs.Percentile(50), stats.createLatencyUs.Percentile(90),
+            stats.createLatencyUs.Percentile(99), stats.createLatencyUs.Max(), stats.createLatencyUs.Count());
+        return true;
+    }
+
+    static bool HandleQueueArenaSolo3v3Admission(ChatHandler* handler, const char* /*args*/)
+    {
+        Solo3v3AdmissionStats stats;
+        sSolo->GetAdmissionStats(stats);
+
+        handler->PSendSysMessage(
+            "=== Solo 3v3 Admission ===\nActive arenas: {} (max {})\nHeld matches: {}\nAvg world update: {} ms (max {})",
+            stats.activeArenas, sConfigMgr->GetOption<uint32>("Solo.3v3.Admission.MaxInstances", 0), stats.heldMatches,
+            stats.updateTime, sConfigMgr->GetOption<uint32>("Solo.3v3.Admission.MaxUpdateTime", 0));
+        handler->PSendSysMessage(
+            "Admitted: {}\nThrottled: {} by instance cap, {} by per-tick cap, {} by load",
+            stats.verdicts[SOLO_ADMIT], stats.verdicts[SOLO_THROTTLE_INSTANCES],
+            stats.verdicts[SOLO_THROTTLE_TICK], stats.verdicts[SOLO_THROTTLE_LOAD]);
+
+        LatencyHistogram const& join = sSolo->GetJoinLatency();
+        handler->PSendSysMessage("Queue join latency (us): p50 {} p90 {} p99 {} max {} (n={})",
+            join.Percentile(50), join.Percentile(90), join.Percentile(99), join.Max(), join.Count());
+        return true;
+    }
+
+    static bool HandleQueueArenaSolo3v3Eta(ChatHandler* handler, const char* /*args*/)
+    {
+        static char const* roleNames[QueueEtaModel::ROLES] = { "Melee", "Caster", "Healer" };
+        uint64 const now = GameTime::GetGameTimeMS().count();
+
+        handler->SendSysMessage("=== Solo 3v3 Queue ETA ===");
+        bool any = false;
+        for (uint32 bracketId = 0; bracketId < MAX_BATTLEGROUND_BRACKETS; ++bracketId)
+        {
+            BattlegroundBracketId const bracket = BattlegroundBracketId(bracketId);
+            QueueEtaModel const& model = sSolo->GetEtaModel(bracket);
+
+            for (uint32 role = 0; role < QueueEtaModel::ROLES; ++role)
+            {
+                uint32 const queued = sSolo->GetQueuedCount(bracket, Solo3v3TalentCat(role));
+                if (!queued && !model.MatchedSamples(role))
+                    continue;
+
+                any = true;
+                handler->PSendSysMessage("Bracket {} {}: {} queued, joins {:.1f}/min, matches {:.1f}/min, wait p50 {}s p90 {}s, next ETA {}s",
+                    bracketId, roleNames[role], queued, model.ArrivalRate(role, now) * MINUTE, model.MatchRate(role, now) * MINUTE,
+                    model.WaitPercentileSec(role, 50), model.WaitPercentileSec(role, 90),
+                    sSolo->EstimateQueueWait(bracket, Solo3v3TalentCat(role), queued) / IN_MILLISECONDS);
+            }
+        }
+
+        if (!any)
+            handler->SendSysMessage("No queue history yet.");
+
+        Solo3v3BroadcastStats const& broadcast = sSolo->GetBroadcastStats();
+        if (broadcast.rounds)
+            handler->PSendSysMessage("Position broadcasts: {} rounds, {} sent, {} dropped, {} pending, last snapshot {} us",
+                broadcast.rounds, broadcast.sent, broadcast.dropped, broadcast.pending, broadcast.lastBuildUs);
+
+        return true;
+    }
+
+    static bool HandleQueueArenaSolo3v3Metrics(ChatHandler* handler, const char* /*args*/)
+    {
+        SoloMetrics::Snapshot snapshot;
+        sSolo->GetMetrics().Collect(snapshot);
+
+        handler->SendSysMessage("=== Solo 3v3 Metrics ===");
+        for (uint32 i = 0; i < MAX_SOLO_METRIC_COUNTER; ++i)
+            handler->PSendSysMessage("{}: {}", SOLO_METRIC_COUNTER_NAMES[i], snapshot.counters[i]);
+
+        for (uint32 i = 0; i < MAX_SOLO_METRIC_HISTOGRAM; ++i)
+        {
+            LatencyHistogram const& h = snapshot.histograms[i];
+            if (!h.Count())
+                continue;
+
+            handler->PSendSysMessage("{}: p50 {} p90 {} p99 {} max {} (n={})", SOLO_METRIC_HISTOGRAM_NAMES[i],
+                h.Percentile(50), h.Percentile(90), h.Percentile(99), h.Max(), h.Count());
+        }
+
+        SoloRatingCache const& ratings = sSolo->GetRatingCache();
+        handler->PSendSysMessage("rating cache: {} players, {} hits, {} misses", ratings.Size(), ratings.Hits(), ratings.Misses());
+
+        MatchmakingAuditWriter const& audit = sSolo->GetMatchmakingAudit();
+        if (audit.IsRunning())
+            handler->PSendSysMessage("audit journal: {} written, {} dropped, {} rotations{}", audit.Written(), audit.Dropped(),
+                audit.Rotations(), audit.OpenFailed() ? " (open failed)" : "");
+
+        ShadowMatchmaking const& shadow = sSolo->GetShadowMatchmaking();
+        if (shadow.IsRunning())
+        {
+            std::vector<ShadowPolicyStats> policies;
+            shadow.Collect(policies);
+            handler->PSendSysMessage("shadow: {} snapshots evaluated, {} dropped", shadow.Evaluated(), shadow.Dropped());
+            for (ShadowPolicyStats const& policy : policies)
+                handler->PSendSysMessage("shadow {}: {} matches in {} snapshots, MMR diff p50 {} p90 {}, wait p50 {}s p90 {}s",
+                    policy.name, policy.matches, policy.snapshots, policy.mmrDiff.Percentile(50), policy.mmrDiff.Percentile(90),
+                    policy.waitSec.Percentile(50), policy.waitSec.Percentile(90));
+        }
+
+        return true;
+    }
+
+    // .qsolo load start <joins/min> [queued] [healer %] [mmr mean] [mmr sd] [bracket] | stop
+    // Without arguments, reports the running synthetic load.
+    static bool HandleQueueArenaSolo3v3Load(ChatHandler* handler, const char* args)
+    {
+        std::vector<std::string_view> const tokens = Acore::Tokenize(args ? args : "", ' ', false);
+
+        if (!tokens.empty() && tokens[0] == "stop")
+        {
+            if (!sSolo->GetSyntheticLoad())
+            {
+                handler->SendSysMessage("No synthetic load is running.");
+                return true;
+            }
+
+            sSolo->StopSyntheticLoad();
+            handler->SendSysMessage("Synthetic load stopped, summary written to the solo3v3 log.");
+            return true;
+        }
+
+        if (!tokens.empty() && tokens[0] == "start")
+        {
+            auto arg = [&tokens](size_t i, double def)
+            {
+                return i < tokens.size() ? Acore::StringTo<double>(tokens[i]).value_or(def) : def;
+            };
+
+            SoloLoadSettings settings;
+            settings.arrivalsPerMinute = std::max(0.0, arg(1, 60.0));
+            settings.initialEntries    = uint32(std::max(0.0, arg(2, 0.0)));
+            settings.healerShare       = std::clamp(arg(3, 20.0), 0.0, 100.0) / 100.0;
+            settings.mmrMean           = arg(4, 1500.0);
+            settings.mmrStdDev         = std::max(0.0, arg(5, 200.0));
+            settings.bracket           = std::min(uint32(std::max(0.0, arg(6, 0.0))), uint32(MAX_BATTLEGROUND_BRACKETS - 1));
+            settings.seed              = GameTime::GetGameTimeMS().count();
+
+            if (!sSolo->StartSyntheticLoad(settings))
+            {
+                handler->SendSysMessage("Synthetic load is disabled (Solo.3v3.LoadTest.Enable).");
+                return false;
+            }
+
+            handler->PSendSysMessage("Synthetic load started on bracket {}: {} queued, {:.1f} joins/min, {:.0f}% healers, MMR {:.0f} +- {:.0f}.",
+                settings.bracket, settings.initialEntries, settings.arrivalsPerMinute, settings.healerShare * 100,
+                settings.mmrMean, settings.mmrStdDev);
+            return true;
+        }
+
+        SyntheticSoloLoad const* load = sSolo->GetSyntheticLoad();
+        if (!load)
+        {
+            handler->SendSysMessage("No synthetic load is running. Usage: .qsolo load start <joins/min> [queued] [healer %] [mmr mean] [mmr sd] [bracket] | stop");
+            return true;
+        }
+
+        SoloLoadStats const& stats = load->Stats();
+        MatchmakingAuditReason const reason = stats.lastReason;
+        handler->PSendSysMessage(
+            "=== Solo 3v3 Synthetic Load ===\nRunning {} s on bracket {}, {} ticks\nInjected: {} melee, {} range, {} healers ({} dropped at cap)\nQueued: {}",
+            stats.elapsedMs / IN_MILLISECONDS, load->Settings().bracket, stats.ticks, stats.injected[MELEE], stats.injected[RANGE],
+            stats.injected[HEALER], stats.dropped, stats.queued);
+        handler->PSendSysMessage("Matches: {} ({} all-DPS), {:.1f}/min, last pass: {}",
+            stats.matches, stats.allDpsMatches, stats.elapsedMs ? stats.matches * 60000.0 / stats.elapsedMs : 0.0,
+            reason == AUDIT_REASON_OK ? "matched" : SOLO_METRIC_COUNTER_NAMES[SOLO_METRIC_NO_MATCH_TOO_FEW + (reason - AUDIT_REASON_TOO_FEW)]);
+
+        std::pair<char const*, LatencyHistogram const*> const histograms[] =
+        {
+            { "tick_us", &stats.tickUs }, { "pass_us", &stats.passUs }, { "candidates", &stats.candidates }, { "wait_s", &stats.waitSec }
+        };
+        for (auto const& [name, h] : histograms)
+            if (h->Count())
+                handler->PSendSysMessage("{}: p50 {} p90 {} p99 {} max {} (n={})", name,
+                    h->Percentile(50), h->Percentile(90), h->Percentile(99), h->Max(), h->Count());
+
+        return true;
+    }
+
     // USED IN TESTING ONLY!!! (time saving when alt tabbing) Will join solo 3v3 on all players!
     // also use macros: /run AcceptBattlefieldPort(1,1); to accept queue and /afk to leave arena
     static bool HandleQueueSoloArenaTesting(ChatHandler* handler, const char* /*args*/)
@@ -174,7 +400,7 @@ public:
                     continue;
 
                 if (SoloCommand.JoinQueueArena(currentPlayer, nullptr, true))
-                    handler->PSendSysMessage("Player {} has joined the solo 3v3 arena queue.", currentPlayer->GetName().c_str());
+                    handler->PSendSysMessage("Requested a solo 3v3 arena queue join for player {}.", currentPlayer->GetName().c_str());
                 else
                     handler->PSendSysMessage("Failed to join queue for player {}.", currentPlayer->GetName().c_str());
             }
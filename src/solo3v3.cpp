@@ -22,13 +22,18 @@
 #include "DatabaseEnv.h"
 #include "GameTime.h"
 #include "Log.h"
+#include "PlayerGossipMgr.h"
 #include "ScriptMgr.h"
+#include "UpdateTime.h"
+#include "World.h"
+#include "WorldSession.h"
 #include "Chat.h"
 #include "DisableMgr.h"
 #include "SocialMgr.h"
 #include "WorldSessionMgr.h"
 #include <fmt/format.h>
 #include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <functional>
 #include <limits>
@@ -37,124 +42,272 @@
 namespace
 {
     static constexpr char const* SOLO_RATING_TABLE = "character_solo3v3_rating";
-    static constexpr uint32 SOLO_RATING_DEFAULT = 1500;
-    static constexpr uint32 SOLO_RATING_MAX = 5000;
 
-    struct SoloRatingRow
+    // The ladder in the characters database.
+    class MySQLSoloLadderStorage : public SoloLadderStorage
     {
-        uint32 rating = SOLO_RATING_DEFAULT;
-        uint32 mmr = SOLO_RATING_DEFAULT;
-        uint32 games = 0;
-        uint32 wins = 0;
-        uint32 losses = 0;
-    };
+    public:
+        bool Available() override
+        {
+            uint32 const now = static_cast<uint32>(GameTime::GetGameTime().count());
+            if (!_initialized || now >= _nextCheck)
+            {
+                _initialized = true;
+                _available = bool(CharacterDatabase.Query(
+                    "SHOW TABLES LIKE 'character_solo3v3_rating'"));
+                _nextCheck = now > std::numeric_limits<uint32>::max() - 60u
+                    ? std::numeric_limits<uint32>::max()
+                    : now + 60u;
+
+                if (!_available && !_missingLogged)
+                {
+                    LOG_ERROR("solo3v3",
+                        "Rated Solo 3v3 is disabled because Characters table "
+                        "character_solo3v3_rating is missing. Import "
+                        "data/sql/characters/character_solo3v3_rating.sql.");
+                    _missingLogged = true;
+                }
+                else if (_available)
+                    _missingLogged = false;
+            }
 
-    static bool SoloRatingStorageAvailable()
-    {
-        static bool initialized = false;
-        static bool available = false;
-        static bool missingLogged = false;
-        static uint32 nextCheck = 0;
+            return _available;
+        }
 
-        uint32 const now = static_cast<uint32>(GameTime::GetGameTime().count());
-        if (!initialized || now >= nextCheck)
+        bool Load(uint32 guid, SoloLadderRow& row) override
         {
-            initialized = true;
-            available = bool(CharacterDatabase.Query(
-                "SHOW TABLES LIKE 'character_solo3v3_rating'"));
-            nextCheck = now > std::numeric_limits<uint32>::max() - 60u
-                ? std::numeric_limits<uint32>::max()
-                : now + 60u;
+            return ReadRow(CharacterDatabase.Query(fmt::format(
+                "SELECT rating, mmr, games, wins, losses FROM `{}` WHERE guid = {} LIMIT 1",
+                SOLO_RATING_TABLE, guid)), row);
+        }
 
-            if (!available && !missingLogged)
-            {
-                LOG_ERROR("solo3v3",
-                    "Rated Solo 3v3 is disabled because Characters table "
-                    "character_solo3v3_rating is missing. Import "
-                    "data/sql/characters/character_solo3v3_rating.sql.");
-                missingLogged = true;
-            }
-            else if (available)
-                missingLogged = false;
+        void LoadAsync(uint32 guid, LoadCallback callback) override
+        {
+            _callbacks.AddCallback(CharacterDatabase.AsyncQuery(fmt::format(
+                "SELECT rating, mmr, games, wins, losses FROM `{}` WHERE guid = {} LIMIT 1",
+                SOLO_RATING_TABLE, guid))
+                .WithCallback([callback = std::move(callback)](QueryResult res)
+                {
+                    SoloLadderRow row;
+                    bool const found = ReadRow(res, row);
+                    callback(found, row);
+                }));
         }
 
-        return available;
-    }
+        void Create(uint32 guid, uint32 now) override
+        {
+            // INSERT IGNORE makes concurrent first-open/first-queue paths harmless.
+            sSolo->GetMetrics().Add(SOLO_METRIC_LADDER_STATEMENTS);
+            CharacterDatabase.Execute(fmt::format(
+                "INSERT IGNORE INTO `{}` (guid, rating, mmr, games, wins, losses, last_update) "
+                "VALUES ({}, {}, {}, 0, 0, 0, {})",
+                SOLO_RATING_TABLE, guid, SOLO_RATING_DEFAULT, SOLO_RATING_DEFAULT, now));
+        }
 
-    static SoloRatingRow LoadOrCreateSoloRow(Player* player)
-    {
-        SoloRatingRow row;
-        if (!player || !SoloRatingStorageAvailable())
-            return row;
+        void Update(uint32 guid, SoloLadderUpdate const& update, uint32 now) override
+        {
+            SoloLadderRow initial;
+            SoloLadder::Apply(initial, update);
+
+            // The update is atomic in SQL, so two close result paths cannot overwrite
+            // each other's counters or restore an older rating snapshot.
+            sSolo->GetMetrics().Add(SOLO_METRIC_LADDER_STATEMENTS);
+            CharacterDatabase.Execute(fmt::format(
+                "INSERT INTO `{}` (guid, rating, mmr, games, wins, losses, last_update) "
+                "VALUES ({}, {}, {}, {}, {}, {}, {}) "
+                "ON DUPLICATE KEY UPDATE "
+                "rating=LEAST({}, GREATEST(0, CAST(rating AS SIGNED) + ({}))), "
+                "mmr=LEAST({}, GREATEST(0, CAST(mmr AS SIGNED) + ({}))), "
+                "games=games+VALUES(games), wins=wins+VALUES(wins), losses=losses+VALUES(losses), "
+                "last_update=VALUES(last_update)",
+                SOLO_RATING_TABLE, guid, initial.rating, initial.mmr, update.games, update.wins, update.losses, now,
+                SOLO_RATING_MAX, update.delta, SOLO_RATING_MAX, update.delta));
+        }
+
+        uint32 UpdateBatch(std::vector<SoloLadderBatchRow> const& rows, uint32 now) override
+        {
+            static constexpr std::size_t ROWS_PER_STATEMENT = 500;
+
+            CharacterDatabaseTransaction trans = CharacterDatabase.BeginTransaction();
+            uint32 statements = 0;
+            for (std::size_t first = 0; first < rows.size(); first += ROWS_PER_STATEMENT)
+            {
+                std::size_t const last = std::min(rows.size(), first + ROWS_PER_STATEMENT);
+                std::string defaults;
+                std::string deltas;
+                for (std::size_t i = first; i < last; ++i)
+                {
+                    SoloLadderBatchRow const& row = rows[i];
+                    char const* separator = i == first ? "" : ", ";
+                    defaults += fmt::format("{}({}, {}, {}, 0, 0, 0, {})",
+                        separator, row.guid, SOLO_RATING_DEFAULT, SOLO_RATING_DEFAULT, now);
+                    deltas += fmt::format("{}({}, {}, {}, {}, {}, {}, {})",
+                        separator, row.guid, row.update.delta, row.update.delta, row.update.games, row.update.wins,
+                        row.update.losses, now);
+                }
+
+                // Missing rows are created first, so the upsert always takes its
+                // update path and VALUES(rating)/VALUES(mmr) carry each row's delta.
+                trans->Append(fmt::format(
+                    "INSERT IGNORE INTO `{}` (guid, rating, mmr, games, wins, losses, last_update) VALUES {}",
+                    SOLO_RATING_TABLE, defaults));
+                trans->Append(fmt::format(
+                    "INSERT INTO `{}` (guid, rating, mmr, games, wins, losses, last_update) VALUES {} "
+                    "ON DUPLICATE KEY UPDATE "
+                    "rating=LEAST({}, GREATEST(0, CAST(rating AS SIGNED) + VALUES(rating))), "
+                    "mmr=LEAST({}, GREATEST(0, CAST(mmr AS SIGNED) + VALUES(mmr))), "
+                    "games=games+VALUES(games), wins=wins+VALUES(wins), losses=losses+VALUES(losses), "
+                    "last_update=VALUES(last_update)",
+                    SOLO_RATING_TABLE, deltas, SOLO_RATING_MAX, SOLO_RATING_MAX));
+                statements += 2;
+            }
 
-        uint32 guidLow = player->GetGUID().GetCounter();
-        QueryResult res = CharacterDatabase.Query(fmt::format(
-            "SELECT rating, mmr, games, wins, losses FROM `{}` WHERE guid = {} LIMIT 1",
-            SOLO_RATING_TABLE, guidLow));
+            CharacterDatabase.CommitTransaction(trans);
+            sSolo->GetMetrics().Add(SOLO_METRIC_LADDER_STATEMENTS, statements);
+            return statements;
+        }
+
+        void ProcessCallbacks() override { _callbacks.ProcessReadyCallbacks(); }
 
-        if (res)
+    private:
+        static bool ReadRow(QueryResult const& res, SoloLadderRow& row)
         {
+            if (!res)
+                return false;
+
             Field* f = res->Fetch();
             row.rating = f[0].Get<uint32>();
             row.mmr = f[1].Get<uint32>();
             row.games = f[2].Get<uint32>();
             row.wins = f[3].Get<uint32>();
             row.losses = f[4].Get<uint32>();
-            return row;
+            return true;
         }
 
-        // INSERT IGNORE makes concurrent first-open/first-queue paths harmless.
-        CharacterDatabase.Execute(fmt::format(
-            "INSERT IGNORE INTO `{}` (guid, rating, mmr, games, wins, losses, last_update) "
-            "VALUES ({}, {}, {}, 0, 0, 0, {})",
-            SOLO_RATING_TABLE, guidLow, SOLO_RATING_DEFAULT, SOLO_RATING_DEFAULT,
-            static_cast<uint32>(GameTime::GetGameTime().count())));
+        QueryCallbackProcessor _callbacks;
+        bool _initialized = false;
+        bool _available = false;
+        bool _missingLogged = false;
+        uint32 _nextCheck = 0;
+    };
+
+    SoloLadderStorage& Ladder()
+    {
+        return sSolo->GetLadderStorage();
+    }
 
-        return row;
+    uint32 LadderNow()
+    {
+        return static_cast<uint32>(GameTime::GetGameTime().count());
     }
 
-    static float ExpectedScore(uint32 playerMmr, uint32 opponentMmr)
+    static bool SoloRatingStorageAvailable()
     {
-        float const difference = float(int32(opponentMmr) - int32(playerMmr));
-        return 1.0f / (1.0f + std::pow(10.0f, difference / 400.0f));
+        return Ladder().Available();
     }
+}
+
+Solo3v3* Solo3v3::instance()
+{
+    static Solo3v3 instance;
+    return &instance;
+}
 
-    static uint32 ApplyDeltaToDefault(int32 delta)
+SoloLadderStorage& Solo3v3::GetLadderStorage()
+{
+    if (!ladderStorage)
     {
-        int64 const value = int64(SOLO_RATING_DEFAULT) + int64(delta);
-        return uint32(std::clamp<int64>(value, 0, SOLO_RATING_MAX));
+        std::string const backend = sConfigMgr->GetOption<std::string>("Solo.3v3.Rated.Storage", "mysql");
+        if (backend == "memory")
+        {
+            LOG_WARN("solo3v3", "Solo3v3: the solo ladder is kept in memory (Solo.3v3.Rated.Storage) and is lost on restart");
+            SetLadderStorage(std::make_unique<InMemorySoloLadderStorage>());
+        }
+        else
+        {
+            if (backend != "mysql")
+                LOG_ERROR("solo3v3", "Solo3v3: unknown Solo.3v3.Rated.Storage '{}', using mysql", backend);
+            SetLadderStorage(std::make_unique<MySQLSoloLadderStorage>());
+        }
     }
 
-    static void ApplyAtomicSoloUpdate(Player* player, int32 delta, uint32 games, uint32 wins, uint32 losses)
+    return *ladderStorage;
+}
+
+void Solo3v3::SetLadderStorage(std::unique_ptr<SoloLadderStorage> backend)
+{
+    static SoloMetricHistogram const opMetrics[MAX_SOLO_LADDER_OP] =
     {
-        if (!player || !SoloRatingStorageAvailable())
-            return;
+        SOLO_METRIC_DB_CHECK_US, SOLO_METRIC_DB_LOAD_US, SOLO_METRIC_DB_LOAD_ASYNC_US, SOLO_METRIC_DB_CREATE_US,
+        SOLO_METRIC_DB_UPDATE_US, SOLO_METRIC_DB_FLUSH_US
+    };
 
-        uint32 const guidLow = player->GetGUID().GetCounter();
-        uint32 const now = static_cast<uint32>(GameTime::GetGameTime().count());
-        uint32 const initial = ApplyDeltaToDefault(delta);
+    FlushSoloLadder();
+    ladderStorage.reset();
+    ladderWriteBehind.reset();
+    ladderBackend = std::move(backend);
 
-        // The update is atomic in SQL, so two close result paths cannot overwrite
-        // each other's counters or restore an older rating snapshot.
-        CharacterDatabase.Execute(fmt::format(
-            "INSERT INTO `{}` (guid, rating, mmr, games, wins, losses, last_update) "
-            "VALUES ({}, {}, {}, {}, {}, {}, {}) "
-            "ON DUPLICATE KEY UPDATE "
-            "rating=LEAST({}, GREATEST(0, CAST(rating AS SIGNED) + ({}))), "
-            "mmr=LEAST({}, GREATEST(0, CAST(mmr AS SIGNED) + ({}))), "
-            "games=games+VALUES(games), wins=wins+VALUES(wins), losses=losses+VALUES(losses), "
-            "last_update=VALUES(last_update)",
-            SOLO_RATING_TABLE, guidLow, initial, initial, games, wins, losses, now,
-            SOLO_RATING_MAX, delta, SOLO_RATING_MAX, delta));
+    SoloLadderStorage* storage = ladderBackend.get();
+    if (sConfigMgr->GetOption<bool>("Solo.3v3.Rated.WriteBehind.Enable", true))
+    {
+        uint32 const maxDelayMs = sConfigMgr->GetOption<uint32>("Solo.3v3.Rated.WriteBehind.MaxDelay", 5) * IN_MILLISECONDS;
+        uint32 const maxRows    = sConfigMgr->GetOption<uint32>("Solo.3v3.Rated.WriteBehind.MaxRows", 200);
+        ladderWriteBehind = std::make_unique<WriteBehindSoloLadderStorage>(*ladderBackend, maxDelayMs, maxRows,
+            [this](SoloLadderFlush const& flush)
+            {
+                metrics.Add(SOLO_METRIC_LADDER_FLUSHES);
+                metrics.Record(SOLO_METRIC_DB_FLUSH_US, flush.us);
+                metrics.Record(SOLO_METRIC_DB_FLUSH_ROWS, flush.rows);
+            });
+        storage = ladderWriteBehind.get();
     }
+
+    ladderStorage = std::make_unique<TimedSoloLadderStorage>(*storage, [this](SoloLadderOp op, uint64_t us)
+    {
+        metrics.Record(opMetrics[op], us);
+    });
 }
 
-Solo3v3* Solo3v3::instance()
+void Solo3v3::FlushSoloLadder()
 {
-    static Solo3v3 instance;
-    return &instance;
+    if (ladderWriteBehind)
+        ladderWriteBehind->Flush();
+}
+
+void Solo3v3::LoadSoloRating(Player* player)
+{
+    if (!player || !SoloRatingStorageAvailable())
+        return;
+
+    uint32 const guidLow = player->GetGUID().GetCounter();
+    uint32 const token = ratingCache.BeginLoad(guidLow);
+    Ladder().LoadAsync(guidLow, [guidLow, token](bool found, SoloLadderRow const& row)
+    {
+        if (!found)
+            Ladder().Create(guidLow, LadderNow());
+
+        sSolo->ratingCache.Fill(guidLow, token, row);
+    });
+}
+
+SoloLadderRow const* Solo3v3::FindSoloRow(Player* player)
+{
+    if (!player || !SoloRatingStorageAvailable())
+        return nullptr;
+
+    return ratingCache.Find(player->GetGUID().GetCounter());
 }
 
+void Solo3v3::ApplySoloLadderUpdate(Player* player, SoloLadderUpdate const& update)
+{
+    if (!player || !SoloRatingStorageAvailable())
+        return;
+
+    uint32 const guidLow = player->GetGUID().GetCounter();
+    metrics.Add(SOLO_METRIC_LADDER_UPDATES);
+    ratingCache.Apply(guidLow, update);
+    Ladder().Update(guidLow, update, LadderNow());
+}
 
 bool Solo3v3::IsRatedEnabled()
 {
@@ -166,15 +319,39 @@ bool Solo3v3::GetSoloRatingAndMMR(Player* player, uint32& rating, uint32& mmr)
 {
     rating = SOLO_RATING_DEFAULT;
     mmr = SOLO_RATING_DEFAULT;
-    if (!player || !SoloRatingStorageAvailable())
+    SoloLadderRow const* row = FindSoloRow(player);
+    if (!row)
         return false;
 
-    SoloRatingRow const row = LoadOrCreateSoloRow(player);
-    rating = row.rating;
-    mmr = row.mmr;
+    rating = row->rating;
+    mmr = row->mmr;
     return true;
 }
 
+void Solo3v3::GetSoloRatingAndMMRAsync(Player* player, std::function<void(uint32 rating, uint32 mmr)>&& callback)
+{
+    if (!player || !SoloRatingStorageAvailable())
+    {
+        callback(SOLO_RATING_DEFAULT, SOLO_RATING_DEFAULT);
+        return;
+    }
+
+    if (SoloLadderRow const* row = ratingCache.Find(player->GetGUID().GetCounter()))
+    {
+        callback(row->rating, row->mmr);
+        return;
+    }
+
+    uint32 const guidLow = player->GetGUID().GetCounter();
+    Ladder().LoadAsync(guidLow, [guidLow, callback = std::move(callback)](bool found, SoloLadderRow const& row)
+    {
+        if (!found)
+            Ladder().Create(guidLow, LadderNow());
+
+        callback(row.rating, row.mmr);
+    });
+}
+
 bool Solo3v3::GetSoloStats(Player* player, uint32& rating, uint32& mmr, uint32& games, uint32& wins, uint32& losses)
 {
     rating = SOLO_RATING_DEFAULT;
@@ -182,15 +359,15 @@ bool Solo3v3::GetSoloStats(Player* player, uint32& rating, uint32& mmr, uint32&
     games = 0;
     wins = 0;
     losses = 0;
-    if (!player || !SoloRatingStorageAvailable())
+    SoloLadderRow const* row = FindSoloRow(player);
+    if (!row)
         return false;
 
-    SoloRatingRow const row = LoadOrCreateSoloRow(player);
-    rating = row.rating;
-    mmr = row.mmr;
-    games = row.games;
-    wins = row.wins;
-    losses = row.losses;
+    rating = row->rating;
+    mmr = row->mmr;
+    games = row->games;
+    wins = row->wins;
+    losses = row->losses;
     return true;
 }
 
@@ -199,20 +376,22 @@ void Solo3v3::UpdateSoloLadderAfterMatch(Player* player, bool isWin, bool isDraw
     if (!player)
         return;
 
-    if (isDraw)
+    SoloLadderUpdate update;
+    update.games = 1;
+    if (!isDraw)
     {
-        ApplyAtomicSoloUpdate(player, 0, 1, 0, 0);
-        return;
+        // Players in a match are online, so their row is cached; should the
+        // login load still be running, the team average stands in for the MMR.
+        SoloLadderRow const* row = FindSoloRow(player);
+        uint32 const playerMmr = row ? row->mmr : (ownTeamMMR ? ownTeamMMR : SOLO_RATING_DEFAULT);
+        uint32 const comparisonMmr = opponentTeamMMR ? opponentTeamMMR : (ownTeamMMR ? ownTeamMMR : playerMmr);
+        int32 const kFactor = std::clamp<int32>(sConfigMgr->GetOption<int32>("Solo.3v3.Rated.KFactor", 32), 1, 128);
+        update.delta = SoloLadder::MatchDelta(playerMmr, comparisonMmr, kFactor, isWin);
+        update.wins = isWin ? 1u : 0u;
+        update.losses = isWin ? 0u : 1u;
     }
 
-    SoloRatingRow const row = LoadOrCreateSoloRow(player);
-    uint32 const comparisonMmr = opponentTeamMMR ? opponentTeamMMR : (ownTeamMMR ? ownTeamMMR : row.mmr);
-    int32 const kFactor = std::clamp<int32>(sConfigMgr->GetOption<int32>("Solo.3v3.Rated.KFactor", 32), 1, 128);
-    float const expected = ExpectedScore(row.mmr, comparisonMmr);
-    float const score = isWin ? 1.0f : 0.0f;
-    int32 const delta = int32(std::lround(float(kFactor) * (score - expected)));
-
-    ApplyAtomicSoloUpdate(player, delta, 1, isWin ? 1u : 0u, isWin ? 0u : 1u);
+    ApplySoloLadderUpdate(player, update);
 }
 
 void Solo3v3::ApplySoloLadderPenalty(Player* player, uint32 ratingLoss)
@@ -220,8 +399,11 @@ void Solo3v3::ApplySoloLadderPenalty(Player* player, uint32 ratingLoss)
     if (!player || ratingLoss == 0)
         return;
 
-    uint32 const clampedLoss = std::min<uint32>(ratingLoss, SOLO_RATING_MAX);
-    ApplyAtomicSoloUpdate(player, -int32(clampedLoss), 1, 0, 1);
+    SoloLadderUpdate update;
+    update.delta = -int32(std::min<uint32>(ratingLoss, SOLO_RATING_MAX));
+    update.games = 1;
+    update.losses = 1;
+    ApplySoloLadderUpdate(player, update);
 }
 
 uint32 Solo3v3::GetAverageMMR(ArenaTeam* team)
@@ -253,14 +435,17 @@ void Solo3v3::CountAsLoss(Player* player, bool isInProgress)
     int32 ratingLoss = 0;
     if (isInProgress)
     {
-        bool const isFirstLeaver = instanceId && arenasWithDeserter.count(instanceId) == 0;
+        auto const match = matches.find(instanceId);
+        bool const isFirstLeaver = instanceId && (match == matches.end() || !match->second.hasDeserter);
         ratingLoss = sConfigMgr->GetOption<int32>(
             isFirstLeaver ? "Solo.3v3.RatingPenalty.FirstLeaveDuringMatch" : "Solo.3v3.RatingPenalty.LeaveDuringMatch",
             isFirstLeaver ? 50 : 24);
 
         if (isFirstLeaver)
         {
-            arenasWithDeserter.insert(instanceId);
+            if (match != matches.end())
+                match->second.hasDeserter = true;
+
             if (sConfigMgr->GetOption<bool>("Solo.3v3.CastDeserterOnLeave", true))
                 player->CastSpell(player, 26013, true);
         }
@@ -281,7 +466,25 @@ void Solo3v3::CleanUp3v3SoloQ(Battleground* bg)
     {
         uint32 instanceId = bg->GetInstanceID();
         if (instanceId)
-            arenasWithDeserter.erase(instanceId);
+        {
+            auto const match = matches.find(instanceId);
+            if (match != matches.end())
+            {
+                if (match->second.trace.Active())
+                    WriteMatchTrace(instanceId, match->second);
+
+                matches.erase(match);
+            }
+
+            // Entries still attached to the arena never saw their player leave it.
+            for (auto itr = pendingRequeues.begin(); itr != pendingRequeues.end();)
+            {
+                if (itr->second.instanceId == instanceId)
+                    itr = pendingRequeues.erase(itr);
+                else
+                    ++itr;
+            }
+        }
 
         ArenaTeam* tempAlliArenaTeam = sArenaTeamMgr->GetArenaTeamById(bg->GetArenaTeamIdForTeam(TEAM_ALLIANCE));
         ArenaTeam* tempHordeArenaTeam = sArenaTeamMgr->GetArenaTeamById(bg->GetArenaTeamIdForTeam(TEAM_HORDE));
@@ -300,426 +503,2065 @@ void Solo3v3::CleanUp3v3SoloQ(Battleground* bg)
     }
 }
 
-void Solo3v3::SaveIncompleteMatchLogs(Battleground* bg)
+void Solo3v3::Update(uint32 diff)
 {
-    if (!bg || !bg->isRated() || bg->GetArenaType() != ARENA_TYPE_3v3_SOLO)
-        return;
+    UpdateAdmission();
+    UpdateInstancePool(diff);
 
-    if (bg->ArenaLogEntries.empty())
-        return;
+    // Deadline-driven transitions; only timers that came due are touched.
+    timers.Advance(GameTime::GetGameTimeMS().count(), [this](TimerWheel<SoloTimer>::TimerId, SoloTimer const& timer)
+    {
+        OnTimer(timer);
+    });
 
-    uint32 startDelay = bg->GetStartDelayTime();
-    uint32 fightId = sArenaTeamMgr->GetNextArenaLogId();
-    uint32 currOnline = sWorldSessionMgr->GetActiveSessionCount();
+    if (!pendingRequeues.empty())
+        UpdatePendingRequeues();
 
-    // Mirror what Arena::EndBattleground does for the TEAM_NEUTRAL case: treat
-    // TEAM_HORDE as "winner" slot and TEAM_ALLIANCE as "loser" slot in the log
-    // row, with 0 rating changes, since neither team actually won.
-    uint32 winnerTeamId = bg->GetArenaTeamIdForTeam(TEAM_HORDE);
-    uint32 loserTeamId  = bg->GetArenaTeamIdForTeam(TEAM_ALLIANCE);
+    UpdateQueueLiveness(diff);
+    UpdateQueueBroadcast(diff);
+    UpdateQueueJournal(diff);
+    UpdateMetricsLog(diff);
 
-    CharacterDatabaseTransaction trans = CharacterDatabase.BeginTransaction();
-    CharacterDatabasePreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_INS_ARENA_LOG_FIGHT);
-    stmt->SetData(0, fightId);
-    stmt->SetData(1, bg->GetArenaType());
-    stmt->SetData(2, ((bg->GetStartTime() <= startDelay ? 0 : bg->GetStartTime() - startDelay) / 1000));
-    stmt->SetData(3, winnerTeamId);
-    stmt->SetData(4, loserTeamId);
-    stmt->SetData(5, (uint16)0); // winner team rating (no change)
-    stmt->SetData(6, (uint16)0); // winner MMR (no change)
-    stmt->SetData(7, (int16)0);  // winner rating change
-    stmt->SetData(8, (uint16)0); // loser team rating (no change)
-    stmt->SetData(9, (uint16)0); // loser MMR (no change)
-    stmt->SetData(10, (int16)0); // loser rating change
-    stmt->SetData(11, currOnline);
-    trans->Append(stmt);
+    if (ladderStorage)
+        ladderStorage->ProcessCallbacks();
 
-    uint8 memberId = 0;
-    for (auto const& [playerGuid, arenaLogEntryData] : bg->ArenaLogEntries)
-    {
-        auto const& score = bg->GetPlayerScores()->find(playerGuid.GetCounter());
-        stmt = CharacterDatabase.GetPreparedStatement(CHAR_INS_ARENA_LOG_MEMBERSTATS);
-        stmt->SetData(0, fightId);
-        stmt->SetData(1, ++memberId);
-        stmt->SetData(2, arenaLogEntryData.Name);
-        stmt->SetData(3, arenaLogEntryData.Guid);
-        stmt->SetData(4, arenaLogEntryData.ArenaTeamId);
-        stmt->SetData(5, arenaLogEntryData.Acc);
-        stmt->SetData(6, arenaLogEntryData.IP);
-        if (score != bg->GetPlayerScores()->end())
-        {
-            stmt->SetData(7, score->second->GetDamageDone());
-            stmt->SetData(8, score->second->GetHealingDone());
-            stmt->SetData(9, score->second->GetKillingBlows());
-        }
-        else
-        {
-            stmt->SetData(7, 0);
-            stmt->SetData(8, 0);
-            stmt->SetData(9, 0);
-        }
-        trans->Append(stmt);
-    }
+    if (ladderWriteBehind)
+        ladderWriteBehind->FlushIfDue(GameTime::GetGameTimeMS().count());
 
-    CharacterDatabase.CommitTransaction(trans);
+    if (syntheticLoad)
+        UpdateSyntheticLoad();
 }
 
-void Solo3v3::CheckStartSolo3v3Arena(Battleground* bg)
+// ---------------- Pre-warmed arena instance pool ----------------
+namespace
 {
-    bool someoneNotInArena = false;
-    uint32 PlayersInArena = 0;
-
-    for (const auto& playerPair : bg->GetPlayers())
-    {
-        Player* player = playerPair.second;
-
-        if (!player)
-            continue;
-
-        // prevent crash with Arena Replay module
-        if (player->IsSpectator())
-            return;
-
-        PlayersInArena++;
-    }
-
-    uint32 AmountPlayersSolo3v3 = 6;
-    if (PlayersInArena < AmountPlayersSolo3v3)
+    uint64 WallClockMs()
     {
-        someoneNotInArena = true;
+        return uint64(std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count());
     }
 
-    // if one player didn't enter arena and StopGameIncomplete is true, then end arena
-    if (someoneNotInArena && sConfigMgr->GetOption<bool>("Solo.3v3.StopGameIncomplete", true))
+    uint32 InstancePoolKey(BattlegroundBracketId bracketId, bool isRated)
     {
-        SaveIncompleteMatchLogs(bg);
-        bg->SetRated(false);
-        bg->EndBattleground(TEAM_NEUTRAL);
+        return (uint32(bracketId) << 1) | (isRated ? 1u : 0u);
     }
 }
 
-uint32 Solo3v3::GetMMR(Player* player, GroupQueueInfo* ginfo)
+Battleground* Solo3v3::CreateArenaInstance(InstancePool const& pool)
 {
-    if (ginfo->ArenaMatchmakerRating > 0)
-        return ginfo->ArenaMatchmakerRating;
-
-    ArenaTeam* at = sArenaTeamMgr->GetArenaTeamById(player->GetArenaTeamId(ARENA_SLOT_SOLO_3v3));
-    if (!at)
-        return sConfigMgr->GetOption<uint32>("Arena.ArenaStartPersonalRating", 0);
+    auto const start = std::chrono::steady_clock::now();
+    Battleground* arena = sBattlegroundMgr->CreateNewBattleground(pool.bgTypeId, pool.bracketEntry, pool.arenaType, pool.rated);
+    auto const elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
 
-    for (auto const& m : at->GetMembers())
-        if (m.Guid == player->GetGUID())
-            return m.MatchMakerRating > 0 ? m.MatchMakerRating : at->GetRating();
+    instancePoolCreateLatencyUs.Record(uint64(elapsed.count()));
+    if (arena)
+        ++instancePoolCreated;
 
-    return at->GetRating();
+    return arena;
 }
 
-int Solo3v3::CountIgnorePairs(std::vector<uint32> const& indices, std::vector<Candidate> const& selected, bool avoidIgnore)
+void Solo3v3::ReleaseArenaInstance(Battleground* arena)
 {
-    if (!avoidIgnore)
-        return 0;
-
-    int pairs = 0;
-    for (uint32 i = 0; i < indices.size(); ++i)
-        for (uint32 j = i + 1; j < indices.size(); ++j)
-        {
-            Player* a = selected[indices[i]].player;
-            Player* b = selected[indices[j]].player;
-            if (a->GetSocial()->HasIgnore(b->GetGUID()) ||
-                b->GetSocial()->HasIgnore(a->GetGUID()))
-                ++pairs;
-        }
-    return pairs;
+    // An idle instance is owned by the pool alone: it was unregistered from
+    // the BattlegroundMgr right after creation, since the manager's update
+    // deletes any arena without players or invites. Nothing else holds it.
+    delete arena;
 }
 
-uint32 Solo3v3::ClassIdToMaskBit(uint8 classId)
+Battleground* Solo3v3::ClaimArenaInstance(BattlegroundTypeId bgTypeId, PvPDifficultyEntry const* bracketEntry, uint8 arenaType, bool isRated)
 {
-    if (classId >= 1 && classId <= 9)
-        return 1u << (classId - 1);
-    if (classId == 11) // CLASS_DRUID — skip the unused slot 10
-        return 1u << 10;
-    return 0;
+    if (!bracketEntry)
+        return nullptr;
+
+    InstancePool& pool = instancePools[InstancePoolKey(bracketEntry->GetBracketId(), isRated)];
+    pool.bgTypeId     = bgTypeId;
+    pool.bracketEntry = bracketEntry;
+    pool.arenaType    = arenaType;
+    pool.rated        = isRated;
+
+    traceCreateStartUs = MatchTrace::NowUs();
+    if (!pool.idle.empty())
+    {
+        Battleground* arena = pool.idle.back();
+        pool.idle.pop_back();
+        // Back under the manager, which owns it from here like any arena.
+        sBattlegroundMgr->AddBattleground(arena);
+        ++instancePoolHits;
+        traceCreateEndUs = MatchTrace::NowUs();
+        return arena;
+    }
+
+    ++instancePoolMisses;
+    Battleground* arena = CreateArenaInstance(pool);
+    traceCreateEndUs = MatchTrace::NowUs();
+    return arena;
 }
 
-bool Solo3v3::HasClassStackingConflict(
-    std::vector<uint32> const& indices,
-    std::vector<Candidate> const& selected,
-    uint8 preventLevel,
-    uint32 classMask) const
+void Solo3v3::UpdateInstancePool(uint32 diff)
 {
-    for (uint32 i = 0; i < indices.size(); ++i)
+    if (instancePoolRefillTimer > diff)
     {
-        for (uint32 j = i + 1; j < indices.size(); ++j)
-        {
-            Candidate const& a = selected[indices[i]];
-            Candidate const& b = selected[indices[j]];
-
-            if (a.classId != b.classId)
-                continue;
+        instancePoolRefillTimer -= diff;
+        return;
+    }
 
-            // Apply optional class filter; 0 means all classes are checked
-            if (classMask != 0 && !(classMask & ClassIdToMaskBit(a.classId)))
-                continue;
+    instancePoolRefillTimer = sConfigMgr->GetOption<uint32>("Solo.3v3.InstancePool.RefillInterval", 1000);
+    uint32 const poolSize   = sConfigMgr->GetOption<uint32>("Solo.3v3.InstancePool.Size", 0);
 
-            bool aIsMelee  = (a.role == MELEE);
-            bool aIsRange  = (a.role == RANGE);
-            bool aIsHealer = (a.role == HEALER);
-            bool bIsMelee  = (b.role == MELEE);
-            bool bIsRange  = (b.role == RANGE);
-            bool bIsHealer = (b.role == HEALER);
+    for (auto& [key, pool] : instancePools)
+    {
+        // Trim first so lowering the size on config reload frees idle arenas.
+        while (pool.idle.size() > poolSize)
+        {
+            ReleaseArenaInstance(pool.idle.back());
+            pool.idle.pop_back();
+        }
 
-            switch (preventLevel)
+        // At most one creation per bracket per refill keeps the cost spread out
+        // instead of landing on the tick that just drained the pool.
+        if (pool.idle.size() < poolSize)
+        {
+            if (Battleground* arena = CreateArenaInstance(pool))
             {
-                case 1: return true;                                                                               // all roles
-                case 2: if (aIsMelee  && bIsMelee)                              return true; break;               // melee only
-                case 3: if (aIsRange  && bIsRange)                              return true; break;               // ranged only
-                case 4: if ((aIsMelee || aIsRange)  && (bIsMelee || bIsRange))  return true; break;               // any DPS
-                case 5: if ((aIsMelee || aIsHealer) && (bIsMelee || bIsHealer)) return true; break;               // melee + healer
-                case 6: if ((aIsRange  || aIsHealer) && (bIsRange  || bIsHealer)) return true; break;             // ranged + healer
-                default: break;
+                // Kept out of the manager until claimed (see ReleaseArenaInstance).
+                sBattlegroundMgr->RemoveBattleground(arena->GetBgTypeID(), arena->GetInstanceID());
+                pool.idle.push_back(arena);
             }
         }
     }
-    return false;
 }
 
-void Solo3v3::EnumerateCombinations(
-    uint32 start,
-    uint32 depth,
-    std::vector<uint32>& combo,
-    std::vector<Candidate> const& selected,
-    uint32 teamSize,
-    uint32 n,
-    bool filterTalents,
-    bool allDpsMatch,
-    bool avoidIgnore,
-    uint8 preventClassStacking,
-    uint32 classStackMask,
-    std::vector<uint32>& bestTeam1,
-    bool& haveBest,
-    uint64& bestDiff,
-    int& bestIgnores)
+void Solo3v3::GetInstancePoolStats(Solo3v3InstancePoolStats& stats) const
 {
-    if (depth == teamSize)
+    stats = Solo3v3InstancePoolStats();
+    for (auto const& [key, pool] : instancePools)
     {
-        // Build team2 as the complement of combo within [0, n)
-        std::vector<uint32> team2;
-        uint32 ci = 0;
-        for (uint32 i = 0; i < n; ++i)
-        {
-            if (ci < teamSize && combo[ci] == i) { ++ci; continue; }
-            team2.push_back(i);
-        }
+        stats.idle += uint32(pool.idle.size());
+        ++stats.brackets;
+    }
 
-        // Composition validation (filterTalents only)
-        if (filterTalents)
-        {
-            uint32 h1 = 0, h2 = 0;
-            for (uint32 i : combo) if (selected[i].role == HEALER) ++h1;
-            for (uint32 i : team2) if (selected[i].role == HEALER) ++h2;
+    stats.hits            = instancePoolHits;
+    stats.misses          = instancePoolMisses;
+    stats.created         = instancePoolCreated;
+    stats.createLatencyUs = instancePoolCreateLatencyUs;
+}
 
-            if (allDpsMatch  && (h1 != 0 || h2 != 0)) return;
-            if (!allDpsMatch && (h1 != 1 || h2 != 1)) return;
-        }
+void Solo3v3::ReleaseInstancePool()
+{
+    for (auto& [key, pool] : instancePools)
+    {
+        for (Battleground* arena : pool.idle)
+            ReleaseArenaInstance(arena);
 
-        // Class stacking constraint: reject splits that place same-class players
-        // on the same team when the configured level applies to their roles.
-        if (preventClassStacking > 0)
-        {
-            if (HasClassStackingConflict(combo, selected, preventClassStacking, classStackMask) ||
-                HasClassStackingConflict(team2, selected, preventClassStacking, classStackMask))
-                return;
-        }
+        pool.idle.clear();
+    }
+}
 
-        // MMR balance score
-        int64 sum1 = 0, sum2 = 0;
-        for (uint32 i : combo) sum1 += selected[i].mmr;
-        for (uint32 i : team2) sum2 += selected[i].mmr;
-        uint64 diff = static_cast<uint64>(sum1 > sum2 ? sum1 - sum2 : sum2 - sum1);
+// ---------------- Admission control ----------------
+Solo3v3AdmissionVerdict Solo3v3::CheckAdmission() const
+{
+    uint32 const maxInstances  = sConfigMgr->GetOption<uint32>("Solo.3v3.Admission.MaxInstances", 0);
+    uint32 const maxPerTick    = sConfigMgr->GetOption<uint32>("Solo.3v3.Admission.MaxCreatesPerTick", 0);
+    uint32 const maxUpdateTime = sConfigMgr->GetOption<uint32>("Solo.3v3.Admission.MaxUpdateTime", 0);
 
-        // Ignore-pair count as tie-breaker
-        int ign = CountIgnorePairs(combo, selected, avoidIgnore) + CountIgnorePairs(team2, selected, avoidIgnore);
+    // Every started solo arena is tracked until it is destroyed.
+    if (maxInstances && matches.size() >= maxInstances)
+        return SOLO_THROTTLE_INSTANCES;
 
-        if (!haveBest || diff < bestDiff || (diff == bestDiff && ign < bestIgnores))
-        {
-            haveBest   = true;
-            bestDiff   = diff;
-            bestIgnores = ign;
-            bestTeam1.assign(combo.begin(), combo.end());
-        }
-        return;
+    if (maxPerTick && admissionCreatesThisTick >= maxPerTick)
+        return SOLO_THROTTLE_TICK;
+
+    // Never hold back the last arena: with nothing running there is nothing to shed.
+    if (maxUpdateTime && !matches.empty() && sWorldUpdateTime.GetAverageUpdateTime() > maxUpdateTime)
+        return SOLO_THROTTLE_LOAD;
+
+    return SOLO_ADMIT;
+}
+
+Solo3v3AdmissionVerdict Solo3v3::AdmitNewArena()
+{
+    Solo3v3AdmissionVerdict const verdict = CheckAdmission();
+    ++admissionVerdicts[verdict];
+
+    if (verdict == SOLO_ADMIT)
+    {
+        ++admissionCreatesThisTick;
+        return verdict;
     }
 
-    for (uint32 i = start; i <= n - (teamSize - depth); ++i)
+    // The first rejection of each minute is logged at info level so operators
+    // see that matches are being held; the rest are counted in .qsolo admission.
+    static char const* const reasons[MAX_SOLO_ADMISSION_VERDICT] = { "admitted", "instance cap", "per-tick cap", "world load" };
+    uint64 const now = uint64(GameTime::GetGameTimeMS().count());
+    if (now >= admissionLogNextMs)
+    {
+        LOG_INFO("solo3v3", "Solo3v3: arena creation throttled by {} (active {}, update time {} ms, {} more since the last report)",
+            reasons[verdict], uint32(matches.size()), sWorldUpdateTime.GetAverageUpdateTime(), admissionThrottled);
+        admissionThrottled = 0;
+        admissionLogNextMs = now + MINUTE * IN_MILLISECONDS;
+    }
+    else
     {
-        combo[depth] = i;
-        EnumerateCombinations(i + 1, depth + 1, combo, selected, teamSize, n, filterTalents, allDpsMatch, avoidIgnore, preventClassStacking, classStackMask, bestTeam1, haveBest, bestDiff, bestIgnores);
+        ++admissionThrottled;
+        LOG_DEBUG("solo3v3", "Solo3v3: arena creation throttled by {} (active {}, update time {} ms)",
+            reasons[verdict], uint32(matches.size()), sWorldUpdateTime.GetAverageUpdateTime());
     }
+
+    return verdict;
 }
 
-void Solo3v3::AssignToPool(
-    std::vector<uint32> const& indices,
-    std::vector<Candidate> const& selected,
-    uint32 poolTeam,
-    BattlegroundQueue* queue,
-    BattlegroundBracketId bracket_id,
-    uint8 allianceGroupType,
-    uint8 hordeGroupType,
-    uint32 MinPlayers)
+void Solo3v3::HoldMatchForAdmission(BattlegroundQueue* queue, BattlegroundBracketId bracket_id, bool isRated)
 {
-    uint8 const targetGroupType = (poolTeam == TEAM_ALLIANCE) ? allianceGroupType : hordeGroupType;
-    for (uint32 idx : indices)
-    {
-        Candidate const& c = selected[idx];
+    uint32 const checkId = nextReadyCheckId++;
 
-        if (c.group->teamId != static_cast<TeamId>(poolTeam))
-        {
-            uint8 const srcGroupType = (c.group->teamId == TEAM_ALLIANCE) ? allianceGroupType : hordeGroupType;
+    ReadyCheck& check = readyChecks[checkId];
+    check.bracketId     = bracket_id;
+    check.rated         = isRated;
+    check.admissionHold = true;
+    check.selectedUs    = traceSelectUs;
 
-            c.group->teamId    = static_cast<TeamId>(poolTeam);
-            c.group->GroupType = targetGroupType;
+    for (uint32 i = 0; i < BG_TEAMS_COUNT; ++i)
+        for (GroupQueueInfo* group : queue->m_SelectionPools[TEAM_ALLIANCE + i].SelectedGroups)
+            for (ObjectGuid const& guid : group->Players)
+            {
+                check.team[i].push_back(guid);
+                check.accepted.insert(guid);
+                readyCheckByPlayer[guid] = checkId;
+                SetEntryState(guid, SOLO_STATE_SELECTED);
 
-            // Re-insert into destination bucket in JoinTime order to preserve FIFO fairness
-            auto& dstList = queue->m_QueuedGroups[bracket_id][targetGroupType];
-            auto& srcList = queue->m_QueuedGroups[bracket_id][srcGroupType];
+                if (Player* player = ObjectAccessor::FindPlayer(guid))
+                    ChatHandler(player->GetSession()).SendSysMessage("Your Solo 3v3 match is ready and will start as soon as an arena is available.");
+            }
+}
 
-            auto insertPos = dstList.begin();
-            while (insertPos != dstList.end() && (*insertPos)->JoinTime <= c.group->JoinTime)
-                ++insertPos;
+void Solo3v3::UpdateAdmission()
+{
+    admissionCreatesThisTick = 0;
 
-            dstList.insert(insertPos, c.group);
-            srcList.erase(std::find(srcList.begin(), srcList.end(), c.group));
-        }
+    if (readyChecks.empty() || CheckAdmission() != SOLO_ADMIT)
+        return;
 
-        queue->m_SelectionPools[poolTeam].AddGroup(c.group, MinPlayers);
-    }
+    // Wake the brackets of held matches; the queue update pops them first.
+    for (auto const& [checkId, check] : readyChecks)
+        if (check.admissionHold)
+            ScheduleSoloQueueUpdate(check.bracketId, check.rated);
 }
 
-bool Solo3v3::CheckSolo3v3Arena(BattlegroundQueue* queue, BattlegroundBracketId bracket_id, bool isRated)
+void Solo3v3::GetAdmissionStats(Solo3v3AdmissionStats& stats) const
 {
-    queue->m_SelectionPools[TEAM_ALLIANCE].Init();
-    queue->m_SelectionPools[TEAM_HORDE].Init();
+    stats = Solo3v3AdmissionStats();
+    stats.activeArenas = uint32(matches.size());
+    stats.updateTime   = sWorldUpdateTime.GetAverageUpdateTime();
 
-    uint32 const MinPlayers             = sBattlegroundMgr->isArenaTesting() ? 1 : 3;
-    bool   const filterTalents          = sConfigMgr->GetOption<bool>("Solo.3v3.FilterTalents", false);
-    bool   const avoidIgnore            = sConfigMgr->GetOption<bool>("Solo.3v3.AvoidSameTeamIgnore", true);
-    uint32 const allDpsTimerMs          = sConfigMgr->GetOption<uint32>("Solo.3v3.FilterTalents.AllDPSTimer", 60) * 1000;
-    uint8  const preventClassStacking   = sConfigMgr->GetOption<uint8>("Solo.3v3.PreventClassStacking", 0);
-    uint32 const classStackMask         = sConfigMgr->GetOption<uint32>("Solo.3v3.PreventClassStacking.Classes", 0);
+    for (auto const& [checkId, check] : readyChecks)
+        if (check.admissionHold)
+            ++stats.heldMatches;
 
-    uint8 const allianceGroupType = isRated ? BG_QUEUE_PREMADE_ALLIANCE : BG_QUEUE_NORMAL_ALLIANCE;
-    uint8 const hordeGroupType    = isRated ? BG_QUEUE_PREMADE_HORDE    : BG_QUEUE_NORMAL_HORDE;
+    for (uint32 i = 0; i < MAX_SOLO_ADMISSION_VERDICT; ++i)
+        stats.verdicts[i] = admissionVerdicts[i];
+}
 
-    uint32 const now = GameTime::GetGameTimeMS().count();
+// ---------------- Ready check ----------------
+bool Solo3v3::IsReadyCheckEnabled()
+{
+    return sConfigMgr->GetOption<bool>("Solo.3v3.ReadyCheck.Enable", false);
+}
+
+bool Solo3v3::IsHeldByReadyCheck(ObjectGuid guid) const
+{
+    return readyCheckByPlayer.find(guid) != readyCheckByPlayer.end();
+}
+
+bool Solo3v3::HasAcceptedReadyCheck(ObjectGuid guid) const
+{
+    auto const byPlayer = readyCheckByPlayer.find(guid);
+    if (byPlayer == readyCheckByPlayer.end())
+        return false;
+
+    auto const check = readyChecks.find(byPlayer->second);
+    return check != readyChecks.end() && check->second.accepted.count(guid) != 0;
+}
+
+void Solo3v3::ScheduleSoloQueueUpdate(BattlegroundBracketId bracketId, bool isRated)
+{
+    // The scheduler derives isRated from a non-zero matchmaker rating.
+    sBattlegroundMgr->ScheduleQueueUpdate(isRated ? 1 : 0, ARENA_TYPE_3v3_SOLO, bgQueueTypeId, BATTLEGROUND_AA, bracketId);
+}
+
+void Solo3v3::BeginReadyCheck(BattlegroundQueue* queue, BattlegroundBracketId bracket_id, bool isRated)
+{
+    uint32 const timeout = sConfigMgr->GetOption<uint32>("Solo.3v3.ReadyCheck.Timeout", 20);
+    uint32 const checkId = nextReadyCheckId++;
+
+    ReadyCheck& check = readyChecks[checkId];
+    check.bracketId  = bracket_id;
+    check.rated      = isRated;
+    check.expireTime = uint64(GameTime::GetGameTimeMS().count()) + uint64(timeout) * IN_MILLISECONDS;
+    check.selectedUs = traceSelectUs;
+
+    for (uint32 i = 0; i < BG_TEAMS_COUNT; ++i)
+        for (GroupQueueInfo* group : queue->m_SelectionPools[TEAM_ALLIANCE + i].SelectedGroups)
+            for (ObjectGuid const& guid : group->Players)
+            {
+                check.team[i].push_back(guid);
+                readyCheckByPlayer[guid] = checkId;
+                SetEntryState(guid, SOLO_STATE_SELECTED);
+            }
+
+    timers.Schedule(check.expireTime, { SOLO_TIMER_READY_CHECK, ObjectGuid::Empty, checkId });
+
+    for (auto const& team : check.team)
+        for (ObjectGuid const& guid : team)
+        {
+            Player* player = ObjectAccessor::FindPlayer(guid);
+            if (!player)
+                continue;
+
+            ChatHandler(player->GetSession()).PSendSysMessage(
+                "Your Solo 3v3 match is ready! Accept within {} seconds (.qsolo accept / .qsolo decline).", timeout);
+            player->GetSession()->SendAreaTriggerMessage("Your Solo 3v3 match is ready!");
+            sPlayerGossipMgr->ShowGossipMenu(player, SOLO_3V3_GOSSIP_MENU_ID, SOLO_3V3_GOSSIP_SENDER_READY_CHECK, 0);
+        }
+}
+
+void Solo3v3::RespondToReadyCheck(Player* player, bool accept)
+{
+    if (!player)
+        return;
+
+    auto const byPlayer = readyCheckByPlayer.find(player->GetGUID());
+    if (byPlayer == readyCheckByPlayer.end())
+    {
+        ChatHandler(player->GetSession()).SendSysMessage("You have no pending Solo 3v3 match.");
+        return;
+    }
+
+    uint32 const checkId = byPlayer->second;
+    auto const checkItr = readyChecks.find(checkId);
+    if (checkItr == readyChecks.end())
+        return;
+
+    if (!accept)
+    {
+        FailReadyCheck(checkId, { player->GetGUID() },
+            sConfigMgr->GetOption<bool>("Solo.3v3.ReadyCheck.PenalizeDecline", true));
+        return;
+    }
+
+    ReadyCheck& check = checkItr->second;
+    if (!check.accepted.insert(player->GetGUID()).second)
+        return;
+
+    ChatHandler(player->GetSession()).PSendSysMessage("Ready! Waiting for the other players ({}/{}).",
+        uint32(check.accepted.size()), check.Size());
+
+    if (check.accepted.size() == check.Size())
+        ScheduleSoloQueueUpdate(check.bracketId, check.rated);
+}
+
+void Solo3v3::FailReadyCheck(uint32 checkId, std::unordered_set<ObjectGuid> const& decliners, bool penalize)
+{
+    auto const checkItr = readyChecks.find(checkId);
+    if (checkItr == readyChecks.end())
+        return;
+
+    ReadyCheck const check = std::move(checkItr->second);
+    readyChecks.erase(checkItr);
+
+    for (auto const& team : check.team)
+        for (ObjectGuid const& guid : team)
+        {
+            readyCheckByPlayer.erase(guid);
+
+            Player* player = ObjectAccessor::FindPlayer(guid);
+            if (!player)
+                continue;
+
+            if (decliners.count(guid))
+            {
+                ChatHandler(player->GetSession()).SendSysMessage("You did not accept the Solo 3v3 match and have been removed from the queue.");
+                RemoveFromSoloQueue(player);
+                if (penalize)
+                    CountAsLoss(player, false);
+            }
+            else
+            {
+                SetEntryState(guid, SOLO_STATE_QUEUED);
+                ChatHandler(player->GetSession()).SendSysMessage("A player did not accept the Solo 3v3 match. You keep your place in the queue.");
+            }
+        }
+
+    // Players keep their original JoinTime, so they are back at the front.
+    ScheduleSoloQueueUpdate(check.bracketId, check.rated);
+}
+
+void Solo3v3::LeaveReadyCheck(ObjectGuid guid)
+{
+    auto const byPlayer = readyCheckByPlayer.find(guid);
+    if (byPlayer == readyCheckByPlayer.end())
+        return;
+
+    uint32 const checkId = byPlayer->second;
+    readyCheckByPlayer.erase(byPlayer);
+
+    auto const checkItr = readyChecks.find(checkId);
+    if (checkItr == readyChecks.end())
+        return;
+
+    // The leaver is out of the check before it fails, so they are neither
+    // penalised nor told to keep a queue place they gave up.
+    for (auto& team : checkItr->second.team)
+        team.erase(std::remove(team.begin(), team.end(), guid), team.end());
+    checkItr->second.accepted.erase(guid);
+
+    FailReadyCheck(checkId, { }, false);
+}
+
+bool Solo3v3::PopAcceptedReadyCheck(BattlegroundQueue* queue, BattlegroundBracketId bracket_id, bool isRated)
+{
+    for (auto const& [id, check] : readyChecks)
+    {
+        if (check.bracketId != bracket_id || check.rated != isRated || check.accepted.size() != check.Size())
+            continue;
+
+        uint32 const checkId = id; // the map entry is erased below
+
+        // Anyone who left the queue since accepting breaks the match and is
+        // dropped without the decline penalty. A player invited to another
+        // instance meanwhile also breaks it, but is still queued there and
+        // is released like the other players rather than removed.
+        std::unordered_set<ObjectGuid> gone;
+        bool invitedElsewhere = false;
+        for (auto const& team : check.team)
+            for (ObjectGuid const& guid : team)
+            {
+                auto const queued = queue->m_QueuedPlayers.find(guid);
+                if (queued == queue->m_QueuedPlayers.end() || !ObjectAccessor::FindPlayer(guid))
+                    gone.insert(guid);
+                else if (queued->second->IsInvitedToBGInstanceGUID)
+                    invitedElsewhere = true;
+            }
+
+        if (!gone.empty() || invitedElsewhere)
+        {
+            FailReadyCheck(checkId, gone, false);
+            return false;
+        }
+
+        uint32 const MinPlayers = sBattlegroundMgr->isArenaTesting() ? 1 : 3;
+        queue->m_SelectionPools[TEAM_ALLIANCE].Init();
+        queue->m_SelectionPools[TEAM_HORDE].Init();
+
+        for (uint32 i = 0; i < BG_TEAMS_COUNT; ++i)
+            for (ObjectGuid const& guid : check.team[i])
+            {
+                readyCheckByPlayer.erase(guid);
+                queue->m_SelectionPools[TEAM_ALLIANCE + i].AddGroup(queue->m_QueuedPlayers[guid], MinPlayers);
+            }
+
+        traceSelectUs = check.selectedUs;
+        traceReadyUs  = MatchTrace::NowUs();
+        readyChecks.erase(checkId);
+        return true;
+    }
+
+    return false;
+}
+
+void Solo3v3::RemoveFromSoloQueue(Player* player)
+{
+    if (!player)
+        return;
+
+    uint32 const queueSlot = player->GetBattlegroundQueueIndex(bgQueueTypeId);
+    if (queueSlot >= PLAYER_MAX_BATTLEGROUND_QUEUES)
+        return;
+
+    sBattlegroundMgr->GetBattlegroundQueue(bgQueueTypeId).RemovePlayer(player->GetGUID(), false);
+    player->RemoveBattlegroundQueueId(bgQueueTypeId);
+    ForgetQueueEntry(player->GetGUID());
+
+    WorldPacket data;
+    sBattlegroundMgr->BuildBattlegroundStatusPacket(&data, nullptr, queueSlot, STATUS_NONE, 0, 0, 0, TEAM_NEUTRAL);
+    player->GetSession()->SendPacket(&data);
+}
+
+void Solo3v3::SaveIncompleteMatchLogs(Battleground* bg)
+{
+    if (!bg || !bg->isRated() || bg->GetArenaType() != ARENA_TYPE_3v3_SOLO)
+        return;
+
+    if (bg->ArenaLogEntries.empty())
+        return;
+
+    uint32 startDelay = bg->GetStartDelayTime();
+    uint32 fightId = sArenaTeamMgr->GetNextArenaLogId();
+    uint32 currOnline = sWorldSessionMgr->GetActiveSessionCount();
+
+    // Mirror what Arena::EndBattleground does for the TEAM_NEUTRAL case: treat
+    // TEAM_HORDE as "winner" slot and TEAM_ALLIANCE as "loser" slot in the log
+    // row, with 0 rating changes, since neither team actually won.
+    uint32 winnerTeamId = bg->GetArenaTeamIdForTeam(TEAM_HORDE);
+    uint32 loserTeamId  = bg->GetArenaTeamIdForTeam(TEAM_ALLIANCE);
+
+    CharacterDatabaseTransaction trans = CharacterDatabase.BeginTransaction();
+    CharacterDatabasePreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_INS_ARENA_LOG_FIGHT);
+    stmt->SetData(0, fightId);
+    stmt->SetData(1, bg->GetArenaType());
+    stmt->SetData(2, ((bg->GetStartTime() <= startDelay ? 0 : bg->GetStartTime() - startDelay) / 1000));
+    stmt->SetData(3, winnerTeamId);
+    stmt->SetData(4, loserTeamId);
+    stmt->SetData(5, (uint16)0); // winner team rating (no change)
+    stmt->SetData(6, (uint16)0); // winner MMR (no change)
+    stmt->SetData(7, (int16)0);  // winner rating change
+    stmt->SetData(8, (uint16)0); // loser team rating (no change)
+    stmt->SetData(9, (uint16)0); // loser MMR (no change)
+    stmt->SetData(10, (int16)0); // loser rating change
+    stmt->SetData(11, currOnline);
+    trans->Append(stmt);
+
+    uint8 memberId = 0;
+    for (auto const& [playerGuid, arenaLogEntryData] : bg->ArenaLogEntries)
+    {
+        auto const& score = bg->GetPlayerScores()->find(playerGuid.GetCounter());
+        stmt = CharacterDatabase.GetPreparedStatement(CHAR_INS_ARENA_LOG_MEMBERSTATS);
+        stmt->SetData(0, fightId);
+        stmt->SetData(1, ++memberId);
+        stmt->SetData(2, arenaLogEntryData.Name);
+        stmt->SetData(3, arenaLogEntryData.Guid);
+        stmt->SetData(4, arenaLogEntryData.ArenaTeamId);
+        stmt->SetData(5, arenaLogEntryData.Acc);
+        stmt->SetData(6, arenaLogEntryData.IP);
+        if (score != bg->GetPlayerScores()->end())
+        {
+            stmt->SetData(7, score->second->GetDamageDone());
+            stmt->SetData(8, score->second->GetHealingDone());
+            stmt->SetData(9, score->second->GetKillingBlows());
+        }
+        else
+        {
+            stmt->SetData(7, 0);
+            stmt->SetData(8, 0);
+            stmt->SetData(9, 0);
+        }
+        trans->Append(stmt);
+    }
+
+    CharacterDatabase.CommitTransaction(trans);
+}
+
+void Solo3v3::CheckStartSolo3v3Arena(Battleground* bg)
+{
+    bool someoneNotInArena = false;
+    uint32 PlayersInArena = 0;
+
+    for (const auto& playerPair : bg->GetPlayers())
+    {
+        Player* player = playerPair.second;
+
+        if (!player)
+            continue;
+
+        // prevent crash with Arena Replay module
+        if (player->IsSpectator())
+            return;
+
+        PlayersInArena++;
+    }
+
+    uint32 AmountPlayersSolo3v3 = 6;
+    if (PlayersInArena < AmountPlayersSolo3v3)
+    {
+        someoneNotInArena = true;
+    }
+
+    auto const match = matches.find(bg->GetInstanceID());
+    if (match != matches.end())
+    {
+        SetMatchState(bg->GetInstanceID(), match->second, SOLO_STATE_STARTED);
+        match->second.trace.Instant("arena_start", 0, MatchTrace::NowUs());
+    }
+
+    // if one player didn't enter arena and StopGameIncomplete is true, then end arena
+    if (someoneNotInArena && sConfigMgr->GetOption<bool>("Solo.3v3.StopGameIncomplete", true))
+        AbortIncompleteMatch(bg, nullptr);
+}
+
+void Solo3v3::AbortIncompleteMatch(Battleground* bg, Player* culprit)
+{
+    if (!bg)
+        return;
+
+    SaveIncompleteMatchLogs(bg);
+    bg->SetRated(false);
+    bg->EndBattleground(TEAM_NEUTRAL);
+
+    if (!sConfigMgr->GetOption<bool>("Solo.3v3.PriorityRequeue", true))
+        return;
+
+    auto const match = matches.find(bg->GetInstanceID());
+    if (match == matches.end())
+        return;
+
+    for (auto const& [guid, player] : bg->GetPlayers())
+    {
+        if (!player || player == culprit || player->IsSpectator())
+            continue;
+
+        for (SoloQueueEntry const& entry : match->second.roster)
+        {
+            if (entry.guid != guid)
+                continue;
+
+            pendingRequeues[guid] = { bg->GetInstanceID(), entry };
+            ChatHandler(player->GetSession()).SendSysMessage(
+                "The match was cancelled because a player did not show up. You will return to your previous position in the Solo 3v3 queue when you leave the arena.");
+            break;
+        }
+    }
+}
+
+// ---------------- Match lifecycle ----------------
+void Solo3v3::SetMatchState(uint32 instanceId, SoloMatch& match, SoloMatchState state)
+{
+    if (match.state >= state)
+        return;
+
+    LOG_DEBUG("solo3v3", "Solo3v3: arena {} state {} -> {}", instanceId, uint32(match.state), uint32(state));
+    match.state = state;
+
+    for (SoloQueueEntry& entry : match.roster)
+    {
+        // Players who never entered do not take part in a started match.
+        if (state == SOLO_STATE_STARTED && entry.state == SOLO_STATE_INVITED)
+            entry.state = SOLO_STATE_ENDED;
+        else if (entry.state < state && entry.state != SOLO_STATE_ENDED)
+            entry.state = state;
+    }
+}
+
+void Solo3v3::SetEntryState(ObjectGuid guid, SoloMatchState state)
+{
+    auto const entry = queueEntries.find(guid);
+    if (entry != queueEntries.end())
+        entry->second.state = state;
+}
+
+void Solo3v3::OnPlayerEnteredArena(Battleground* bg, Player* player)
+{
+    if (!bg || !player)
+        return;
+
+    auto const match = matches.find(bg->GetInstanceID());
+    if (match == matches.end())
+        return;
+
+    for (SoloQueueEntry& entry : match->second.roster)
+        if (entry.guid == player->GetGUID() && entry.state == SOLO_STATE_INVITED)
+            entry.state = SOLO_STATE_ENTERED;
+
+    MatchTrace& trace = match->second.trace;
+    if (trace.Active())
+        trace.Span("port", player->GetGUID().GetCounter(), trace.StartUs(), MatchTrace::NowUs());
+}
+
+void Solo3v3::OnArenaEnded(Battleground* bg)
+{
+    if (!bg)
+        return;
+
+    auto const match = matches.find(bg->GetInstanceID());
+    if (match != matches.end())
+    {
+        SetMatchState(bg->GetInstanceID(), match->second, SOLO_STATE_ENDED);
+        match->second.trace.Instant("arena_end", 0, MatchTrace::NowUs());
+    }
+}
+
+void Solo3v3::ScheduleAllDpsPromotion(SoloQueueEntry const& entry)
+{
+    if (entry.role == HEALER)
+        return;
+
+    uint32 const allDpsTimerMs = sConfigMgr->GetOption<uint32>("Solo.3v3.FilterTalents.AllDPSTimer", 60) * IN_MILLISECONDS;
+    timers.Schedule(uint64(entry.joinTime) + allDpsTimerMs, { SOLO_TIMER_ALL_DPS, entry.guid, entry.joinTime });
+}
+
+void Solo3v3::OnTimer(SoloTimer const& timer)
+{
+    switch (timer.type)
+    {
+        case SOLO_TIMER_ALL_DPS:
+        {
+            // Stale if the player left or requeued since (JoinTime changed).
+            auto const itr = queueEntries.find(timer.guid);
+            if (itr == queueEntries.end() || itr->second.joinTime != timer.id)
+                break;
+
+            // Also promoted while held by a ready check or admission, so it
+            // counts as soon as the player is released back to the queue.
+            itr->second.allDpsReady = true;
+            if (itr->second.state == SOLO_STATE_QUEUED)
+                ScheduleSoloQueueUpdate(itr->second.bracketId, itr->second.rated);
+            break;
+        }
+        case SOLO_TIMER_READY_CHECK:
+        {
+            auto const itr = readyChecks.find(timer.id);
+            if (itr == readyChecks.end() || itr->second.accepted.size() == itr->second.Size())
+                break;
+
+            // Only players still in the solo queue can have declined; anyone
+            // who left is not penalised.
+            std::unordered_set<ObjectGuid> missing;
+            for (auto const& team : itr->second.team)
+                for (ObjectGuid const& guid : team)
+                    if (!itr->second.accepted.count(guid))
+                        if (Player* player = ObjectAccessor::FindPlayer(guid))
+                            if (player->InBattlegroundQueueForBattlegroundQueueType(bgQueueTypeId))
+                                missing.insert(guid);
+
+            FailReadyCheck(timer.id, missing, sConfigMgr->GetOption<bool>("Solo.3v3.ReadyCheck.PenalizeDecline", true));
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+void Solo3v3::OnPlayerLeftArena(Battleground* bg, Player* player)
+{
+    if (!bg || !player)
+        return;
+
+    // The arena still owns the player's queue slot inside RemovePlayerAtLeave,
+    // so the requeue itself happens from Update() once they are fully out.
+    auto const pending = pendingRequeues.find(player->GetGUID());
+    if (pending != pendingRequeues.end())
+        pending->second.instanceId = 0;
+
+    auto const match = matches.find(bg->GetInstanceID());
+    if (match != matches.end())
+        for (SoloQueueEntry& entry : match->second.roster)
+            if (entry.guid == player->GetGUID())
+                entry.state = SOLO_STATE_ENDED;
+}
+
+void Solo3v3::UpdatePendingRequeues()
+{
+    for (auto itr = pendingRequeues.begin(); itr != pendingRequeues.end();)
+    {
+        if (itr->second.instanceId)
+        {
+            ++itr;
+            continue;
+        }
+
+        Player* player = ObjectAccessor::FindPlayer(itr->first);
+        if (player && player->InBattleground())
+        {
+            ++itr;
+            continue;
+        }
+
+        if (player && RequeuePlayer(player, itr->second.entry))
+            ChatHandler(player->GetSession()).SendSysMessage("You have been returned to the Solo 3v3 queue at your previous position.");
+
+        itr = pendingRequeues.erase(itr);
+    }
+}
+
+void Solo3v3::UpdateQueueBroadcast(uint32 diff)
+{
+    if (broadcastCursor >= broadcastRound.size())
+    {
+        if (broadcastTimer > diff)
+        {
+            broadcastTimer -= diff;
+            return;
+        }
+
+        broadcastTimer = sConfigMgr->GetOption<uint32>("Solo.3v3.Broadcast.Interval", 30) * IN_MILLISECONDS;
+
+        if (!sConfigMgr->GetOption<bool>("Solo.3v3.Broadcast.Enable", false) || queueEntries.empty())
+            return;
+
+        // One pass over the queue: order by bracket, role and join time so
+        // positions fall out of a single linear walk.
+        auto const start = std::chrono::steady_clock::now();
+        std::vector<SoloQueueEntry const*> ordered;
+        ordered.reserve(queueEntries.size());
+        for (auto const& [guid, entry] : queueEntries)
+            if (entry.state == SOLO_STATE_QUEUED)
+                ordered.push_back(&entry);
+
+        std::sort(ordered.begin(), ordered.end(), [](SoloQueueEntry const* a, SoloQueueEntry const* b)
+        {
+            if (a->bracketId != b->bracketId)
+                return a->bracketId < b->bracketId;
+            if (a->role != b->role)
+                return a->role < b->role;
+            return a->joinTime < b->joinTime;
+        });
+
+        uint32 const now = GameTime::GetGameTimeMS().count();
+        broadcastRound.clear();
+        broadcastCursor = 0;
+        for (size_t i = 0, groupStart = 0; i < ordered.size(); ++i)
+        {
+            SoloQueueEntry const& entry = *ordered[i];
+            if (i > 0 && (ordered[i - 1]->bracketId != entry.bracketId || ordered[i - 1]->role != entry.role))
+                groupStart = i;
+
+            uint32 const ahead  = uint32(i - groupStart);
+            uint32 const total  = EstimateQueueWait(entry.bracketId, entry.role, ahead);
+            uint32 const waited = now > entry.joinTime ? now - entry.joinTime : 0;
+
+            QueueBroadcast message;
+            message.guid     = entry.guid;
+            message.position = ahead + 1;
+            message.queued   = GetQueuedCount(entry.bracketId, entry.role);
+            message.eta      = total > waited ? total - waited : 0;
+            broadcastRound.push_back(message);
+        }
+
+        ++broadcastStats.rounds;
+        broadcastStats.lastBuildUs = uint32(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    // Bounded per tick; a large queue is spread over the next few updates.
+    static char const* roleNames[QueueEtaModel::ROLES] = { "melee players", "casters", "healers" };
+    uint32 const maxPerTick = std::max<uint32>(1, sConfigMgr->GetOption<uint32>("Solo.3v3.Broadcast.MaxPerTick", 200));
+    for (uint32 sent = 0; sent < maxPerTick && broadcastCursor < broadcastRound.size(); ++sent)
+    {
+        QueueBroadcast const& message = broadcastRound[broadcastCursor++];
+        SoloQueueEntry const* entry = GetQueueEntry(message.guid);
+        Player* player = entry ? ObjectAccessor::FindPlayer(message.guid) : nullptr;
+        if (!player || !player->IsInWorld())
+        {
+            ++broadcastStats.dropped;
+            continue;
+        }
+
+        if (message.eta)
+            ChatHandler(player->GetSession()).PSendSysMessage("Solo 3v3: you are {} of {} queued {}. Estimated wait: {}m {}s.",
+                message.position, message.queued, roleNames[entry->role], message.eta / MINUTE / IN_MILLISECONDS, message.eta / IN_MILLISECONDS % MINUTE);
+        else
+            ChatHandler(player->GetSession()).PSendSysMessage("Solo 3v3: you are {} of {} queued {}.",
+                message.position, message.queued, roleNames[entry->role]);
+
+        ++broadcastStats.sent;
+    }
+
+    broadcastStats.pending = uint32(broadcastRound.size() - broadcastCursor);
+}
+
+void Solo3v3::UpdateMetricsLog(uint32 diff)
+{
+    if (metricsLogTimer > diff)
+    {
+        metricsLogTimer -= diff;
+        return;
+    }
+
+    uint32 const interval = sConfigMgr->GetOption<uint32>("Solo.3v3.Metrics.LogInterval", 300);
+    metricsLogTimer = std::max<uint32>(interval, 10) * IN_MILLISECONDS;
+    if (!interval)
+        return;
+
+    LogShadowMatchmaking();
+
+    SoloMetrics::Snapshot snapshot;
+    metrics.Collect(snapshot);
+
+    uint64 delta[MAX_SOLO_METRIC_COUNTER];
+    for (uint32 i = 0; i < MAX_SOLO_METRIC_COUNTER; ++i)
+    {
+        delta[i] = snapshot.counters[i] - metricsLogged[i];
+        metricsLogged[i] = snapshot.counters[i];
+    }
+
+    if (delta[SOLO_METRIC_LADDER_UPDATES])
+    {
+        LatencyHistogram const& flush = snapshot.histograms[SOLO_METRIC_DB_FLUSH_US];
+        LOG_INFO("solo3v3", "Solo3v3 ladder: {} rated matches, {} updates, {} write statements ({:.1f} per match) in {} flushes; "
+            "flush p50 {} us p99 {} us",
+            delta[SOLO_METRIC_LADDER_MATCHES], delta[SOLO_METRIC_LADDER_UPDATES], delta[SOLO_METRIC_LADDER_STATEMENTS],
+            delta[SOLO_METRIC_LADDER_MATCHES] ? double(delta[SOLO_METRIC_LADDER_STATEMENTS]) / delta[SOLO_METRIC_LADDER_MATCHES] : 0.0,
+            delta[SOLO_METRIC_LADDER_FLUSHES], flush.Percentile(50), flush.Percentile(99));
+    }
+
+    if (!delta[SOLO_METRIC_CHECKS])
+        return;
+
+    LatencyHistogram const& check = snapshot.histograms[SOLO_METRIC_CHECK_US];
+    LOG_INFO("solo3v3", "Solo3v3 metrics: {} checks, {} matches, no match: {} too few / {} one healer / {} all-DPS wait / {} role shortage / {} no split; "
+        "check p50 {} us p99 {} us max {} us",
+        delta[SOLO_METRIC_CHECKS], delta[SOLO_METRIC_MATCHES_FORMED], delta[SOLO_METRIC_NO_MATCH_TOO_FEW],
+        delta[SOLO_METRIC_NO_MATCH_ONE_HEALER], delta[SOLO_METRIC_NO_MATCH_ALL_DPS_WAIT], delta[SOLO_METRIC_NO_MATCH_ROLE_SHORTAGE],
+        delta[SOLO_METRIC_NO_MATCH_NO_SPLIT], check.Percentile(50), check.Percentile(99), check.Max());
+}
+
+void Solo3v3::UpdateQueueLiveness(uint32 diff)
+{
+    if (livenessTimer > diff)
+    {
+        livenessTimer -= diff;
+        return;
+    }
+
+    livenessTimer = sConfigMgr->GetOption<uint32>("Solo.3v3.Liveness.Interval", 5) * IN_MILLISECONDS;
+
+    // Queue entries are still pruned when the liveness checks are off.
+    bool   const enabled      = sConfigMgr->GetOption<bool>("Solo.3v3.Liveness.Enable", false);
+    uint32 const now          = GameTime::GetGameTimeMS().count();
+    uint32 const afkEvictMs   = sConfigMgr->GetOption<uint32>("Solo.3v3.Liveness.AFKEvictMinutes", 0) * MINUTE * IN_MILLISECONDS;
+    bool   const skipCombat   = sConfigMgr->GetOption<bool>("Solo.3v3.Liveness.SkipInCombat", true);
+    bool   const skipDead     = sConfigMgr->GetOption<bool>("Solo.3v3.Liveness.SkipDead", true);
+    bool   const skipInstance = sConfigMgr->GetOption<bool>("Solo.3v3.Liveness.SkipInInstance", true);
+
+    std::vector<Player*> evicted;
+    std::vector<ObjectGuid> left;
+    for (auto itr = queueEntries.begin(); itr != queueEntries.end();)
+    {
+        Player* player = ObjectAccessor::FindPlayer(itr->first);
+
+        // Left the queue through the client or the core; nothing else tells us.
+        if (!player || !player->InBattlegroundQueueForBattlegroundQueueType(bgQueueTypeId))
+        {
+            queueJournal.AppendLeave(itr->first.GetRawValue());
+            AuditQueueEvent(AUDIT_LEAVE, itr->second);
+            CountQueueEntry(itr->second, -1);
+            left.push_back(itr->first);
+            itr = queueEntries.erase(itr);
+            continue;
+        }
+
+        SoloQueueEntry& entry = itr->second;
+        ++itr;
+
+        if (!enabled)
+        {
+            entry.afkSince  = 0;
+            entry.available = true;
+            continue;
+        }
+
+        // Players in a ready check already answered the "are you there" question.
+        if (IsHeldByReadyCheck(entry.guid))
+            continue;
+
+        if (player->isAFK())
+        {
+            if (!entry.afkSince)
+                entry.afkSince = now;
+            else if (afkEvictMs && now - entry.afkSince >= afkEvictMs)
+            {
+                evicted.push_back(player);
+                continue;
+            }
+        }
+        else
+            entry.afkSince = 0;
+
+        entry.available = !entry.afkSince &&
+            !(skipCombat && player->IsInCombat()) &&
+            !(skipDead && !player->IsAlive()) &&
+            !(skipInstance && player->GetMap() && player->GetMap()->Instanceable());
+    }
+
+    for (ObjectGuid const& guid : left)
+        LeaveReadyCheck(guid);
+
+    for (Player* player : evicted)
+    {
+        LOG_DEBUG("solo3v3", "Solo3v3: evicting AFK player {} from the solo queue", player->GetGUID().ToString());
+        RemoveFromSoloQueue(player);
+        ChatHandler(player->GetSession()).SendSysMessage("You have been removed from the Solo 3v3 queue for being AFK.");
+    }
+}
+
+void Solo3v3::OnPlayerLogin(Player* player)
+{
+    if (!player)
+        return;
+
+    if (sConfigMgr->GetOption<bool>("Solo.3v3.Rated.Enable", true))
+        LoadSoloRating(player);
+
+    ObjectGuid const guid = player->GetGUID();
+    if (!sConfigMgr->GetOption<std::string>("AiPlayerbot.RandomBotAccountPrefix", "rndbot").empty() && !botAccounts.count(guid))
+    {
+        player->GetSession()->GetQueryProcessor().AddCallback(LoginDatabase.AsyncQuery(fmt::format(
+            "SELECT username FROM account WHERE id = {}", player->GetSession()->GetAccountId()))
+            .WithCallback([guid](QueryResult res)
+            {
+                sSolo->SetBotAccountFlag(guid, res ? res->Fetch()[0].Get<std::string>() : std::string());
+            }));
+    }
+
+    if (journalRestores.empty())
+        return;
+
+    auto const restore = journalRestores.find(player->GetGUID());
+    if (restore == journalRestores.end())
+        return;
+
+    // Requeued from Update() like an aborted match, once the player is settled.
+    if (WallClockMs() <= journalRestoreDeadline)
+    {
+        pendingRequeues[player->GetGUID()] = { 0, restore->second };
+        ChatHandler(player->GetSession()).SendSysMessage("The server restarted while you were in the Solo 3v3 queue. Restoring your queue position...");
+    }
+
+    journalRestores.erase(restore);
+}
+
+void Solo3v3::OnPlayerLogout(Player* player)
+{
+    if (!player)
+        return;
+
+    // Logouts caused by a shutdown keep their journal entry for the warm restart.
+    if (sWorld->IsShuttingDown())
+        EraseQueueEntry(player->GetGUID());
+    else
+        ForgetQueueEntry(player->GetGUID());
+
+    pendingRequeues.erase(player->GetGUID());
+    pendingJoins.erase(player->GetGUID());
+    botAccounts.erase(player->GetGUID());
+    ratingCache.Evict(player->GetGUID().GetCounter());
+}
+
+SoloBotFlag Solo3v3::GetBotAccountFlag(ObjectGuid guid) const
+{
+    if (sConfigMgr->GetOption<std::string>("AiPlayerbot.RandomBotAccountPrefix", "rndbot").empty())
+        return SOLO_BOT_NO;
+
+    auto const itr = botAccounts.find(guid);
+    if (itr == botAccounts.end())
+        return SOLO_BOT_UNKNOWN;
+
+    return itr->second ? SOLO_BOT_YES : SOLO_BOT_NO;
+}
+
+void Solo3v3::SetBotAccountFlag(ObjectGuid guid, std::string const& accountName)
+{
+    std::string const botPrefix = sConfigMgr->GetOption<std::string>("AiPlayerbot.RandomBotAccountPrefix", "rndbot");
+    botAccounts[guid] = !botPrefix.empty() && accountName.rfind(botPrefix, 0) == 0; // starts_with
+}
+
+bool Solo3v3::BeginQueueJoin(ObjectGuid guid)
+{
+    return pendingJoins.emplace(guid, std::chrono::steady_clock::now()).second;
+}
+
+void Solo3v3::EndQueueJoin(ObjectGuid guid, bool joined)
+{
+    auto const itr = pendingJoins.find(guid);
+    if (itr == pendingJoins.end())
+        return;
+
+    if (joined)
+    {
+        uint64 const us = uint64(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - itr->second).count());
+        joinLatencyUs.Record(us);
+        LOG_DEBUG("solo3v3", "Solo3v3: {} joined the queue in {} us", guid.ToString(), us);
+    }
+
+    pendingJoins.erase(itr);
+}
+
+void Solo3v3::ForgetQueueEntry(ObjectGuid guid)
+{
+    if (EraseQueueEntry(guid))
+        queueJournal.AppendLeave(guid.GetRawValue());
+}
+
+bool Solo3v3::EraseQueueEntry(ObjectGuid guid)
+{
+    auto const itr = queueEntries.find(guid);
+    if (itr == queueEntries.end())
+        return false;
+
+    AuditQueueEvent(AUDIT_LEAVE, itr->second);
+    CountQueueEntry(itr->second, -1);
+    queueEntries.erase(itr);
+    LeaveReadyCheck(guid);
+    return true;
+}
+
+void Solo3v3::CountQueueEntry(SoloQueueEntry const& entry, int32 delta)
+{
+    if (entry.bracketId >= MAX_BATTLEGROUND_BRACKETS)
+        return;
+
+    uint32* counters = queueCounters[entry.bracketId];
+    counters[entry.role] += delta;
+
+    Solo3v3TalentCat const classCat = GetClassCatForSolo3v3(entry.classId);
+    if (classCat != MAX_TALENT_CAT)
+        counters[classCat] += delta;
+
+    if (entry.role > HEALER)
+        return;
+
+    // Joins mostly land at the back and matches take from the front, so
+    // keeping the join times sorted costs little and GetQueuePosition is a
+    // binary search instead of a scan of every queued player.
+    std::vector<uint32>& joinTimes = queueJoinTimes[entry.bracketId][entry.role];
+    if (delta > 0)
+        joinTimes.insert(std::upper_bound(joinTimes.begin(), joinTimes.end(), entry.joinTime), entry.joinTime);
+    else
+    {
+        auto const itr = std::lower_bound(joinTimes.begin(), joinTimes.end(), entry.joinTime);
+        if (itr != joinTimes.end() && *itr == entry.joinTime)
+            joinTimes.erase(itr);
+    }
+}
+
+uint32 Solo3v3::EstimateQueueWait(BattlegroundBracketId bracketId, Solo3v3TalentCat role, uint32 ahead) const
+{
+    if (bracketId >= MAX_BATTLEGROUND_BRACKETS)
+        return 0;
+
+    uint64 const eta = etaModels[bracketId].EstimateWaitMs(role, ahead, GameTime::GetGameTimeMS().count());
+    return uint32(std::min<uint64>(eta, std::numeric_limits<uint32>::max()));
+}
+
+SoloQueueEntry const* Solo3v3::GetQueueEntry(ObjectGuid guid) const
+{
+    auto const itr = queueEntries.find(guid);
+    return itr != queueEntries.end() ? &itr->second : nullptr;
+}
+
+uint32 Solo3v3::GetQueuePosition(SoloQueueEntry const& entry) const
+{
+    if (entry.bracketId >= MAX_BATTLEGROUND_BRACKETS || entry.role > HEALER)
+        return 0;
+
+    std::vector<uint32> const& joinTimes = queueJoinTimes[entry.bracketId][entry.role];
+    return uint32(std::lower_bound(joinTimes.begin(), joinTimes.end(), entry.joinTime) - joinTimes.begin());
+}
+
+void Solo3v3::RecordQueueMatched(SoloQueueEntry const& entry)
+{
+    if (entry.bracketId >= MAX_BATTLEGROUND_BRACKETS)
+        return;
+
+    uint32 const now    = GameTime::GetGameTimeMS().count();
+    uint32 const waited = now > entry.joinTime ? now - entry.joinTime : 0;
+    etaModels[entry.bracketId].OnMatched(entry.role, now, waited);
+    AuditQueueEvent(AUDIT_MATCHED, entry, waited);
+
+    if (entry.role <= HEALER)
+        metrics.Record(SOLO_METRIC_WAIT_MELEE_S + entry.role, waited / IN_MILLISECONDS);
+}
+
+uint32 Solo3v3::GetQueuedCount(Solo3v3TalentCat cat) const
+{
+    uint32 count = 0;
+    for (uint32 bracketId = 0; bracketId < MAX_BATTLEGROUND_BRACKETS; ++bracketId)
+        count += queueCounters[bracketId][cat];
+
+    return count;
+}
+
+void Solo3v3::JournalJoin(SoloQueueEntry const& entry)
+{
+    if (!queueJournal.IsOpen())
+        return;
+
+    // GameTime restarts with the server, so store the join on the wall clock.
+    uint32 const waited = GameTime::GetGameTimeMS().count() - entry.joinTime;
+
+    SoloJournalEntry record;
+    record.guid       = entry.guid.GetRawValue();
+    record.joinWallMs = WallClockMs() - waited;
+    record.rating     = entry.rating;
+    record.mmr        = entry.mmr;
+    record.role       = uint8(entry.role);
+    record.classId    = entry.classId;
+    record.bracketId  = uint8(entry.bracketId);
+    record.rated      = entry.rated;
+    queueJournal.AppendJoin(record);
+}
+
+void Solo3v3::LoadQueueJournal()
+{
+    if (!sConfigMgr->GetOption<bool>("Solo.3v3.Journal.Enable", false))
+        return;
+
+    std::string const path = sConfigMgr->GetOption<std::string>("Solo.3v3.Journal.Path", "solo3v3_queue.journal");
+    auto const start = std::chrono::steady_clock::now();
+
+    if (!queueJournal.Open(path))
+    {
+        LOG_ERROR("solo3v3", "Solo3v3: cannot open queue journal '{}', warm restart disabled", path);
+        return;
+    }
+
+    uint64 const now    = WallClockMs();
+    uint64 const maxAge = sConfigMgr->GetOption<uint32>("Solo.3v3.Journal.MaxQueueAge", 3600) * uint64(IN_MILLISECONDS);
+    uint32 const gameMs = GameTime::GetGameTimeMS().count();
+    journalRestoreDeadline = now + sConfigMgr->GetOption<uint32>("Solo.3v3.Journal.GraceSeconds", 300) * uint64(IN_MILLISECONDS);
+
+    std::vector<uint64> stale;
+    std::vector<SoloJournalEntry> restored;
+    for (auto const& [rawGuid, record] : queueJournal.Live())
+    {
+        if (record.joinWallMs + maxAge < now || record.bracketId >= MAX_BATTLEGROUND_BRACKETS || record.role >= MAX_TALENT_CAT)
+            stale.push_back(rawGuid);
+        else
+            restored.push_back(record);
+    }
+
+    // Queue time spent before the restart still counts: map the joins onto
+    // the new game clock, keeping their order where it has to clamp.
+    std::vector<uint32> const joinTimes = SoloQueueJournal::GameJoinTimes(restored, now, gameMs);
+    for (std::size_t i = 0; i < restored.size(); ++i)
+    {
+        SoloJournalEntry const& record = restored[i];
+
+        SoloQueueEntry entry;
+        entry.guid      = ObjectGuid(record.guid);
+        entry.role      = Solo3v3TalentCat(record.role);
+        entry.classId   = record.classId;
+        entry.rating    = record.rating;
+        entry.mmr       = record.mmr;
+        entry.joinTime  = joinTimes[i];
+        entry.bracketId = BattlegroundBracketId(record.bracketId);
+        entry.rated     = record.rated;
+        journalRestores[entry.guid] = entry;
+    }
+
+    for (uint64 rawGuid : stale)
+        queueJournal.AppendLeave(rawGuid);
+
+    queueJournal.Compact();
+
+    LOG_INFO("solo3v3", "Solo3v3: queue journal replayed {} entries ({} stale) in {} us",
+        uint32(journalRestores.size()), uint32(stale.size()),
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+}
+
+void Solo3v3::UpdateQueueJournal(uint32 diff)
+{
+    if (!queueJournal.IsOpen())
+        return;
+
+    queueJournal.Flush();
+
+    if (journalCompactTimer > diff)
+    {
+        journalCompactTimer -= diff;
+        return;
+    }
+
+    journalCompactTimer = MINUTE * IN_MILLISECONDS;
+
+    // Nobody claimed these within the grace window.
+    if (!journalRestores.empty() && WallClockMs() > journalRestoreDeadline)
+    {
+        for (auto const& [guid, entry] : journalRestores)
+            queueJournal.AppendLeave(guid.GetRawValue());
+
+        journalRestores.clear();
+    }
+
+    if (queueJournal.ShouldCompact())
+        queueJournal.Compact();
+}
+
+SoloQueueEntry& Solo3v3::TrackQueueEntry(Player* player, GroupQueueInfo* ginfo)
+{
+    SoloQueueEntry& entry = queueEntries[player->GetGUID()];
+
+    // A different JoinTime means the cached entry belongs to an earlier queue
+    // session (the player may have respecced in between).
+    if (entry.guid == player->GetGUID() && entry.joinTime == ginfo->JoinTime)
+        return entry;
+
+    if (entry.guid == player->GetGUID())
+        CountQueueEntry(entry, -1);
+
+    entry           = SoloQueueEntry();
+    entry.guid      = player->GetGUID();
+    entry.role      = GetTalentCatForSolo3v3(player);
+    entry.classId   = player->getClass();
+    entry.rating    = ginfo->ArenaTeamRating;
+    entry.mmr       = GetMMR(player, ginfo);
+    entry.joinTime  = ginfo->JoinTime;
+    entry.bracketId = ginfo->BracketId;
+    entry.rated     = ginfo->IsRated;
+    CountQueueEntry(entry, 1);
+    ScheduleAllDpsPromotion(entry);
+    return entry;
+}
+
+GroupQueueInfo* Solo3v3::AddPlayerToQueue(Player* player, BattlegroundQueueTypeId queueTypeId, PvPDifficultyEntry const* bracketEntry,
+    bool isRated, uint32 arenaRating, uint32 matchmakerRating, SoloQueueEntry const* restore)
+{
+    Battleground* bg = sBattlegroundMgr->GetBattlegroundTemplate(BATTLEGROUND_AA);
+    if (!player || !bg || !bracketEntry)
+        return nullptr;
+
+    uint8 const displayArenaType = 3; // force 3v3 display in client status packet
+    uint8 const queueArenaType   = queueTypeId == bgQueueTypeId ? uint8(ARENA_TYPE_3v3_SOLO) : uint8(ARENA_TYPE_3v3);
+
+    BattlegroundQueue& bgQueue = sBattlegroundMgr->GetBattlegroundQueue(queueTypeId);
+    GroupQueueInfo* ginfo = bgQueue.AddGroup(player, nullptr, BATTLEGROUND_AA, bracketEntry, displayArenaType, isRated, false, arenaRating, matchmakerRating, 0, 0);
+
+    if (restore && restore->joinTime < ginfo->JoinTime)
+    {
+        // Re-insert at the original JoinTime so FIFO selection treats the
+        // player as if they had never left.
+        ginfo->JoinTime = restore->joinTime;
+
+        auto& bucket = bgQueue.m_QueuedGroups[ginfo->BracketId][ginfo->GroupType];
+        bucket.erase(std::find(bucket.begin(), bucket.end(), ginfo));
+
+        auto insertPos = bucket.begin();
+        while (insertPos != bucket.end() && (*insertPos)->JoinTime <= ginfo->JoinTime)
+            ++insertPos;
+
+        bucket.insert(insertPos, ginfo);
+    }
+
+    uint32 avgTime = bgQueue.GetAverageQueueWaitTime(ginfo);
+
+    if (queueTypeId == bgQueueTypeId)
+    {
+        if (restore)
+        {
+            SoloQueueEntry& entry = queueEntries[player->GetGUID()];
+            if (entry.guid == player->GetGUID())
+                CountQueueEntry(entry, -1);
+
+            entry             = *restore;
+            entry.joinTime    = ginfo->JoinTime;
+            entry.team        = TEAM_NEUTRAL;
+            entry.state       = SOLO_STATE_QUEUED;
+            entry.allDpsReady = false;
+            CountQueueEntry(entry, 1);
+            ScheduleAllDpsPromotion(entry);
+            JournalJoin(entry);
+            AuditQueueEvent(AUDIT_JOIN, entry);
+        }
+        else
+        {
+            SoloQueueEntry const& entry = TrackQueueEntry(player, ginfo);
+            QueueEtaModel& eta = etaModels[entry.bracketId];
+            eta.SetHalfLife(sConfigMgr->GetOption<uint32>("Solo.3v3.Eta.HalfLife", 900));
+            eta.OnJoin(entry.role, GameTime::GetGameTimeMS().count());
+            JournalJoin(entry);
+            AuditQueueEvent(AUDIT_JOIN, entry);
+        }
+
+        // The core estimate is role-blind; prefer ours once the bracket has history.
+        SoloQueueEntry const& entry = queueEntries.at(player->GetGUID());
+        uint32 const queued = GetQueuedCount(entry.bracketId, entry.role);
+        if (uint32 const eta = EstimateQueueWait(entry.bracketId, entry.role, queued ? queued - 1 : 0))
+            avgTime = eta;
+    }
+
+    uint32 const waited    = GameTime::GetGameTimeMS().count() - ginfo->JoinTime;
+    uint32 const queueSlot = player->AddBattlegroundQueueId(queueTypeId);
+
+    // send status packet (in queue)
+    WorldPacket data;
+    sBattlegroundMgr->BuildBattlegroundStatusPacket(&data, bg, queueSlot, STATUS_WAIT_QUEUE, avgTime, waited, displayArenaType, TEAM_NEUTRAL, isRated);
+    player->GetSession()->SendPacket(&data);
+
+    if (isRated && matchmakerRating == 0)
+        matchmakerRating = 1;
+
+    sBattlegroundMgr->ScheduleQueueUpdate(matchmakerRating, queueArenaType, queueTypeId, BATTLEGROUND_AA, bracketEntry->GetBracketId());
+    return ginfo;
+}
 
-    // === Phase 1: collect all eligible candidates in queue order (FIFO) ===
-    std::vector<Candidate> allCandidates;
-    for (int t = 0; t < 2; ++t)
-    {
-        int idx = t + (isRated ? 0 : PVP_TEAMS_COUNT);
-        for (auto const& g : queue->m_QueuedGroups[bracket_id][idx])
-        {
-            if (g->IsInvitedToBGInstanceGUID)
-                continue;
+bool Solo3v3::RequeuePlayer(Player* player, SoloQueueEntry const& entry)
+{
+    if (!player || !player->IsInWorld() || !player->HasFreeBattlegroundQueueId() ||
+        player->InBattlegroundQueueForBattlegroundQueueType(bgQueueTypeId))
+        return false;
+
+    Battleground* bg = sBattlegroundMgr->GetBattlegroundTemplate(BATTLEGROUND_AA);
+    if (!bg)
+        return false;
+
+    PvPDifficultyEntry const* bracketEntry = GetBattlegroundBracketById(bg->GetMapId(), entry.bracketId);
+    if (!bracketEntry)
+        return false;
+
+    return AddPlayerToQueue(player, bgQueueTypeId, bracketEntry, entry.rated, entry.rating, entry.mmr, &entry) != nullptr;
+}
+
+void Solo3v3::RecordMatchRoster(Battleground* arena, BattlegroundQueue* queue)
+{
+    if (!arena || !queue)
+        return;
 
-            for (auto const& guid : g->Players)
+    SoloMatch& match = matches[arena->GetInstanceID()];
+    match = SoloMatch();
+    std::vector<SoloQueueEntry>& roster = match.roster;
+
+    for (uint32 i = 0; i < BG_TEAMS_COUNT; ++i)
+        for (GroupQueueInfo* group : queue->m_SelectionPools[TEAM_ALLIANCE + i].SelectedGroups)
+            for (ObjectGuid const& guid : group->Players)
             {
-                Player* plr = ObjectAccessor::FindPlayer(guid);
-                if (!plr)
-                    continue;
+                SoloQueueEntry entry;
+                auto const tracked = queueEntries.find(guid);
+                if (tracked != queueEntries.end())
+                {
+                    entry = tracked->second;
+                    RecordQueueMatched(entry);
+                    ForgetQueueEntry(guid);
+                }
+                else
+                {
+                    entry.guid      = guid;
+                    entry.rating    = group->ArenaTeamRating;
+                    entry.mmr       = group->ArenaMatchmakerRating;
+                    entry.joinTime  = group->JoinTime;
+                    entry.bracketId = group->BracketId;
+                    entry.rated     = group->IsRated;
+                }
 
-                Solo3v3TalentCat role = filterTalents ? GetTalentCatForSolo3v3(plr) : MELEE;
-                allCandidates.push_back({g, plr, role, GetMMR(plr, g), static_cast<uint8>(plr->getClass())});
-                break; // solo queue: exactly one player per group
+                entry.team  = TeamId(TEAM_ALLIANCE + i);
+                entry.state = SOLO_STATE_INVITED;
+                roster.push_back(entry);
             }
-        }
+
+    if (sConfigMgr->GetOption<bool>("Solo.3v3.Trace.Enable", false))
+        StartMatchTrace(match);
+
+    traceSelectUs = traceReadyUs = 0;
+}
+
+void Solo3v3::StartMatchTrace(SoloMatch& match)
+{
+    uint64 const nowUs    = MatchTrace::NowUs();
+    uint32 const nowMs    = GameTime::GetGameTimeMS().count();
+    uint64 const selectUs = traceSelectUs ? traceSelectUs : nowUs;
+
+    MatchTrace& trace = match.trace;
+    trace.Start(nowUs);
+
+    for (SoloQueueEntry const& entry : match.roster)
+    {
+        uint64 const tid      = entry.guid.GetCounter();
+        uint64 const waitedUs = uint64(nowMs > entry.joinTime ? nowMs - entry.joinTime : 0) * 1000;
+        Player* player = ObjectAccessor::FindPlayer(entry.guid);
+        trace.NameThread(tid, player ? player->GetName() : fmt::format("player {}", tid));
+        trace.Span("queued", tid, nowUs > waitedUs ? nowUs - waitedUs : 0, selectUs);
+    }
+
+    trace.NameThread(0, "match");
+    trace.Instant("selected", 0, selectUs);
+    if (traceReadyUs > selectUs)
+        trace.Span("ready_check", 0, selectUs, traceReadyUs);
+    if (traceCreateEndUs >= traceCreateStartUs && traceCreateStartUs >= selectUs)
+        trace.Span("create_arena", 0, traceCreateStartUs, traceCreateEndUs);
+    trace.Instant("invited", 0, nowUs);
+}
+
+void Solo3v3::StartMatchmakingAudit()
+{
+    if (!sConfigMgr->GetOption<bool>("Solo.3v3.Audit.Enable", false))
+        return;
+
+    std::string const path = sConfigMgr->GetOption<std::string>("Solo.3v3.Audit.Path", "solo3v3_audit.bin");
+    uint64 const maxBytes  = uint64(sConfigMgr->GetOption<uint32>("Solo.3v3.Audit.MaxFileSizeMB", 64)) * 1024 * 1024;
+    audit.Start(path, maxBytes, sConfigMgr->GetOption<uint32>("Solo.3v3.Audit.MaxFiles", 5));
+    LOG_INFO("solo3v3", "Solo3v3: matchmaking audit journal enabled, writing to {}", path);
+}
+
+void Solo3v3::StopMatchmakingAudit()
+{
+    if (!audit.IsRunning())
+        return;
+
+    audit.Stop();
+    if (audit.OpenFailed())
+        LOG_ERROR("solo3v3", "Solo3v3: could not open the matchmaking audit journal, nothing was written");
+    else
+        LOG_INFO("solo3v3", "Solo3v3: matchmaking audit journal closed, {} records written, {} dropped",
+            audit.Written(), audit.Dropped());
+}
+
+void Solo3v3::StartShadowMatchmaking()
+{
+    if (!sConfigMgr->GetOption<bool>("Solo.3v3.Shadow.Enable", false))
+        return;
+
+    // The production settings are always evaluated first, as the baseline
+    // the candidate policies are compared against.
+    std::vector<ShadowPolicy> policies;
+    policies.push_back({ "live", ReadMatchmakerConfig(), 0 });
+
+    std::string error;
+    std::string const spec = sConfigMgr->GetOption<std::string>("Solo.3v3.Shadow.Policies", "");
+    if (!ShadowMatchmaking::ParsePolicies(spec, policies.front().config, policies, error))
+    {
+        LOG_ERROR("solo3v3", "Solo3v3: Solo.3v3.Shadow.Policies is invalid ({}), shadow matchmaking disabled", error);
+        return;
+    }
+
+    if (policies.size() == 1)
+    {
+        LOG_ERROR("solo3v3", "Solo3v3: Solo.3v3.Shadow.Policies is empty, shadow matchmaking disabled");
+        return;
+    }
+
+    shadowNextMs.clear();
+    shadowLogged = 0;
+    shadow.Start(policies, sConfigMgr->GetOption<uint32>("Solo.3v3.Shadow.MaxMatches", 100));
+    LOG_INFO("solo3v3", "Solo3v3: shadow matchmaking enabled for {} candidate policies", policies.size() - 1);
+}
+
+void Solo3v3::StopShadowMatchmaking()
+{
+    if (!shadow.IsRunning())
+        return;
+
+    shadow.Stop();
+    LogShadowMatchmaking();
+}
+
+void Solo3v3::SubmitShadowSnapshot(BattlegroundBracketId bracketId, bool isRated)
+{
+    uint32 const now = GameTime::GetGameTimeMS().count();
+    // A bracket seen for the first time is due now, whatever the uptime.
+    auto [itr, inserted] = shadowNextMs.try_emplace(InstancePoolKey(bracketId, isRated), now);
+    uint32& next = itr->second;
+    if (!inserted && int32(now - next) < 0)
+        return;
+
+    next = now + std::max<uint32>(1, sConfigMgr->GetOption<uint32>("Solo.3v3.Shadow.Interval", 5)) * IN_MILLISECONDS;
+
+    std::vector<Candidate> const& candidates = matchScratch.candidates;
+    uint32 const minEntries = ReadMatchmakerConfig().minPlayers * 2;
+    if (candidates.size() < minEntries)
+        return;
+
+    // Copied on the world thread: the evaluation thread must never look at
+    // GroupQueueInfo or Player, which only the world thread may touch.
+    ShadowSnapshot snapshot;
+    snapshot.takenMs = now;
+    snapshot.bracket = bracketId;
+    snapshot.rated   = isRated;
+    std::size_t const count = std::min<std::size_t>(candidates.size(),
+        std::max<uint32>(minEntries, sConfigMgr->GetOption<uint32>("Solo.3v3.Shadow.MaxEntries", 2000)));
+
+    // Candidates come Alliance first, then Horde: keep the oldest of both
+    // rather than cutting off the Horde bucket.
+    uint32      cutoff = std::numeric_limits<uint32>::max();
+    std::size_t ties   = count; //< players joined exactly at cutoff still to take
+    if (count < candidates.size())
+    {
+        std::vector<uint32> joinTimes;
+        joinTimes.reserve(candidates.size());
+        for (Candidate const& candidate : candidates)
+            joinTimes.push_back(QueueBinding::JoinTime(candidate.group));
+
+        std::nth_element(joinTimes.begin(), joinTimes.begin() + (count - 1), joinTimes.end());
+        cutoff = joinTimes[count - 1];
+        ties   = count - std::count_if(joinTimes.begin(), joinTimes.end(), [cutoff](uint32 joinTime) { return joinTime < cutoff; });
+    }
+
+    snapshot.entries.reserve(count);
+    for (Candidate const& candidate : candidates)
+    {
+        uint32 const joinTime = QueueBinding::JoinTime(candidate.group);
+        if (joinTime > cutoff || (joinTime == cutoff && !ties))
+            continue;
+
+        if (joinTime == cutoff)
+            --ties;
+
+        InMemoryQueuedPlayer entry;
+        entry.id          = candidate.id;
+        entry.team        = QueueBinding::Team(candidate.group);
+        entry.role        = candidate.role;
+        entry.mmr         = candidate.mmr;
+        entry.classId     = candidate.classId;
+        entry.joinTime    = joinTime;
+        entry.allDpsReady = candidate.allDpsReady;
+        snapshot.entries.push_back(entry);
+    }
+
+    shadow.Submit(std::move(snapshot));
+}
+
+void Solo3v3::LogShadowMatchmaking()
+{
+    uint64 const evaluated = shadow.Evaluated();
+    if (evaluated == shadowLogged)
+        return;
+
+    shadowLogged = evaluated;
+
+    std::vector<ShadowPolicyStats> stats;
+    shadow.Collect(stats);
+    LOG_INFO("solo3v3", "Solo3v3 shadow: {} snapshots evaluated, {} dropped", evaluated, shadow.Dropped());
+    for (ShadowPolicyStats const& policy : stats)
+    {
+        LOG_INFO("solo3v3", "Solo3v3 shadow {}: {:.2f} matches/snapshot ({} all-DPS), MMR diff p50 {} p90 {}, wait p50 {}s p90 {}s, "
+            "window stops {}, eval p99 {} us",
+            policy.name, policy.snapshots ? double(policy.matches) / policy.snapshots : 0.0, policy.allDpsMatches,
+            policy.mmrDiff.Percentile(50), policy.mmrDiff.Percentile(90), policy.waitSec.Percentile(50),
+            policy.waitSec.Percentile(90), policy.windowStops, policy.evalUs.Percentile(99));
     }
+}
 
-    if (allCandidates.size() < MinPlayers * 2)
+bool Solo3v3::StartSyntheticLoad(SoloLoadSettings const& settings)
+{
+    if (!sConfigMgr->GetOption<bool>("Solo.3v3.LoadTest.Enable", false))
         return false;
 
-    // === Phase 2: select candidates that form a valid match (composition-aware, FIFO) ===
-    std::vector<Candidate> selected;
-    bool allDpsMatch = false;
+    SoloLoadSettings load = settings;
+    load.allDpsTimerMs  = sConfigMgr->GetOption<uint32>("Solo.3v3.FilterTalents.AllDPSTimer", 60) * IN_MILLISECONDS;
+    load.maxQueued      = sConfigMgr->GetOption<uint32>("Solo.3v3.LoadTest.MaxQueued", 50000);
+    load.passesPerTick  = std::max<uint32>(1, sConfigMgr->GetOption<uint32>("Solo.3v3.LoadTest.PassesPerTick", 1));
+    load.initialEntries = std::min(load.initialEntries, load.maxQueued);
+
+    StopSyntheticLoad();
+    syntheticLoad = std::make_unique<SyntheticSoloLoad>(load, ReadMatchmakerConfig());
+    syntheticLoadStartMs = GameTime::GetGameTimeMS().count();
+
+    LOG_INFO("solo3v3", "Solo3v3: synthetic load started on bracket {}: {} queued, {:.1f} joins/min, {:.0f}% healers, MMR {:.0f} +- {:.0f}",
+        load.bracket, load.initialEntries, load.arrivalsPerMinute, load.healerShare * 100, load.mmrMean, load.mmrStdDev);
+    return true;
+}
+
+void Solo3v3::StopSyntheticLoad()
+{
+    if (!syntheticLoad)
+        return;
+
+    SoloLoadStats const& stats = syntheticLoad->Stats();
+    LOG_INFO("solo3v3", "Solo3v3: synthetic load stopped after {} s: {} matches over {} ticks, {} still queued, tick p50 {} us p99 {} us max {} us",
+        stats.elapsedMs / IN_MILLISECONDS, stats.matches, stats.ticks, stats.queued,
+        stats.tickUs.Percentile(50), stats.tickUs.Percentile(99), stats.tickUs.Max());
+    syntheticLoad.reset();
+}
+
+void Solo3v3::UpdateSyntheticLoad()
+{
+    uint64 const elapsedMs = GameTime::GetGameTimeMS().count() - syntheticLoadStartMs;
+    syntheticLoad->Tick(elapsedMs);
+
+    uint32 const maxDuration = sConfigMgr->GetOption<uint32>("Solo.3v3.LoadTest.MaxDuration", 600);
+    if (maxDuration && elapsedMs >= uint64(maxDuration) * IN_MILLISECONDS)
+        StopSyntheticLoad();
+}
+
+void Solo3v3::AuditQueueEvent(MatchmakingAuditType type, SoloQueueEntry const& entry, uint64 value)
+{
+    if (!audit.IsRunning())
+        return;
+
+    MatchmakingAuditRecord record;
+    record.timeMs  = MatchmakingAuditWriter::WallClockMs();
+    record.type    = type;
+    record.guid    = entry.guid.GetRawValue();
+    record.value   = value;
+    record.mmr     = entry.mmr;
+    record.rating  = entry.rating;
+    record.bracket = uint8(entry.bracketId);
+    record.role    = uint8(entry.role);
+    record.classId = entry.classId;
+    record.flags   = entry.rated ? AUDIT_FLAG_RATED : 0;
+    audit.Submit(record);
+}
 
-    if (!filterTalents)
+void Solo3v3::AuditDecision(BattlegroundBracketId bracketId, bool isRated, SoloMatchResult<QueueBinding> const& result,
+    std::vector<MatchmakingAuditRecord>& splits)
+{
+    std::vector<Candidate> const& selected = result.selected;
+
+    MatchmakingAuditRecord base;
+    base.timeMs     = MatchmakingAuditWriter::WallClockMs();
+    base.decisionId = ++auditDecisionId;
+    base.bracket    = uint8(bracketId);
+    base.flags      = (isRated ? AUDIT_FLAG_RATED : 0) | (result.allDpsMatch ? AUDIT_FLAG_ALL_DPS : 0);
+
+    MatchmakingAuditRecord decision = base;
+    decision.type   = AUDIT_DECISION;
+    decision.reason = result.reason;
+    decision.mask   = uint16(std::min<uint32>(result.candidates, UINT16_MAX));
+    decision.value  = selected.size();
+    audit.Submit(decision);
+
+    for (uint32 i = 0; i < selected.size(); ++i)
     {
-        // No role filtering: take the first MinPlayers*2 players
-        selected.assign(allCandidates.begin(), allCandidates.begin() + MinPlayers * 2);
+        Candidate const& candidate = selected[i];
+        MatchmakingAuditRecord record = base;
+        record.type    = AUDIT_SELECTED;
+        record.guid    = candidate.id;
+        record.mmr     = candidate.mmr;
+        record.role    = uint8(candidate.role);
+        record.classId = candidate.classId;
+        record.mask    = uint16(i);
+        audit.Submit(record);
     }
-    else
+
+    uint16 chosenMask = 0;
+    for (uint32 i : result.team1)
+        chosenMask |= uint16(1u << i);
+
+    for (MatchmakingAuditRecord& split : splits)
     {
-        std::vector<Candidate> healers, dps;
-        for (auto& c : allCandidates)
-        {
-            if (c.role == HEALER) healers.push_back(c);
-            else                  dps.push_back(c);
-        }
+        split.timeMs     = base.timeMs;
+        split.decisionId = base.decisionId;
+        split.bracket    = base.bracket;
+        split.flags      = base.flags | (!result.team1.empty() && split.mask == chosenMask ? AUDIT_FLAG_CHOSEN : 0);
+        audit.Submit(split);
+    }
+}
 
-        // For MinPlayers==1 (arena testing) no healer requirement; otherwise 1 healer per team.
-        uint32 const healersNeeded = (MinPlayers > 1) ? 2 : 0;
-        uint32 const dpsNeeded     = MinPlayers * 2 - healersNeeded;
+void Solo3v3::WriteMatchTrace(uint32 instanceId, SoloMatch& match)
+{
+    uint64 const nowUs = MatchTrace::NowUs();
+    match.trace.Instant("destroy", 0, nowUs);
+    match.trace.Span("match", 0, match.trace.StartUs(), nowUs);
 
-        if (healers.size() >= healersNeeded && dps.size() >= dpsNeeded)
+    if (!traceWriter.IsOpen() && !traceOpenFailed)
+    {
+        std::string const path = sConfigMgr->GetOption<std::string>("Solo.3v3.Trace.Path", "solo3v3_trace.json");
+        uint64 const maxBytes  = uint64(sConfigMgr->GetOption<uint32>("Solo.3v3.Trace.MaxFileSizeMB", 16)) * 1024 * 1024;
+        if (!traceWriter.Open(path, maxBytes, sConfigMgr->GetOption<uint32>("Solo.3v3.Trace.MaxFiles", 5)))
         {
-            // Standard: take oldest healers and oldest DPS (FIFO within each role bucket)
-            for (uint32 i = 0; i < healersNeeded; ++i) selected.push_back(healers[i]);
-            for (uint32 i = 0; i < dpsNeeded;     ++i) selected.push_back(dps[i]);
+            LOG_ERROR("solo3v3", "Solo3v3: cannot open match trace file {}, tracing output disabled", path);
+            traceOpenFailed = true;
         }
-        else if (healers.empty())
+    }
+
+    traceWriter.Write(instanceId, fmt::format("solo arena {}", instanceId), match.trace);
+}
+
+void Solo3v3::CloseMatchTraceFile()
+{
+    if (!traceWriter.IsOpen())
+        return;
+
+    traceWriter.Close();
+    LOG_INFO("solo3v3", "Solo3v3: match trace file closed, {} traces written, {} dropped",
+        traceWriter.Written(), traceWriter.Dropped());
+}
+
+Battleground* Solo3v3::GetRosterArena(ObjectGuid guid) const
+{
+    for (auto const& [instanceId, match] : matches)
+        for (SoloQueueEntry const& entry : match.roster)
+            if (entry.guid == guid)
+                return sBattlegroundMgr->GetBattleground(instanceId, BATTLEGROUND_TYPE_NONE);
+
+    return nullptr;
+}
+
+bool Solo3v3::BackfillDodger(Battleground* bg, ObjectGuid dodger, uint32 teamMMR[])
+{
+    if (!bg || bg->GetArenaType() != ARENA_TYPE_3v3_SOLO || bg->GetStatus() != STATUS_WAIT_JOIN)
+        return false;
+
+    if (!sConfigMgr->GetOption<bool>("Solo.3v3.Backfill.Enable", true))
+        return false;
+
+    // The replacement needs time to accept the invite and zone in.
+    if (bg->GetStartDelayTime() < int32(sConfigMgr->GetOption<uint32>("Solo.3v3.Backfill.MinPreparationLeft", 20) * IN_MILLISECONDS))
+        return false;
+
+    auto const matchItr = matches.find(bg->GetInstanceID());
+    if (matchItr == matches.end() || matchItr->second.state >= SOLO_STATE_STARTED)
+        return false;
+
+    std::vector<SoloQueueEntry>& roster = matchItr->second.roster;
+    auto const dodgerItr = std::find_if(roster.begin(), roster.end(),
+        [dodger](SoloQueueEntry const& entry) { return entry.guid == dodger; });
+    if (dodgerItr == roster.end())
+        return false;
+
+    SoloQueueEntry const dodgerEntry = *dodgerItr;
+    TeamId const team = dodgerEntry.team;
+    if (team != TEAM_ALLIANCE && team != TEAM_HORDE)
+        return false;
+
+    SoloMatchmakerConfig const config = ReadMatchmakerConfig();
+    bool   const filterTalents        = config.filterTalents;
+    uint64 const maxMMRDiff           = sConfigMgr->GetOption<uint32>("Solo.3v3.Backfill.MaxMMRDiff", 150);
+
+    // Same split score as the matchmaker: |sum_mmr_team1 - sum_mmr_team2|.
+    // A replacement is accepted within tolerance, or if it does not make the
+    // match less balanced than it was when it popped.
+    int64 sums[BG_TEAMS_COUNT] = { 0, 0 };
+    std::vector<Candidate> teammates;
+    for (SoloQueueEntry const& entry : roster)
+    {
+        sums[entry.team == TEAM_HORDE ? TEAM_HORDE : TEAM_ALLIANCE] += entry.mmr;
+        if (entry.team == team && entry.guid != dodger)
+            teammates.push_back({ nullptr, ObjectAccessor::FindPlayer(entry.guid), entry.guid.GetRawValue(), uint8(filterTalents ? entry.role : MELEE),
+                entry.mmr, entry.classId, false });
+    }
+
+    uint64 const originalDiff = uint64(sums[TEAM_ALLIANCE] > sums[TEAM_HORDE] ? sums[TEAM_ALLIANCE] - sums[TEAM_HORDE] : sums[TEAM_HORDE] - sums[TEAM_ALLIANCE]);
+    uint64 const allowedDiff  = std::max(maxMMRDiff, originalDiff);
+    sums[team] -= dodgerEntry.mmr;
+
+    uint8 const allianceGroupType = dodgerEntry.rated ? BG_QUEUE_PREMADE_ALLIANCE : BG_QUEUE_NORMAL_ALLIANCE;
+    uint8 const hordeGroupType    = dodgerEntry.rated ? BG_QUEUE_PREMADE_HORDE    : BG_QUEUE_NORMAL_HORDE;
+
+    BattlegroundQueue& queue = sBattlegroundMgr->GetBattlegroundQueue(bgQueueTypeId);
+    QueueBinding binding{ *this, queue };
+
+    // Oldest compatible candidate across both faction buckets.
+    GroupQueueInfo* best = nullptr;
+    Player* bestPlayer = nullptr;
+    for (uint8 groupType : { allianceGroupType, hordeGroupType })
+    {
+        for (GroupQueueInfo* g : queue.m_QueuedGroups[dodgerEntry.bracketId][groupType])
         {
-            // All-DPS fallback: only include DPS players whose wait timer has elapsed
-            std::vector<Candidate> timedDps;
-            for (auto& c : dps)
-                if (c.group->JoinTime + allDpsTimerMs <= now)
-                    timedDps.push_back(c);
+            if (best && g->JoinTime >= best->JoinTime)
+                break; // buckets are kept in JoinTime order
+
+            if (g->IsInvitedToBGInstanceGUID || g->IsRated != dodgerEntry.rated || g->Players.empty())
+                continue;
+
+            ObjectGuid const guid = *g->Players.begin();
+            if (IsHeldByReadyCheck(guid))
+                continue;
+
+            Player* plr = ObjectAccessor::FindPlayer(guid);
+            if (!plr)
+                continue;
+
+            SoloQueueEntry const& entry = TrackQueueEntry(plr, g);
+            Solo3v3TalentCat const role = filterTalents ? entry.role : MELEE;
+            if (!entry.available || (filterTalents && role != dodgerEntry.role))
+                continue;
+
+            int64 const newSum = sums[team] + entry.mmr;
+            int64 const otherSum = sums[team == TEAM_ALLIANCE ? TEAM_HORDE : TEAM_ALLIANCE];
+            if (uint64(newSum > otherSum ? newSum - otherSum : otherSum - newSum) > allowedDiff)
+                continue;
+
+            std::vector<Candidate> newTeam = teammates;
+            newTeam.push_back({ g, plr, guid.GetRawValue(), uint8(role), entry.mmr, entry.classId, entry.allDpsReady });
 
-            if (timedDps.size() >= MinPlayers * 2)
+            if (config.preventClassStacking > 0)
             {
-                for (uint32 i = 0; i < MinPlayers * 2; ++i)
-                    selected.push_back(timedDps[i]);
-                allDpsMatch = true;
+                std::vector<uint32> indices;
+                for (uint32 i = 0; i < newTeam.size(); ++i)
+                    indices.push_back(i);
+
+                if (SoloMatchmaker<QueueBinding>::HasClassStackingConflict(indices, newTeam, config.preventClassStacking, config.classStackMask))
+                    continue;
+            }
+
+            if (config.avoidIgnore)
+            {
+                bool ignored = false;
+                for (Candidate const& mate : teammates)
+                    if (mate.player && binding.Ignores(plr, mate.player))
+                        ignored = true;
+
+                if (ignored)
+                    continue;
             }
+
+            best = g;
+            bestPlayer = plr;
+            break;
         }
-        // 1 healer present: unbalanced composition, cannot form a valid match — fall through.
     }
 
-    if (selected.size() < MinPlayers * 2)
+    if (!best)
+    {
+        LOG_DEBUG("solo3v3", "Solo3v3: no backfill candidate for {} in arena {}", dodger.ToString(), bg->GetInstanceID());
+        return false;
+    }
+
+    ArenaTeam* arenaTeam = sArenaTeamMgr->GetArenaTeamById(bg->GetArenaTeamIdForTeam(team));
+    if (!arenaTeam)
         return false;
 
-    // === Phase 3: exhaustive search for the MMR-balanced team split ===
-    // For 6 players / teamSize=3: C(6,3)=20 combinations — negligible overhead.
-    // Primary:   minimise |sum_mmr_team1 - sum_mmr_team2|
-    // Secondary: minimise mutual-ignore pairs within teams (avoidIgnore tie-breaker)
-    uint32 const n        = static_cast<uint32>(selected.size());
-    uint32 const teamSize = MinPlayers;
+    SoloMatchmaker<QueueBinding>(binding, config).MoveGroupToTeam(best, dodgerEntry.bracketId, team, allianceGroupType, hordeGroupType);
+    best->ArenaTeamId = arenaTeam->GetId();
+    queue.InviteGroupToBG(best, bg, team);
 
-    std::vector<uint32> bestTeam1;
-    bool     haveBest   = false;
-    uint64   bestDiff   = 0;
-    int      bestIgnores = 0;
+    // Hand the dodger's temp team slot to the replacement without touching the DB.
+    for (ArenaTeamMember& member : arenaTeam->GetMembers())
+    {
+        if (member.Guid != dodger)
+            continue;
 
-    std::vector<uint32> combo(teamSize);
-    EnumerateCombinations(0, 0, combo, selected, teamSize, n, filterTalents, allDpsMatch, avoidIgnore, preventClassStacking, classStackMask, bestTeam1, haveBest, bestDiff, bestIgnores);
+        member.Guid             = bestPlayer->GetGUID();
+        member.Name             = bestPlayer->GetName();
+        member.Class            = bestPlayer->getClass();
+        member.PersonalRating   = best->ArenaTeamRating;
+        member.MatchMakerRating = best->ArenaMatchmakerRating;
+        break;
+    }
 
-    if (!haveBest)
-        return false;
+    auto const tracked = queueEntries.find(bestPlayer->GetGUID());
+    SoloQueueEntry replacement = tracked != queueEntries.end() ? tracked->second : SoloQueueEntry();
+    replacement.guid = bestPlayer->GetGUID();
+    if (tracked != queueEntries.end())
+        RecordQueueMatched(replacement);
 
-    // Build team2 as complement of bestTeam1
-    std::vector<uint32> team2Indices;
+    ForgetQueueEntry(bestPlayer->GetGUID());
+    replacement.team  = team;
+    replacement.state = SOLO_STATE_INVITED;
+    *dodgerItr = replacement;
+
+    MatchTrace& trace = matchItr->second.trace;
+    if (trace.Active())
+    {
+        uint64 const tid = bestPlayer->GetGUID().GetCounter();
+        trace.NameThread(tid, bestPlayer->GetName());
+        trace.Instant("backfill", tid, MatchTrace::NowUs());
+        trace.Instant("dodged", dodgerEntry.guid.GetCounter(), MatchTrace::NowUs());
+    }
+
+    for (uint32 i = 0; i < BG_TEAMS_COUNT; ++i)
     {
-        uint32 ci = 0;
-        for (uint32 i = 0; i < n; ++i)
+        uint64 total = 0;
+        uint32 count = 0;
+        for (SoloQueueEntry const& entry : roster)
         {
-            if (ci < static_cast<uint32>(bestTeam1.size()) && bestTeam1[ci] == i) { ++ci; continue; }
-            team2Indices.push_back(i);
+            if (entry.team != TeamId(TEAM_ALLIANCE + i))
+                continue;
+
+            total += entry.mmr ? entry.mmr : 1500;
+            ++count;
         }
+
+        teamMMR[i] = count ? uint32(total / count) : 1500;
+    }
+
+    ChatHandler(bestPlayer->GetSession()).SendSysMessage("A spot opened up in a Solo 3v3 match that is about to start. Enter the arena to take it!");
+    LOG_INFO("solo3v3", "Solo3v3: backfilled {} with {} in arena {}", dodger.ToString(), bestPlayer->GetGUID().ToString(), bg->GetInstanceID());
+    return true;
+}
+
+uint32 Solo3v3::GetMMR(Player* player, GroupQueueInfo* ginfo)
+{
+    if (ginfo->ArenaMatchmakerRating > 0)
+        return ginfo->ArenaMatchmakerRating;
+
+    ArenaTeam* at = sArenaTeamMgr->GetArenaTeamById(player->GetArenaTeamId(ARENA_SLOT_SOLO_3v3));
+    if (!at)
+        return sConfigMgr->GetOption<uint32>("Arena.ArenaStartPersonalRating", 0);
+
+    for (auto const& m : at->GetMembers())
+        if (m.Guid == player->GetGUID())
+            return m.MatchMakerRating > 0 ? m.MatchMakerRating : at->GetRating();
+
+    return at->GetRating();
+}
+
+// SoloMatchmaker numbers buckets, teams and roles like the core and the
+// no-match metrics like the audit reasons.
+static_assert(SOLO_BUCKET_PREMADE_ALLIANCE == BG_QUEUE_PREMADE_ALLIANCE && SOLO_BUCKET_PREMADE_HORDE == BG_QUEUE_PREMADE_HORDE &&
+    SOLO_BUCKET_NORMAL_ALLIANCE == BG_QUEUE_NORMAL_ALLIANCE && SOLO_BUCKET_NORMAL_HORDE == BG_QUEUE_NORMAL_HORDE, "bucket mismatch");
+static_assert(SOLO_TEAM_ALLIANCE == TEAM_ALLIANCE && SOLO_TEAM_HORDE == TEAM_HORDE, "team mismatch");
+static_assert(SOLO_ROLE_MELEE == MELEE && SOLO_ROLE_RANGE == RANGE && SOLO_ROLE_HEALER == HEALER, "role mismatch");
+static_assert(SOLO_METRIC_NO_MATCH_NO_SPLIT - SOLO_METRIC_NO_MATCH_TOO_FEW == AUDIT_REASON_NO_SPLIT - AUDIT_REASON_TOO_FEW, "reason mismatch");
+
+bool Solo3v3::QueueBinding::Describe(GroupQueueInfo* group, Candidate& candidate)
+{
+    if (group->IsInvitedToBGInstanceGUID)
+        return false;
+
+    // Held by a pending ready check; not available until it resolves.
+    if (!group->Players.empty() && solo.IsHeldByReadyCheck(*group->Players.begin()))
+        return false;
+
+    for (auto const& guid : group->Players)
+    {
+        Player* plr = ObjectAccessor::FindPlayer(guid);
+        if (!plr)
+            continue;
+
+        SoloQueueEntry const& entry = solo.TrackQueueEntry(plr, group);
+        if (!entry.available)
+            return false;
+
+        candidate.player      = plr;
+        candidate.id          = guid.GetRawValue();
+        candidate.role        = uint8(entry.role);
+        candidate.mmr         = entry.mmr;
+        candidate.classId     = entry.classId;
+        candidate.allDpsReady = entry.allDpsReady;
+        return true; // solo queue: exactly one player per group
     }
+    return false;
+}
+
+bool Solo3v3::QueueBinding::Ignores(Player* a, Player* b) const
+{
+    return a->GetSocial()->HasIgnore(b->GetGUID()) || b->GetSocial()->HasIgnore(a->GetGUID());
+}
+
+void Solo3v3::QueueBinding::SetTeam(GroupQueueInfo* group, uint8 team, uint8 bucket)
+{
+    group->teamId    = TeamId(team);
+    group->GroupType = bucket;
+}
+
+void Solo3v3::QueueBinding::ResetPools()
+{
+    queue.m_SelectionPools[TEAM_ALLIANCE].Init();
+    queue.m_SelectionPools[TEAM_HORDE].Init();
+}
 
-    // === Phase 4: assign to selection pools, reclassifying faction bucket if needed ===
-    AssignToPool(bestTeam1,    selected, TEAM_ALLIANCE, queue, bracket_id, allianceGroupType, hordeGroupType, MinPlayers);
-    AssignToPool(team2Indices, selected, TEAM_HORDE,    queue, bracket_id, allianceGroupType, hordeGroupType, MinPlayers);
+SoloMatchmakerConfig Solo3v3::ReadMatchmakerConfig()
+{
+    SoloMatchmakerConfig config;
+    config.minPlayers           = sBattlegroundMgr->isArenaTesting() ? 1 : 3;
+    config.filterTalents        = sConfigMgr->GetOption<bool>("Solo.3v3.FilterTalents", false);
+    config.avoidIgnore          = sConfigMgr->GetOption<bool>("Solo.3v3.AvoidSameTeamIgnore", true);
+    config.preventClassStacking = sConfigMgr->GetOption<uint8>("Solo.3v3.PreventClassStacking", 0);
+    config.classStackMask       = sConfigMgr->GetOption<uint32>("Solo.3v3.PreventClassStacking.Classes", 0);
+    return config;
+}
+
+bool Solo3v3::CheckSolo3v3Arena(BattlegroundQueue* queue, BattlegroundBracketId bracket_id, bool isRated)
+{
+    SoloMetricTimer checkTimer(metrics, SOLO_METRIC_CHECK_US);
+    metrics.Add(SOLO_METRIC_CHECKS);
+
+    bool const auditing = audit.IsRunning();
+    std::vector<MatchmakingAuditRecord> auditSplits;
+
+    QueueBinding binding{ *this, *queue };
+    SoloMatchmaker<QueueBinding> matchmaker(binding, ReadMatchmakerConfig(), &matchScratch);
+    SoloMatchResult<QueueBinding>& result = matchResult;
+    bool const matched = matchmaker.Check(bracket_id, isRated, result, auditing ? &auditSplits : nullptr);
+
+    // Phases: collect, select, then split and pool assignment.
+    SoloMetricHistogram const phaseMetrics[] = { SOLO_METRIC_PHASE_COLLECT_US, SOLO_METRIC_PHASE_SELECT_US, SOLO_METRIC_PHASE_SPLIT_US };
+    for (uint32 i = 0; i < result.phases; ++i)
+        metrics.Record(phaseMetrics[i], result.phaseUs[i]);
+    metrics.Record(SOLO_METRIC_CANDIDATES, result.candidates);
 
+    if (auditing)
+        AuditDecision(bracket_id, isRated, result, auditSplits);
+
+    if (shadow.IsRunning())
+        SubmitShadowSnapshot(bracket_id, isRated);
+
+    if (!matched)
+    {
+        metrics.Add(SoloMetricCounter(SOLO_METRIC_NO_MATCH_TOO_FEW + (result.reason - AUDIT_REASON_TOO_FEW)));
+        return false;
+    }
+
+    metrics.Add(SOLO_METRIC_MATCHES_FORMED);
+    traceSelectUs = MatchTrace::NowUs();
+    traceReadyUs  = 0;
     return true;
 }
 
@@ -798,12 +2640,29 @@ bool Solo3v3::Arena3v3CheckTalents(Player* player)
     return true;
 }
 
+Solo3v3TalentCat Solo3v3::GetClassCatForSolo3v3(uint8 classId)
+{
+    switch (classId)
+    {
+        case CLASS_WARRIOR:      return WARRIOR;
+        case CLASS_PALADIN:      return PALADIN;
+        case CLASS_DEATH_KNIGHT: return DK;
+        case CLASS_HUNTER:       return HUNTER;
+        case CLASS_SHAMAN:       return SHAMAN;
+        case CLASS_ROGUE:        return ROGUE;
+        case CLASS_DRUID:        return DRUID;
+        case CLASS_MAGE:         return MAGE;
+        case CLASS_WARLOCK:      return WARLOCK;
+        case CLASS_PRIEST:       return PRIEST;
+        default:                 return MAX_TALENT_CAT;
+    }
+}
+
 Solo3v3TalentCat Solo3v3::GetTalentCatForSolo3v3(Player* player)
 {
-    uint32 count[MAX_TALENT_CAT];
+    static SoloTalentClassifier const classifier(SOLO_3V3_TALENTS_MELEE, SOLO_3V3_TALENTS_RANGE, SOLO_3V3_TALENTS_HEAL);
 
-    for (int i = 0; i < MAX_TALENT_CAT; i++)
-        count[i] = 0;
+    uint32 count[SoloTalentClassifier::ROLES] = { };
 
     for (uint32 talentId = 0; talentId < sTalentStore.GetNumRows(); ++talentId)
     {
@@ -812,42 +2671,23 @@ Solo3v3TalentCat Solo3v3::GetTalentCatForSolo3v3(Player* player)
         if (!talentInfo)
             continue;
 
+        // Tabs outside the solo lists never count; skip their HasTalent lookups.
+        int8 const role = classifier.RoleOf(talentInfo->TalentTab);
+        if (role == SoloTalentClassifier::NONE)
+            continue;
+
         for (int8 rank = MAX_TALENT_RANK - 1; rank >= 0; --rank)
         {
             if (talentInfo->RankID[rank] == 0)
                 continue;
 
             if (player->HasTalent(talentInfo->RankID[rank], player->GetActiveSpec()))
-            {
-                for (int8 i = 0; SOLO_3V3_TALENTS_MELEE[i] != 0; i++)
-                    if (SOLO_3V3_TALENTS_MELEE[i] == talentInfo->TalentTab)
-                        count[MELEE] += rank + 1;
-
-                for (int8 i = 0; SOLO_3V3_TALENTS_RANGE[i] != 0; i++)
-                    if (SOLO_3V3_TALENTS_RANGE[i] == talentInfo->TalentTab)
-                        count[RANGE] += rank + 1;
-
-                for (int8 i = 0; SOLO_3V3_TALENTS_HEAL[i] != 0; i++)
-                    if (SOLO_3V3_TALENTS_HEAL[i] == talentInfo->TalentTab)
-                        count[HEALER] += rank + 1;
-            }
-        }
-    }
-
-    uint32 prevCount = 0;
-
-    Solo3v3TalentCat talCat = MELEE; // Default MELEE (if no talent points set)
-
-    for (int i = 0; i < MAX_TALENT_CAT; i++)
-    {
-        if (count[i] > prevCount)
-        {
-            talCat = (Solo3v3TalentCat)i;
-            prevCount = count[i];
+                count[role] += rank + 1;
         }
     }
 
-    return talCat;
+    // Default MELEE (if no talent points set)
+    return Solo3v3TalentCat(SoloTalentClassifier::Pick(count));
 }
 
 Solo3v3TalentCat Solo3v3::GetFirstAvailableSlot(bool soloTeam[][MAX_TALENT_CAT]) {
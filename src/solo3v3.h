@@ -22,6 +22,26 @@
 #include "ArenaTeamMgr.h"
 #include "BattlegroundMgr.h"
 #include "Player.h"
+#include <chrono>
+#include <functional>
+#include <memory>
+#include "LatencyHistogram.h"
+#include "MatchmakingAudit.h"
+#include "MatchTrace.h"
+#include "MetricsRegistry.h"
+#include "QueueEtaModel.h"
+#include "ShadowMatchmaking.h"
+#include "SoloLadderStorage.h"
+#include "SoloLadderWriteBehind.h"
+#include "SoloRatingCache.h"
+#include "SoloMatchmaker.h"
+#include "SoloQueueJournal.h"
+#include "SyntheticSoloLoad.h"
+#include "TalentClassifier.h"
+#include "TimerWheel.h"
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 // Custom 1v1 Arena Rated
 constexpr uint32 BATTLEGROUND_QUEUE_1v1 = 11;
@@ -112,23 +132,221 @@ enum Solo3v3TalentCat
 
 #define BG_TEAMS_COUNT 2
 
+// PlayerGossip menu shared by the battlemaster service and the ready-check prompt
+constexpr uint32 SOLO_3V3_GOSSIP_MENU_ID            = 91011;
+constexpr uint32 SOLO_3V3_GOSSIP_SENDER_READY_CHECK = 101;
+
+struct Solo3v3InstancePoolStats
+{
+    uint32 idle     = 0;
+    uint32 brackets = 0;
+    uint64 hits     = 0;
+    uint64 misses   = 0;
+    uint64 created  = 0;
+    LatencyHistogram createLatencyUs; //< CreateNewBattleground wall time
+};
+
+enum Solo3v3AdmissionVerdict
+{
+    SOLO_ADMIT = 0,
+    SOLO_THROTTLE_INSTANCES,   //< Solo.3v3.Admission.MaxInstances reached
+    SOLO_THROTTLE_TICK,        //< Solo.3v3.Admission.MaxCreatesPerTick reached
+    SOLO_THROTTLE_LOAD,        //< average world update time above Solo.3v3.Admission.MaxUpdateTime
+    MAX_SOLO_ADMISSION_VERDICT
+};
+
+enum SoloBotFlag : uint8
+{
+    SOLO_BOT_UNKNOWN = 0, //< login lookup still in flight
+    SOLO_BOT_NO,
+    SOLO_BOT_YES
+};
+
+struct Solo3v3AdmissionStats
+{
+    uint32 activeArenas = 0;
+    uint32 heldMatches  = 0;
+    uint32 updateTime   = 0; //< average world update time (ms)
+    uint64 verdicts[MAX_SOLO_ADMISSION_VERDICT] = { };
+};
+
+// ---------------- Metrics (.qsolo metrics) ----------------
+enum SoloMetricCounter : uint32
+{
+    SOLO_METRIC_CHECKS = 0,              //< CheckSolo3v3Arena calls
+    SOLO_METRIC_MATCHES_FORMED,
+    SOLO_METRIC_NO_MATCH_TOO_FEW,        //< fewer than 6 available players
+    SOLO_METRIC_NO_MATCH_ONE_HEALER,     //< a single healer cannot be split
+    SOLO_METRIC_NO_MATCH_ALL_DPS_WAIT,   //< no healer, AllDPS timers still running
+    SOLO_METRIC_NO_MATCH_ROLE_SHORTAGE,  //< healers present, not enough DPS
+    SOLO_METRIC_NO_MATCH_NO_SPLIT,       //< class stacking / ignore rules leave no valid split
+    SOLO_METRIC_LADDER_MATCHES,          //< rated matches whose results were applied to the ladder
+    SOLO_METRIC_LADDER_UPDATES,          //< ladder changes: match results and penalties
+    SOLO_METRIC_LADDER_STATEMENTS,       //< write statements sent to the ladder database
+    SOLO_METRIC_LADDER_FLUSHES,          //< write-behind batches
+    MAX_SOLO_METRIC_COUNTER
+};
+
+enum SoloMetricHistogram : uint32
+{
+    SOLO_METRIC_CHECK_US = 0,            //< whole CheckSolo3v3Arena
+    SOLO_METRIC_PHASE_COLLECT_US,
+    SOLO_METRIC_PHASE_SELECT_US,
+    SOLO_METRIC_PHASE_SPLIT_US,
+    SOLO_METRIC_CANDIDATES,              //< available candidates per check
+    SOLO_METRIC_WAIT_MELEE_S,            //< queue wait at pop, per role
+    SOLO_METRIC_WAIT_RANGE_S,
+    SOLO_METRIC_WAIT_HEALER_S,
+    SOLO_METRIC_DB_LOAD_US,              //< synchronous ladder row load
+    SOLO_METRIC_DB_LOAD_ASYNC_US,        //< async ladder row load, query to callback
+    SOLO_METRIC_DB_UPDATE_US,            //< ladder update (enqueue)
+    SOLO_METRIC_DB_CHECK_US,             //< ladder storage availability check
+    SOLO_METRIC_DB_CREATE_US,            //< default ladder row creation (enqueue)
+    SOLO_METRIC_DB_FLUSH_US,             //< write-behind batch (enqueue)
+    SOLO_METRIC_DB_FLUSH_ROWS,           //< players per write-behind batch
+    MAX_SOLO_METRIC_HISTOGRAM
+};
+
+const char* const SOLO_METRIC_COUNTER_NAMES[MAX_SOLO_METRIC_COUNTER] =
+{
+    "checks", "matches", "nomatch.too_few", "nomatch.one_healer", "nomatch.all_dps_wait",
+    "nomatch.role_shortage", "nomatch.no_split", "ladder.matches", "ladder.updates", "ladder.statements",
+    "ladder.flushes"
+};
+
+const char* const SOLO_METRIC_HISTOGRAM_NAMES[MAX_SOLO_METRIC_HISTOGRAM] =
+{
+    "check_us", "phase.collect_us", "phase.select_us", "phase.split_us", "candidates",
+    "wait.melee_s", "wait.range_s", "wait.healer_s", "db.load_us", "db.load_async_us", "db.update_us",
+    "db.check_us", "db.create_us", "db.flush_us", "db.flush_rows"
+};
+
+using SoloMetrics = MetricsRegistry<MAX_SOLO_METRIC_COUNTER, MAX_SOLO_METRIC_HISTOGRAM>;
+using SoloMetricTimer = ScopedMetricTimer<SoloMetrics>;
+
+struct Solo3v3BroadcastStats
+{
+    uint64 rounds      = 0; //< queue snapshots taken
+    uint64 sent        = 0; //< position messages delivered
+    uint64 dropped     = 0; //< players gone before their message went out
+    uint32 pending     = 0; //< messages of the current round still to send
+    uint32 lastBuildUs = 0; //< cost of the last snapshot
+};
+
+// Lifecycle of a solo match, and of each player in it.
+enum SoloMatchState : uint8
+{
+    SOLO_STATE_QUEUED = 0, //< waiting in the queue
+    SOLO_STATE_SELECTED,   //< picked for a match held by a ready check or admission control
+    SOLO_STATE_INVITED,    //< arena created and invite sent
+    SOLO_STATE_ENTERED,    //< inside the arena, preparation running
+    SOLO_STATE_STARTED,    //< gates opened
+    SOLO_STATE_ENDED       //< match finished or aborted, or the player left it
+};
+
+// Module-side view of a solo queue entry. Role and class are resolved once at
+// join (talents are locked while queued, see Solo3v3Spell) and the whole entry
+// is kept with the match roster so aborted matches can requeue it unchanged.
+struct SoloQueueEntry
+{
+    ObjectGuid            guid;
+    Solo3v3TalentCat      role      = MELEE;
+    uint8                 classId   = 0;
+    uint32                rating    = 0;
+    uint32                mmr       = 0;
+    uint32                joinTime  = 0; //< GroupQueueInfo::JoinTime (GameTime ms)
+    BattlegroundBracketId bracketId = BG_BRACKET_ID_FIRST;
+    bool                  rated     = false;
+    TeamId                team      = TEAM_NEUTRAL; //< Team in the match, once selected
+    bool                  available = true;         //< Last liveness verdict; unavailable entries are not selected
+    uint32                afkSince  = 0;            //< GameTime ms the player was first seen AFK while queued
+    bool                  allDpsReady = false;      //< Waited Solo.3v3.FilterTalents.AllDPSTimer, may join an all-DPS match
+    SoloMatchState        state     = SOLO_STATE_QUEUED;
+};
+
 class Solo3v3
 {
 public:
     static Solo3v3* instance();
 
+    // Called once per world tick (see Solo3v3World).
+    void Update(uint32 diff);
+
     // ---------------- Solo rated ladder (separate from ArenaTeam) ----------------
-    // Returns the player's Solo 3v3 rating/MMR from Characters DB table
-    // `character_solo3v3_rating` (creates a default row if missing).
+    // Returns the player's Solo 3v3 rating/MMR from the rating cache. Rows are
+    // loaded from the ladder storage (Characters DB table
+    // `character_solo3v3_rating` unless Solo.3v3.Rated.Storage says otherwise)
+    // asynchronously at login, creating a default row if missing, and dropped
+    // at logout; false while the row is not loaded.
     bool IsRatedEnabled();
     bool GetSoloRatingAndMMR(Player* player, uint32& rating, uint32& mmr);
     bool GetSoloStats(Player* player, uint32& rating, uint32& mmr, uint32& games, uint32& wins, uint32& losses);
     void UpdateSoloLadderAfterMatch(Player* player, bool isWin, bool isDraw, uint32 ownTeamMMR, uint32 opponentTeamMMR);
     void ApplySoloLadderPenalty(Player* player, uint32 ratingLoss);
+    // GetSoloRatingAndMMR for the queue-join path that also works before the
+    // login load returned: @p callback runs at once from the cache, or on the
+    // world thread from Update() after its own load, even if the player logged
+    // out in between; the default row is created when missing.
+    void GetSoloRatingAndMMRAsync(Player* player, std::function<void(uint32 rating, uint32 mmr)>&& callback);
+    // Every call is timed into the db.* metrics. SetLadderStorage swaps the
+    // backend, e.g. for a benchmark; pending async loads of the old one are lost.
+    SoloLadderStorage& GetLadderStorage();
+    void SetLadderStorage(std::unique_ptr<SoloLadderStorage> backend);
+    // Writes the ladder changes held back by Solo.3v3.Rated.WriteBehind now.
+    void FlushSoloLadder();
+    SoloRatingCache const& GetRatingCache() const { return ratingCache; }
 
     uint32 GetAverageMMR(ArenaTeam* team);
     void CheckStartSolo3v3Arena(Battleground* bg);
     void CleanUp3v3SoloQ(Battleground* bg);
+
+    // Adds the player to @p queueTypeId and sends the queue status packet.
+    // Solo queue joins are tracked as SoloQueueEntry; passing @p restore
+    // re-inserts a previous entry with its original JoinTime and cached role/MMR.
+    GroupQueueInfo* AddPlayerToQueue(Player* player, BattlegroundQueueTypeId queueTypeId, PvPDifficultyEntry const* bracketEntry,
+        bool isRated, uint32 arenaRating, uint32 matchmakerRating, SoloQueueEntry const* restore = nullptr);
+    // Join requests waiting for their async lookups. BeginQueueJoin returns
+    // false while one is already in flight; EndQueueJoin records the end to
+    // end join latency when @p joined. A logout drops the pending request.
+    bool BeginQueueJoin(ObjectGuid guid);
+    bool IsQueueJoinPending(ObjectGuid guid) const { return pendingJoins.count(guid) != 0; }
+    void EndQueueJoin(ObjectGuid guid, bool joined);
+    LatencyHistogram const& GetJoinLatency() const { return joinLatencyUs; }
+
+    // Whether the character's account is a random bot account
+    // (AiPlayerbot.RandomBotAccountPrefix). Looked up once per character at
+    // login and kept until its logout, so several characters online on one
+    // account do not drop each other's entry; rated joins only read it.
+    SoloBotFlag GetBotAccountFlag(ObjectGuid guid) const;
+    void SetBotAccountFlag(ObjectGuid guid, std::string const& accountName);
+    // Snapshots the filled selection pools as the roster of @p arena.
+    void RecordMatchRoster(Battleground* arena, BattlegroundQueue* queue);
+    // Ends an arena that cannot be played as incomplete. Everyone still in the
+    // arena except @p culprit is requeued at their old position once they leave.
+    void AbortIncompleteMatch(Battleground* bg, Player* culprit);
+    // Replaces @p dodger in a solo arena that is still in preparation with the
+    // oldest compatible queued player of the same role, inviting them into the
+    // same instance and temp arena team. On success @p teamMMR receives the new
+    // average MMR of both teams.
+    bool BackfillDodger(Battleground* bg, ObjectGuid dodger, uint32 teamMMR[]);
+    // Returns the arena whose match roster contains @p guid, if it still exists.
+    Battleground* GetRosterArena(ObjectGuid guid) const;
+    // ---------------- Match lifecycle ----------------
+    // Event entry points of the per-match / per-player state machine. Timed
+    // transitions (AllDPS promotion, ready-check expiry) run from Update().
+    void OnPlayerEnteredArena(Battleground* bg, Player* player);
+    void OnArenaEnded(Battleground* bg);
+
+    // Called when a player leaves an arena; performs any pending priority requeue.
+    void OnPlayerLeftArena(Battleground* bg, Player* player);
+    void OnPlayerLogin(Player* player);
+    void OnPlayerLogout(Player* player);
+
+    // ---------------- Queue journal ----------------
+    // Replays the on-disk solo queue journal (Solo.3v3.Journal.*). Players
+    // found in it get their queue position back if they log in within the
+    // grace window.
+    void LoadQueueJournal();
     bool CheckSolo3v3Arena(BattlegroundQueue* queue, BattlegroundBracketId bracket_id, bool isRated);
     void CreateTempArenaTeamForQueue(BattlegroundQueue* queue, ArenaTeam* arenaTeams[]);
     void CountAsLoss(Player* player, bool isInProgress);
@@ -139,6 +357,21 @@ public:
     // Returns MELEE, RANGE or HEALER (depends on talent builds)
     Solo3v3TalentCat GetTalentCatForSolo3v3(Player* player);
     Solo3v3TalentCat GetFirstAvailableSlot(bool soloTeam[][MAX_TALENT_CAT]);
+    // Returns the class column (MAGE .. WARRIOR) of the queue display, MAX_TALENT_CAT if none
+    static Solo3v3TalentCat GetClassCatForSolo3v3(uint8 classId);
+
+    // Players waiting in the solo queue (not yet invited), by role and by
+    // class column. Kept up to date on join, leave and invite.
+    uint32 GetQueuedCount(BattlegroundBracketId bracketId, Solo3v3TalentCat cat) const { return queueCounters[bracketId][cat]; }
+    uint32 GetQueuedCount(Solo3v3TalentCat cat) const;
+
+    // Expected wait in ms for a player of @p role with @p ahead same-role
+    // players queued before them; 0 while the bracket has no history yet.
+    uint32 EstimateQueueWait(BattlegroundBracketId bracketId, Solo3v3TalentCat role, uint32 ahead) const;
+    QueueEtaModel const& GetEtaModel(BattlegroundBracketId bracketId) const { return etaModels[bracketId]; }
+    SoloQueueEntry const* GetQueueEntry(ObjectGuid guid) const;
+    // Same-role players in the same bracket that joined before @p entry
+    uint32 GetQueuePosition(SoloQueueEntry const& entry) const;
 
     // Returns true if candidate has an ignore relationship with any player already in the given team's selection pool
     bool HasIgnoreConflict(Player* candidate, BattlegroundQueue* queue, uint32 teamId);
@@ -148,61 +381,272 @@ public:
     // Must be called while bg->isRated() is still true, i.e. before SetRated(false).
     void SaveIncompleteMatchLogs(Battleground* bg);
 
+    // ---------------- Pre-created arena instance pool ----------------
+    // Returns an idle pre-created arena for the bracket, or creates one on a
+    // pool miss. The caller owns starting it (StartBattleground). Only the
+    // Battleground object is pooled: its map is still created when the first
+    // player is teleported in. Idle instances are not registered with the
+    // BattlegroundMgr; a claimed one is registered before it is returned.
+    Battleground* ClaimArenaInstance(BattlegroundTypeId bgTypeId, PvPDifficultyEntry const* bracketEntry, uint8 arenaType, bool isRated);
+    void GetInstancePoolStats(Solo3v3InstancePoolStats& stats) const;
+    // Frees every idle pooled arena (used on shutdown).
+    void ReleaseInstancePool();
+
+    // ---------------- Ready check ----------------
+    // When enabled, a formed match is held and its players are prompted to
+    // accept before any arena or temp team is created.
+    bool IsReadyCheckEnabled();
+    // Captures the filled selection pools as a pending match and prompts its players.
+    void BeginReadyCheck(BattlegroundQueue* queue, BattlegroundBracketId bracket_id, bool isRated);
+    // Refills the selection pools from a fully accepted ready check of this
+    // bracket. Returns true when the pools hold a match ready to be created.
+    bool PopAcceptedReadyCheck(BattlegroundQueue* queue, BattlegroundBracketId bracket_id, bool isRated);
+    void RespondToReadyCheck(Player* player, bool accept);
+    bool IsHeldByReadyCheck(ObjectGuid guid) const;
+    bool HasAcceptedReadyCheck(ObjectGuid guid) const;
+
+    // ---------------- Admission control ----------------
+    // Decides whether a formed match may create its arena now. Counts the
+    // verdict and, on admission, the creation against this tick's budget.
+    Solo3v3AdmissionVerdict AdmitNewArena();
+    // Parks the filled selection pools as an already accepted match that is
+    // created once admission allows it (see PopAcceptedReadyCheck).
+    void HoldMatchForAdmission(BattlegroundQueue* queue, BattlegroundBracketId bracket_id, bool isRated);
+    void GetAdmissionStats(Solo3v3AdmissionStats& stats) const;
+
+    Solo3v3BroadcastStats const& GetBroadcastStats() const { return broadcastStats; }
+
+    SoloMetrics& GetMetrics() { return metrics; }
+
+    // Match lifecycle traces (Solo.3v3.Trace.*), written off the world thread
+    void CloseMatchTraceFile();
+
+    // Binary matchmaking event journal (Solo.3v3.Audit.*), written off the world thread
+    void StartMatchmakingAudit();
+    void StopMatchmakingAudit();
+    MatchmakingAuditWriter const& GetMatchmakingAudit() const { return audit; }
+
+    // Shadow evaluation of candidate policies (Solo.3v3.Shadow.*) on queue
+    // snapshots, matched off the world thread without touching the real queue
+    void StartShadowMatchmaking();
+    void StopShadowMatchmaking();
+    ShadowMatchmaking const& GetShadowMatchmaking() const { return shadow; }
+
+    // GM synthetic load (.qsolo load): in-memory entries matched by the real
+    // matchmaking pass, never reaching the core queue. False if disabled.
+    bool StartSyntheticLoad(SoloLoadSettings const& settings);
+    void StopSyntheticLoad();
+    SyntheticSoloLoad const* GetSyntheticLoad() const { return syntheticLoad.get(); }
+
+    // Removes the player from the solo queue and clears the client queue slot.
+    void RemoveFromSoloQueue(Player* player);
+
 private:
-    struct Candidate
+    struct ReadyCheck
+    {
+        BattlegroundBracketId          bracketId  = BG_BRACKET_ID_FIRST;
+        bool                           rated      = false;
+        uint64                         expireTime = 0; //< GameTime ms, 64-bit so it does not wrap
+        std::vector<ObjectGuid>        team[BG_TEAMS_COUNT];
+        std::unordered_set<ObjectGuid> accepted;
+        bool                           admissionHold = false; //< accepted match waiting for admission
+        uint64                         selectedUs    = 0;     //< MatchTrace clock, when the match was formed
+
+        uint32 Size() const { return uint32(team[TEAM_ALLIANCE].size() + team[TEAM_HORDE].size()); }
+    };
+
+    Solo3v3AdmissionVerdict CheckAdmission() const;
+    void UpdateAdmission();
+    // Ends a ready check: @p decliners leave the queue (optionally penalised),
+    // everyone else keeps their original queue position.
+    void FailReadyCheck(uint32 checkId, std::unordered_set<ObjectGuid> const& decliners, bool penalize);
+    // Ends the ready check of a player who left the solo queue during it,
+    // without penalising them; the rest keep their queue position.
+    void LeaveReadyCheck(ObjectGuid guid);
+    static void ScheduleSoloQueueUpdate(BattlegroundBracketId bracketId, bool isRated);
+
+    struct InstancePool
+    {
+        BattlegroundTypeId         bgTypeId     = BATTLEGROUND_AA;
+        PvPDifficultyEntry const*  bracketEntry = nullptr;
+        uint8                      arenaType    = 0;
+        bool                       rated        = false;
+        std::vector<Battleground*> idle;
+    };
+
+    Battleground* CreateArenaInstance(InstancePool const& pool);
+    static void ReleaseArenaInstance(Battleground* arena);
+    void UpdateInstancePool(uint32 diff);
+
+    // SoloMatchmaker binding over the core's BattlegroundQueue buckets and
+    // selection pools; players come from ObjectAccessor and the queue entries.
+    struct QueueBinding
     {
-        GroupQueueInfo*  group;
-        Player*          player;
-        Solo3v3TalentCat role;
-        uint32           mmr;
-        uint8            classId; //< player->GetClass() cached at queue time
+        using GroupHandle  = GroupQueueInfo*;
+        using PlayerHandle = Player*;
+        using Bucket       = BattlegroundQueue::GroupsQueueType;
+
+        Solo3v3&           solo;
+        BattlegroundQueue& queue;
+
+        Bucket& Queued(uint32 bracket, uint8 bucket) { return queue.m_QueuedGroups[bracket][bucket]; }
+        bool Describe(GroupQueueInfo* group, SoloCandidate<QueueBinding>& candidate);
+        bool Ignores(Player* a, Player* b) const;
+        static uint32 JoinTime(GroupQueueInfo* group) { return group->JoinTime; }
+        static uint8 Team(GroupQueueInfo* group) { return uint8(group->teamId); }
+        static void SetTeam(GroupQueueInfo* group, uint8 team, uint8 bucket);
+        void ResetPools();
+        void AddToPool(uint8 team, GroupQueueInfo* group, uint32 minPlayers) { queue.m_SelectionPools[team].AddGroup(group, minPlayers); }
     };
 
+    using Candidate = SoloCandidate<QueueBinding>;
+
+    // Solo.3v3.* matchmaking options for SoloMatchmaker.
+    static SoloMatchmakerConfig ReadMatchmakerConfig();
+
     uint32 GetMMR(Player* player, GroupQueueInfo* ginfo);
 
-    int CountIgnorePairs(std::vector<uint32> const& indices, std::vector<Candidate> const& selected, bool avoidIgnore);
-
-    // Returns true when the team at @p indices contains two players of the
-    // same class that violate the configured stacking level and class mask.
-    bool HasClassStackingConflict(
-        std::vector<uint32> const& indices,
-        std::vector<Candidate> const& selected,
-        uint8 preventLevel,
-        uint32 classMask) const;
-
-    // Converts a WoW class ID (1–11) to its bit position for the
-    // Solo.3v3.PreventClassStacking.Classes bitmask.
-    // Mirrors 1<<(classId-1) for classes 1-9; Druid (11) maps to bit 10.
-    static uint32 ClassIdToMaskBit(uint8 classId);
-
-    void EnumerateCombinations(
-        uint32 start,
-        uint32 depth,
-        std::vector<uint32>& combo,
-        std::vector<Candidate> const& selected,
-        uint32 teamSize,
-        uint32 n,
-        bool filterTalents,
-        bool allDpsMatch,
-        bool avoidIgnore,
-        uint8 preventClassStacking,
-        uint32 classStackMask,
-        std::vector<uint32>& bestTeam1,
-        bool& haveBest,
-        uint64& bestDiff,
-        int& bestIgnores);
-
-    void AssignToPool(
-        std::vector<uint32> const& indices,
-        std::vector<Candidate> const& selected,
-        uint32 poolTeam,
-        BattlegroundQueue* queue,
-        BattlegroundBracketId bracket_id,
-        uint8 allianceGroupType,
-        uint8 hordeGroupType,
-        uint32 MinPlayers);
-
-    std::unordered_set<uint32> arenasWithDeserter;
+    struct SoloMatch
+    {
+        SoloMatchState              state       = SOLO_STATE_INVITED;
+        bool                        hasDeserter = false; //< first in-progress leaver already penalised
+        std::vector<SoloQueueEntry> roster;
+        MatchTrace                  trace;               //< inactive unless Solo.3v3.Trace.Enable
+    };
+
+    enum SoloTimerType : uint8
+    {
+        SOLO_TIMER_ALL_DPS = 0, //< promote a DPS entry to all-DPS eligible
+        SOLO_TIMER_READY_CHECK  //< ready check deadline
+    };
+
+    struct SoloTimer
+    {
+        SoloTimerType type;
+        ObjectGuid    guid;
+        uint32        id; //< ready check id, or JoinTime of the queue entry
+    };
+
+    void SetMatchState(uint32 instanceId, SoloMatch& match, SoloMatchState state);
+    void SetEntryState(ObjectGuid guid, SoloMatchState state);
+    void ScheduleAllDpsPromotion(SoloQueueEntry const& entry);
+    void OnTimer(SoloTimer const& timer);
+
+    SoloQueueEntry& TrackQueueEntry(Player* player, GroupQueueInfo* ginfo);
+    bool RequeuePlayer(Player* player, SoloQueueEntry const& entry);
+    void UpdatePendingRequeues();
+    // Drops a queue entry that left the solo queue, journaling the leave.
+    void ForgetQueueEntry(ObjectGuid guid);
+    bool EraseQueueEntry(ObjectGuid guid);
+    void CountQueueEntry(SoloQueueEntry const& entry, int32 delta);
+    void RecordQueueMatched(SoloQueueEntry const& entry);
+    void JournalJoin(SoloQueueEntry const& entry);
+    void UpdateQueueJournal(uint32 diff);
+    // Marks queued players who are unlikely to accept a pop (AFK, in combat,
+    // dead, in an instance) as unavailable and evicts long-term AFKs.
+    void UpdateQueueLiveness(uint32 diff);
+    // Sends queued players their role position and wait estimate every
+    // Solo.3v3.Broadcast.Interval, at most Solo.3v3.Broadcast.MaxPerTick a tick.
+    void UpdateQueueBroadcast(uint32 diff);
+    // Logs counter deltas and hot path percentiles every Solo.3v3.Metrics.LogInterval.
+    void UpdateMetricsLog(uint32 diff);
+    void LogShadowMatchmaking();
+    void UpdateSyntheticLoad();
+
+    // Match lifecycle tracing (Chrome trace-event JSON)
+    void StartMatchTrace(SoloMatch& match);
+
+    void AuditQueueEvent(MatchmakingAuditType type, SoloQueueEntry const& entry, uint64 value = 0);
+    void AuditDecision(BattlegroundBracketId bracketId, bool isRated, SoloMatchResult<QueueBinding> const& result,
+        std::vector<MatchmakingAuditRecord>& splits);
+    void SubmitShadowSnapshot(BattlegroundBracketId bracketId, bool isRated);
+    void LoadSoloRating(Player* player);
+    SoloLadderRow const* FindSoloRow(Player* player);
+    // Writes @p update to the ladder storage and the cached row.
+    void ApplySoloLadderUpdate(Player* player, SoloLadderUpdate const& update);
+    void WriteMatchTrace(uint32 instanceId, SoloMatch& match);
+
+    struct PendingRequeue
+    {
+        uint32         instanceId = 0; //< 0 once the player has left the arena
+        SoloQueueEntry entry;
+    };
+
+    std::unordered_map<ObjectGuid, SoloQueueEntry>          queueEntries;
+    uint32                                                  queueCounters[MAX_BATTLEGROUND_BRACKETS][MAX_TALENT_CAT] = { };
+    std::vector<uint32>                                     queueJoinTimes[MAX_BATTLEGROUND_BRACKETS][HEALER + 1]; //< sorted, per role
+    QueueEtaModel                                           etaModels[MAX_BATTLEGROUND_BRACKETS];
+    std::unordered_map<uint32, SoloMatch>                   matches; //< by arena instance id
+    std::unordered_map<ObjectGuid, PendingRequeue>          pendingRequeues;
+    uint32                                                  livenessTimer = 0;
+
+    struct QueueBroadcast
+    {
+        ObjectGuid guid;
+        uint32     position = 0; //< 1-based, among same-role players of the bracket
+        uint32     queued   = 0; //< same-role players of the bracket
+        uint32     eta      = 0; //< remaining ms, 0 if unknown
+    };
+
+    std::vector<QueueBroadcast>                             broadcastRound;
+    size_t                                                  broadcastCursor = 0;
+    uint32                                                  broadcastTimer  = 0;
+    Solo3v3BroadcastStats                                   broadcastStats;
+
+    SoloMetrics                                             metrics;
+
+    // Stage times of the match being formed, in MatchTrace::NowUs() time
+    uint64                                                  traceSelectUs      = 0;
+    uint64                                                  traceReadyUs       = 0;
+    uint64                                                  traceCreateStartUs = 0;
+    uint64                                                  traceCreateEndUs   = 0;
+    ChromeTraceWriter                                       traceWriter;
+    bool                                                    traceOpenFailed    = false;
+
+    MatchmakingAuditWriter                                  audit;
+    uint32                                                  auditDecisionId = 0;
+
+    SoloMatchmaker<QueueBinding>::Scratch                   matchScratch; //< reused by every CheckSolo3v3Arena
+    SoloMatchResult<QueueBinding>                           matchResult;
+    ShadowMatchmaking                                       shadow;
+    std::unique_ptr<SoloLadderStorage>                      ladderBackend;
+    std::unique_ptr<WriteBehindSoloLadderStorage>           ladderWriteBehind; //< wraps ladderBackend, if enabled
+    std::unique_ptr<TimedSoloLadderStorage>                 ladderStorage; //< wraps ladderWriteBehind or ladderBackend
+    SoloRatingCache                                         ratingCache;
+    std::unordered_map<uint32, uint32>                      shadowNextMs; //< by InstancePoolKey, GameTime ms
+    uint64                                                  shadowLogged = 0; //< snapshots evaluated at the last log
+    std::unique_ptr<SyntheticSoloLoad>                      syntheticLoad;
+    uint64                                                  syntheticLoadStartMs = 0; //< GameTime ms
+    uint64                                                  metricsLogged[MAX_SOLO_METRIC_COUNTER] = { };
+    uint32                                                  metricsLogTimer = 0;
+    TimerWheel<SoloTimer>                                   timers;
+
+    SoloQueueJournal                                        queueJournal;
+    std::unordered_map<ObjectGuid, SoloQueueEntry>          journalRestores; //< awaiting login after a restart
+    uint64                                                  journalRestoreDeadline = 0; //< wall clock ms
+    uint32                                                  journalCompactTimer    = 0;
+
+    std::unordered_map<ObjectGuid, std::chrono::steady_clock::time_point> pendingJoins;
+    LatencyHistogram                                                       joinLatencyUs;
+
+    std::unordered_map<ObjectGuid, bool> botAccounts; //< by character, for the players online
+
+    // Keyed by (bracket << 1 | rated); a bracket gets a pool once it first pops.
+    std::unordered_map<uint32, InstancePool> instancePools;
+    uint32           instancePoolRefillTimer = 0;
+    uint64           instancePoolHits        = 0;
+    uint64           instancePoolMisses      = 0;
+    uint64           instancePoolCreated     = 0;
+    LatencyHistogram instancePoolCreateLatencyUs;
+
+    uint32 admissionCreatesThisTick = 0;
+    uint64 admissionVerdicts[MAX_SOLO_ADMISSION_VERDICT] = { };
+    uint64 admissionLogNextMs = 0; //< GameTime ms; next rejection logged at info level
+    uint32 admissionThrottled = 0; //< rejections since the last one logged at info level
+
+    std::unordered_map<uint32, ReadyCheck> readyChecks;
+    std::unordered_map<ObjectGuid, uint32> readyCheckByPlayer;
+    uint32                                 nextReadyCheckId = 1;
 };
 
 #define sSolo Solo3v3::instance()
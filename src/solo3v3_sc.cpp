@@ -18,7 +18,9 @@
 #include "solo3v3_sc.h"
 #include "PlayerGossip.h"
 #include "PlayerGossipMgr.h"
-#include "AccountMgr.h"
+#include "DatabaseEnv.h"
+#include "GameTime.h"
+#include "WorldSession.h"
 #include <unordered_map>
 #include <unordered_set>
 
@@ -35,14 +37,6 @@ static std::unordered_map<uint32, SoloMatchContext> g_soloMatchContexts;
 static constexpr uint32 RTG_SCOREBOARD_MENU_ID = 10000;
 static constexpr uint32 RTG_SCOREBOARD_EVENTS_SENDER = 90;
 
-void NpcSolo3v3::Initialize()
-{
-    for (int i = 0; i < MAX_TALENT_CAT; i++)
-        cache3v3Queue[i] = 0;
-
-    lastFetchQueueList = 0;
-}
-
 bool NpcSolo3v3::OnGossipHello(Player* player, Creature* creature)
 {
     if (!player)
@@ -54,7 +48,39 @@ bool NpcSolo3v3::OnGossipHello(Player* player, Creature* creature)
         return true;
     }
 
-    fetchQueueList();
+    if (sSolo->IsHeldByReadyCheck(player->GetGUID()))
+    {
+        SendReadyCheckMenu(player, creature);
+        return true;
+    }
+
+    // Counters are maintained by Solo3v3 on join / leave / invite; no queue scan here.
+    uint32 cache3v3Queue[MAX_TALENT_CAT];
+    for (int i = 0; i < MAX_TALENT_CAT; i++)
+        cache3v3Queue[i] = sSolo->GetQueuedCount(Solo3v3TalentCat(i));
+
+    uint32 bracketQueued = 0;
+    uint32 eta = 0;
+    if (Battleground* bgTemplate = sBattlegroundMgr->GetBattlegroundTemplate(BATTLEGROUND_AA))
+    {
+        if (PvPDifficultyEntry const* bracketEntry = GetBattlegroundBracketByLevel(bgTemplate->GetMapId(), player->GetLevel()))
+        {
+            for (Solo3v3TalentCat role : { MELEE, RANGE, HEALER })
+                bracketQueued += sSolo->GetQueuedCount(bracketEntry->GetBracketId(), role);
+
+            if (SoloQueueEntry const* entry = sSolo->GetQueueEntry(player->GetGUID()))
+            {
+                uint32 const waited = GameTime::GetGameTimeMS().count() - entry->joinTime;
+                uint32 const total  = sSolo->EstimateQueueWait(entry->bracketId, entry->role, sSolo->GetQueuePosition(*entry));
+                eta = total > waited ? total - waited : (total ? IN_MILLISECONDS : 0);
+            }
+            else
+            {
+                Solo3v3TalentCat const role = sSolo->GetTalentCatForSolo3v3(player);
+                eta = sSolo->EstimateQueueWait(bracketEntry->GetBracketId(), role, sSolo->GetQueuedCount(bracketEntry->GetBracketId(), role));
+            }
+        }
+    }
 
     if (!creature)
         AddGossipItemFor(player, GOSSIP_ICON_TALK,
@@ -65,6 +91,9 @@ bool NpcSolo3v3::OnGossipHello(Player* player, Creature* creature)
 
     infoQueue << " ---------------------------------------------";
     infoQueue << "\n               " << (cache3v3Queue[MELEE] + cache3v3Queue[RANGE] + cache3v3Queue[HEALER]) << " Queued Player(s)";
+    infoQueue << "\n               " << bracketQueued << " in your bracket";
+    if (eta)
+        infoQueue << "\n          Estimated wait (your role): " << eta / MINUTE / IN_MILLISECONDS << "m " << eta / IN_MILLISECONDS % MINUTE << "s";
     infoQueue << "\n                 |TInterface/ICONS/ability_rogue_shadowstrikes:21:21:0:11|t       |TInterface/ICONS/spell_shadow_shadowembrace:21:21:0:11|t        |TInterface/ICONS/spell_holy_holynova:21:21:0:11|t";
     infoQueue << "\n\n              Melee  Caster  Healer";
     infoQueue << "\n                 [" << cache3v3Queue[MELEE] << "]        [" << cache3v3Queue[RANGE] << "]        [" << cache3v3Queue[HEALER] << "]";
@@ -176,11 +205,14 @@ bool NpcSolo3v3::OnGossipSelect(Player* player, Creature* creature, uint32 /*sen
     // Show SoloQ ladder stats from the separate ladder table (no ArenaTeam required).
     uint32 rating = 0;
     uint32 mmr = 0;
-    Solo3v3::instance()->GetSoloRatingAndMMR(player, rating, mmr);
-
     std::stringstream s;
-    s << "Solo 3v3 Rating: " << rating;
-    s << "\nSolo 3v3 MMR: " << mmr;
+    if (Solo3v3::instance()->GetSoloRatingAndMMR(player, rating, mmr))
+    {
+        s << "Solo 3v3 Rating: " << rating;
+        s << "\nSolo 3v3 MMR: " << mmr;
+    }
+    else
+        s << "Solo 3v3 statistics are not available yet, try again in a moment.";
 
     ChatHandler(player->GetSession()).PSendSysMessage("{}", s.str().c_str());
     CloseGossipMenuFor(player);
@@ -205,6 +237,14 @@ bool NpcSolo3v3::OnGossipSelect(Player* player, Creature* creature, uint32 /*sen
         }
         break;
 
+        case NPC_3v3_ACTION_READY_CHECK_ACCEPT:
+        case NPC_3v3_ACTION_READY_CHECK_DECLINE:
+        {
+            sSolo->RespondToReadyCheck(player, action == NPC_3v3_ACTION_READY_CHECK_ACCEPT);
+            CloseGossipMenuFor(player);
+            return true;
+        }
+
         case NPC_3v3_ACTION_MAIN_MENU:
         {
             OnGossipHello(player, creature);
@@ -228,6 +268,22 @@ bool NpcSolo3v3::OnGossipSelect(Player* player, Creature* creature, uint32 /*sen
     return true;
 }
 
+void NpcSolo3v3::SendReadyCheckMenu(Player* player, Creature* creature)
+{
+    if (!player)
+        return;
+
+    if (!sSolo->HasAcceptedReadyCheck(player->GetGUID()))
+    {
+        AddGossipItemFor(player, GOSSIP_ICON_BATTLE, "|TInterface/ICONS/Achievement_Arena_3v3_5:30:30:-18:0|t Accept Solo 3v3 match", GOSSIP_SENDER_MAIN, NPC_3v3_ACTION_READY_CHECK_ACCEPT);
+        AddGossipItemFor(player, GOSSIP_ICON_INTERACT_1, "|TInterface/ICONS/Achievement_Arena_2v2_7:30:30:-18:0|t Decline and leave the queue", GOSSIP_SENDER_MAIN, NPC_3v3_ACTION_READY_CHECK_DECLINE, "Declining removes you from the queue. Are you sure?", 0, false);
+    }
+    else
+        AddGossipItemFor(player, GOSSIP_ICON_CHAT, "Accepted. Waiting for the other players...", GOSSIP_SENDER_MAIN, NPC_3v3_ACTION_MAIN_MENU);
+
+    SendGossipMenuFor(player, DEFAULT_GOSSIP_MESSAGE, creature ? creature->GetGUID() : player->GetGUID());
+}
+
 bool NpcSolo3v3::ArenaCheckFullEquipAndTalents(Player* player)
 {
     if (!player)
@@ -264,109 +320,171 @@ bool NpcSolo3v3::ArenaCheckFullEquipAndTalents(Player* player)
     return true;
 }
 
-bool NpcSolo3v3::JoinQueueArena(Player* player, Creature* /*creature*/, bool isRated)
+namespace
 {
-    if (!player)
-        return false;
+    // Queue preconditions, checked when a join is requested and again when its
+    // async lookups complete (the player may have queued elsewhere meanwhile).
+    bool CanJoinQueueArena(Player* player, bool isRated, BattlegroundQueueTypeId& queueTypeId, PvPDifficultyEntry const*& bracketEntry)
+    {
+        // RTG note: keep default MinLevel low so level-locked realms (like 19) work out of the box.
+        if (sConfigMgr->GetOption<uint32>("Solo.3v3.MinLevel", 19) > player->GetLevel())
+            return false;
 
-    // RTG note: keep default MinLevel low so level-locked realms (like 19) work out of the box.
-    if (sConfigMgr->GetOption<uint32>("Solo.3v3.MinLevel", 19) > player->GetLevel())
-        return false;
+        // Rated: require the standalone schema.
+        if (isRated && !sSolo->IsRatedEnabled())
+            return false;
 
-    // Rated: require the standalone schema and block playerbots / rndbot accounts.
-    if (isRated)
-    {
-        if (!sSolo->IsRatedEnabled())
+        // Unrated should use the normal 3v3 skirmish bucket so it can pop with standard 3v3 queuers (incl. bots).
+        // Rated keeps using the Solo queue bucket/layering used by this module.
+        queueTypeId = isRated ? bgQueueTypeId : (BattlegroundQueueTypeId)BATTLEGROUND_QUEUE_3v3;
+
+        // ignore if we already in BG, Arena or any arena queue
+        if (player->InBattleground() || player->InArena() ||
+            player->InBattlegroundQueueForBattlegroundQueueType((BattlegroundQueueTypeId)BATTLEGROUND_QUEUE_2v2) ||
+            player->InBattlegroundQueueForBattlegroundQueueType((BattlegroundQueueTypeId)BATTLEGROUND_QUEUE_3v3) ||
+            player->InBattlegroundQueueForBattlegroundQueueType((BattlegroundQueueTypeId)BATTLEGROUND_QUEUE_5v5) ||
+            player->InBattlegroundQueueForBattlegroundQueueType((BattlegroundQueueTypeId)BATTLEGROUND_QUEUE_3v3_SOLO) ||
+            player->InBattlegroundQueueForBattlegroundQueueType((BattlegroundQueueTypeId)BATTLEGROUND_QUEUE_1v1))
             return false;
 
-        std::string botPrefix = sConfigMgr->GetOption<std::string>("AiPlayerbot.RandomBotAccountPrefix", "rndbot");
-        if (!botPrefix.empty())
+        //check existance
+        Battleground* bg = sBattlegroundMgr->GetBattlegroundTemplate(BATTLEGROUND_AA);
+
+        if (!bg)
         {
-            std::string accName;
-            if (AccountMgr::GetName(player->GetSession()->GetAccountId(), accName))
-            {
-                if (accName.rfind(botPrefix, 0) == 0) // starts_with
-                    return false;
-            }
+            LOG_ERROR("module", "Battleground: template bg (all arenas) not found");
+            return false;
         }
-    }
 
-    uint8 displayArenaType = 3; // force 3v3 display in client status packet
-    uint32 arenaRating = 0;
-    uint32 matchmakerRating = 0;
-
-    // Unrated should use the normal 3v3 skirmish bucket so it can pop with standard 3v3 queuers (incl. bots).
-    // Rated keeps using the Solo queue bucket/layering used by this module.
-    BattlegroundQueueTypeId queueTypeId = isRated ? bgQueueTypeId : (BattlegroundQueueTypeId)BATTLEGROUND_QUEUE_3v3;
-    uint8 queueArenaType = isRated ? uint8(ARENA_TYPE_3v3_SOLO) : uint8(ARENA_TYPE_3v3);
-
-    // ignore if we already in BG, Arena or any arena queue
-    if (player->InBattleground() || player->InArena() ||
-        player->InBattlegroundQueueForBattlegroundQueueType((BattlegroundQueueTypeId)BATTLEGROUND_QUEUE_2v2) ||
-        player->InBattlegroundQueueForBattlegroundQueueType((BattlegroundQueueTypeId)BATTLEGROUND_QUEUE_3v3) ||
-        player->InBattlegroundQueueForBattlegroundQueueType((BattlegroundQueueTypeId)BATTLEGROUND_QUEUE_5v5) ||
-        player->InBattlegroundQueueForBattlegroundQueueType((BattlegroundQueueTypeId)BATTLEGROUND_QUEUE_3v3_SOLO) ||
-        player->InBattlegroundQueueForBattlegroundQueueType((BattlegroundQueueTypeId)BATTLEGROUND_QUEUE_1v1))
-        return false;
+        if (DisableMgr::IsDisabledFor(DISABLE_TYPE_BATTLEGROUND, BATTLEGROUND_AA, nullptr))
+        {
+            ChatHandler(player->GetSession()).PSendSysMessage(LANG_ARENA_DISABLED);
+            return false;
+        }
 
-    //check existance
-    Battleground* bg = sBattlegroundMgr->GetBattlegroundTemplate(BATTLEGROUND_AA);
+        bracketEntry = GetBattlegroundBracketByLevel(bg->GetMapId(), player->GetLevel());
+        if (!bracketEntry)
+            return false;
 
-    if (!bg)
-    {
-        LOG_ERROR("module", "Battleground: template bg (all arenas) not found");
-        return false;
+        // Only reject when the player is already in this exact queue.
+        // GetBattlegroundQueueIndex returns PLAYER_MAX_BATTLEGROUND_QUEUES when the queue is not present,
+        // so the old "< PLAYER_MAX_BATTLEGROUND_QUEUES" check inverted the meaning and blocked fresh joins.
+        if (player->GetBattlegroundQueueIndex(queueTypeId) >= PLAYER_MAX_BATTLEGROUND_QUEUES && !player->HasFreeBattlegroundQueueId())
+            return false;
+
+        return true;
     }
 
-    if (DisableMgr::IsDisabledFor(DISABLE_TYPE_BATTLEGROUND, BATTLEGROUND_AA, nullptr))
+    // Completion stage of JoinQueueArena, run once the async lookups are back.
+    // Tells the player how the join ended.
+    void CompleteJoinQueueArena(ObjectGuid guid, bool isRated, uint32 arenaRating, uint32 matchmakerRating)
     {
-        ChatHandler(player->GetSession()).PSendSysMessage(LANG_ARENA_DISABLED);
-        return false;
+        // Async loads finish even after a logout; a request that was dropped
+        // meanwhile must not queue the player after a relog.
+        if (!sSolo->IsQueueJoinPending(guid))
+            return;
+
+        Player* player = ObjectAccessor::FindPlayer(guid);
+        if (!player)
+        {
+            sSolo->EndQueueJoin(guid, false);
+            return;
+        }
+
+        BattlegroundQueueTypeId queueTypeId;
+        PvPDifficultyEntry const* bracketEntry = nullptr;
+        if (!CanJoinQueueArena(player, isRated, queueTypeId, bracketEntry))
+        {
+            sSolo->EndQueueJoin(guid, false);
+            ChatHandler(player->GetSession()).SendSysMessage("Something went wrong while joining queue. Already in another queue?");
+            return;
+        }
+
+        Battleground* bg = sBattlegroundMgr->GetBattlegroundTemplate(BATTLEGROUND_AA);
+        bg->SetRated(isRated);
+        bg->SetMinPlayersPerTeam(3);
+
+        bool const joined = sSolo->AddPlayerToQueue(player, queueTypeId, bracketEntry, isRated, arenaRating, matchmakerRating) != nullptr;
+        sSolo->EndQueueJoin(guid, joined);
+
+        if (!joined)
+        {
+            ChatHandler(player->GetSession()).SendSysMessage("Something went wrong while joining queue. Already in another queue?");
+            return;
+        }
+
+        ChatHandler(player->GetSession()).PSendSysMessage("You have joined the solo 3v3 arena queue {}.", isRated ? "rated" : "unrated");
+        sScriptMgr->OnPlayerJoinArena(player);
     }
+}
 
-    PvPDifficultyEntry const* bracketEntry = GetBattlegroundBracketByLevel(bg->GetMapId(), player->GetLevel());
-    if (!bracketEntry)
+// Request stage: validates, then finishes in CompleteJoinQueueArena once the
+// rated ladder row is loaded, which reports the outcome to the player.
+// Returns false only when the request is rejected up front; true means the
+// join was requested, not that it succeeded.
+bool NpcSolo3v3::JoinQueueArena(Player* player, Creature* /*creature*/, bool isRated)
+{
+    if (!player)
         return false;
 
-    // Only reject when the player is already in this exact queue.
-    // GetBattlegroundQueueIndex returns PLAYER_MAX_BATTLEGROUND_QUEUES when the queue is not present,
-    // so the old "< PLAYER_MAX_BATTLEGROUND_QUEUES" check inverted the meaning and blocked fresh joins.
-    if (player->GetBattlegroundQueueIndex(queueTypeId) >= PLAYER_MAX_BATTLEGROUND_QUEUES && !player->HasFreeBattlegroundQueueId())
+    BattlegroundQueueTypeId queueTypeId;
+    PvPDifficultyEntry const* bracketEntry = nullptr;
+    if (!CanJoinQueueArena(player, isRated, queueTypeId, bracketEntry))
         return false;
 
-    uint32 ateamId = 0;
+    // Block playerbots / rndbot accounts from the rated ladder.
+    ObjectGuid const guid = player->GetGUID();
+    SoloBotFlag const botFlag = isRated ? sSolo->GetBotAccountFlag(guid) : SOLO_BOT_NO;
+    if (botFlag == SOLO_BOT_YES)
+        return false;
 
-    if (isRated)
+    if (!sSolo->BeginQueueJoin(guid))
+        return false;
+
+    if (!isRated)
     {
-        // Rated SoloQ uses its own ladder table and does NOT require a permanent ArenaTeam.
-        uint32 rating = 0;
-        uint32 mmr = 0;
-        Solo3v3::instance()->GetSoloRatingAndMMR(player, rating, mmr);
-        arenaRating = rating;
-        matchmakerRating = mmr;
-        ateamId = 0;
+        CompleteJoinQueueArena(guid, false, 0, 0);
+        return true;
     }
 
-    BattlegroundQueue& bgQueue = sBattlegroundMgr->GetBattlegroundQueue(queueTypeId);
-    BattlegroundTypeId bgTypeId = BATTLEGROUND_AA;
-
-    bg->SetRated(isRated);
-    bg->SetMinPlayersPerTeam(3);
+    // Rated SoloQ uses its own ladder table and does NOT require a permanent ArenaTeam.
+    auto loadRating = [guid]()
+    {
+        Player* player = ObjectAccessor::FindPlayer(guid);
+        if (!player)
+        {
+            sSolo->EndQueueJoin(guid, false);
+            return;
+        }
 
-    GroupQueueInfo* ginfo = bgQueue.AddGroup(player, nullptr, bgTypeId, bracketEntry, displayArenaType, isRated, false, arenaRating, matchmakerRating, ateamId, 0);
-    uint32 avgTime = bgQueue.GetAverageQueueWaitTime(ginfo);
-    uint32 queueSlot = player->AddBattlegroundQueueId(queueTypeId);
+        sSolo->GetSoloRatingAndMMRAsync(player, [guid](uint32 rating, uint32 mmr)
+        {
+            CompleteJoinQueueArena(guid, true, rating, mmr);
+        });
+    };
 
-    // send status packet (in queue)
-    WorldPacket data;
-    sBattlegroundMgr->BuildBattlegroundStatusPacket(&data, bg, queueSlot, STATUS_WAIT_QUEUE, avgTime, 0, displayArenaType, TEAM_NEUTRAL, isRated);
-    player->GetSession()->SendPacket(&data);
+    if (botFlag == SOLO_BOT_NO)
+    {
+        loadRating();
+        return true;
+    }
 
-    if (isRated && matchmakerRating == 0)
-        matchmakerRating = 1;
+    // The login lookup has not come back yet; do it here and cache the result.
+    player->GetSession()->GetQueryProcessor().AddCallback(LoginDatabase.AsyncQuery(fmt::format(
+        "SELECT username FROM account WHERE id = {}", player->GetSession()->GetAccountId()))
+        .WithCallback([guid, loadRating](QueryResult res)
+        {
+            sSolo->SetBotAccountFlag(guid, res ? res->Fetch()[0].Get<std::string>() : std::string());
+            if (sSolo->GetBotAccountFlag(guid) == SOLO_BOT_YES)
+            {
+                sSolo->EndQueueJoin(guid, false);
+                if (Player* player = ObjectAccessor::FindPlayer(guid))
+                    ChatHandler(player->GetSession()).SendSysMessage("Bot accounts cannot join the rated solo 3v3 queue.");
+                return;
+            }
 
-    sBattlegroundMgr->ScheduleQueueUpdate(matchmakerRating, queueArenaType, queueTypeId, bgTypeId, bracketEntry->GetBracketId());
-    sScriptMgr->OnPlayerJoinArena(player);
+            loadRating();
+        }));
 
     return true;
 }
@@ -379,77 +497,6 @@ bool NpcSolo3v3::CreateArenateam(Player* player, Creature* /*creature*/)
     return false;
 }
 
-void NpcSolo3v3::fetchQueueList()
-{
-    if (GetMSTimeDiffToNow(lastFetchQueueList) < 1000)
-        return;
-
-    lastFetchQueueList = getMSTime();
-
-    BattlegroundQueue* queue = &sBattlegroundMgr->GetBattlegroundQueue((BattlegroundQueueTypeId)BATTLEGROUND_QUEUE_3v3_SOLO);
-
-    for (int i = 0; i < MAX_TALENT_CAT; i++)
-        cache3v3Queue[i] = 0;
-
-    for (int i = BG_BRACKET_ID_FIRST; i <= BG_BRACKET_ID_LAST; i++)
-    {
-        for (int j = 0; j < 2; j++)
-        {
-            for (auto queueInfo : queue->m_QueuedGroups[i][j])
-            {
-                if (queueInfo->IsInvitedToBGInstanceGUID) // Skip when invited
-                    continue;
-
-                for (auto const& playerGuid : queueInfo->Players)
-                {
-                    Player* _player = ObjectAccessor::FindPlayer(playerGuid);
-                    if (!_player)
-                        continue;
-
-                    switch (_player->getClass())
-                    {
-                        case CLASS_WARRIOR:
-                            cache3v3Queue[WARRIOR]++;
-                            break;
-                        case CLASS_PALADIN:
-                            cache3v3Queue[PALADIN]++;
-                            break;
-                        case CLASS_DEATH_KNIGHT:
-                            cache3v3Queue[DK]++;
-                            break;
-                        case CLASS_HUNTER:
-                            cache3v3Queue[HUNTER]++;
-                            break;
-                        case CLASS_SHAMAN:
-                            cache3v3Queue[SHAMAN]++;
-                            break;
-                        case CLASS_ROGUE:
-                            cache3v3Queue[ROGUE]++;
-                            break;
-                        case CLASS_DRUID:
-                            cache3v3Queue[DRUID]++;
-                            break;
-                        case CLASS_MAGE:
-                            cache3v3Queue[MAGE]++;
-                            break;
-                        case CLASS_WARLOCK:
-                            cache3v3Queue[WARLOCK]++;
-                            break;
-                        case CLASS_PRIEST:
-                            cache3v3Queue[PRIEST]++;
-                            break;
-                        default:
-                            break;
-                    }
-
-                    Solo3v3TalentCat plrCat = sSolo->GetTalentCatForSolo3v3(_player); // get talent cat
-                    cache3v3Queue[plrCat]++;
-                }
-            }
-        }
-    }
-}
-
 namespace
 {
     uint32 CalculateSelectedPoolMMR(BattlegroundQueue* queue, uint32 teamIndex)
@@ -471,6 +518,25 @@ namespace
 
         return count ? uint32(total / count) : 1500;
     }
+
+    bool TryBackfillDodger(Battleground* bg, ObjectGuid dodger)
+    {
+        uint32 teamMMR[BG_TEAMS_COUNT];
+        if (!sSolo->BackfillDodger(bg, dodger, teamMMR))
+            return false;
+
+        auto contextItr = g_soloMatchContexts.find(bg->GetInstanceID());
+        if (contextItr != g_soloMatchContexts.end())
+        {
+            contextItr->second.teamMMR[TEAM_ALLIANCE] = teamMMR[TEAM_ALLIANCE];
+            contextItr->second.teamMMR[TEAM_HORDE] = teamMMR[TEAM_HORDE];
+        }
+
+        // InviteGroupToBG overwrites the team MMR with the replacement's own.
+        bg->SetArenaMatchmakerRating(TEAM_ALLIANCE, teamMMR[TEAM_ALLIANCE]);
+        bg->SetArenaMatchmakerRating(TEAM_HORDE, teamMMR[TEAM_HORDE]);
+        return true;
+    }
 }
 
 void Solo3v3BG::OnQueueUpdate(BattlegroundQueue* queue, uint32 /*diff*/, BattlegroundTypeId bgTypeId, BattlegroundBracketId bracket_id, uint8 arenaType, bool isRated, uint32 /*arenaRatedTeamId*/)
@@ -487,42 +553,62 @@ void Solo3v3BG::OnQueueUpdate(BattlegroundQueue* queue, uint32 /*diff*/, Battleg
     if (!bracketEntry)
         return;
 
-    if (sSolo->CheckSolo3v3Arena(queue, bracket_id, isRated))
+    // A fully accepted ready check takes priority over forming a new match.
+    if (!sSolo->PopAcceptedReadyCheck(queue, bracket_id, isRated))
     {
-        Battleground* arena = sBattlegroundMgr->CreateNewBattleground(bgTypeId, bracketEntry, arenaType, isRated);
-        if (!arena)
+        if (!sSolo->CheckSolo3v3Arena(queue, bracket_id, isRated))
             return;
 
-        // Create temp arena team and store arenaTeamId
-        ArenaTeam* arenaTeams[BG_TEAMS_COUNT];
-        sSolo->CreateTempArenaTeamForQueue(queue, arenaTeams);
+        // Hold the match until every player accepts; nothing is created yet.
+        if (sSolo->IsReadyCheckEnabled())
+        {
+            sSolo->BeginReadyCheck(queue, bracket_id, isRated);
+            return;
+        }
+    }
 
-        // invite those selection pools
-        for (uint32 i = 0; i < BG_TEAMS_COUNT; i++)
-            for (auto const& citr : queue->m_SelectionPools[TEAM_ALLIANCE + i].SelectedGroups)
-            {
-                citr->ArenaTeamId = arenaTeams[i]->GetId();
-                queue->InviteGroupToBG(citr, arena, citr->teamId);
-            }
+    // Server busy or at its arena cap: keep the match ready and create it later.
+    if (sSolo->AdmitNewArena() != SOLO_ADMIT)
+    {
+        sSolo->HoldMatchForAdmission(queue, bracket_id, isRated);
+        return;
+    }
+
+    Battleground* arena = sSolo->ClaimArenaInstance(bgTypeId, bracketEntry, arenaType, isRated);
+    if (!arena)
+        return;
+
+    // Create temp arena team and store arenaTeamId
+    ArenaTeam* arenaTeams[BG_TEAMS_COUNT];
+    sSolo->CreateTempArenaTeamForQueue(queue, arenaTeams);
 
-        // Override ArenaTeamId to temp arena team (was first set in InviteGroupToBG)
-        arena->SetArenaTeamIdForTeam(TEAM_ALLIANCE, arenaTeams[TEAM_ALLIANCE]->GetId());
-        arena->SetArenaTeamIdForTeam(TEAM_HORDE, arenaTeams[TEAM_HORDE]->GetId());
+    // invite those selection pools
+    for (uint32 i = 0; i < BG_TEAMS_COUNT; i++)
+        for (auto const& citr : queue->m_SelectionPools[TEAM_ALLIANCE + i].SelectedGroups)
+        {
+            citr->ArenaTeamId = arenaTeams[i]->GetId();
+            queue->InviteGroupToBG(citr, arena, citr->teamId);
+        }
 
-        SoloMatchContext context;
-        context.rated = isRated;
-        context.teamMMR[TEAM_ALLIANCE] = CalculateSelectedPoolMMR(queue, TEAM_ALLIANCE);
-        context.teamMMR[TEAM_HORDE] = CalculateSelectedPoolMMR(queue, TEAM_HORDE);
-        g_soloMatchContexts[arena->GetInstanceID()] = context;
+    sSolo->RecordMatchRoster(arena, queue);
 
-        // The core may still inspect matchmaker ratings while resolving the temporary
-        // rated battleground. Feed it the same standalone-ladder averages used below.
-        arena->SetArenaMatchmakerRating(TEAM_ALLIANCE, context.teamMMR[TEAM_ALLIANCE]);
-        arena->SetArenaMatchmakerRating(TEAM_HORDE, context.teamMMR[TEAM_HORDE]);
+    // Override ArenaTeamId to temp arena team (was first set in InviteGroupToBG)
+    arena->SetArenaTeamIdForTeam(TEAM_ALLIANCE, arenaTeams[TEAM_ALLIANCE]->GetId());
+    arena->SetArenaTeamIdForTeam(TEAM_HORDE, arenaTeams[TEAM_HORDE]->GetId());
 
-        // start bg
-        arena->StartBattleground();
-    }
+    SoloMatchContext context;
+    context.rated = isRated;
+    context.teamMMR[TEAM_ALLIANCE] = CalculateSelectedPoolMMR(queue, TEAM_ALLIANCE);
+    context.teamMMR[TEAM_HORDE] = CalculateSelectedPoolMMR(queue, TEAM_HORDE);
+    g_soloMatchContexts[arena->GetInstanceID()] = context;
+
+    // The core may still inspect matchmaker ratings while resolving the temporary
+    // rated battleground. Feed it the same standalone-ladder averages used below.
+    arena->SetArenaMatchmakerRating(TEAM_ALLIANCE, context.teamMMR[TEAM_ALLIANCE]);
+    arena->SetArenaMatchmakerRating(TEAM_HORDE, context.teamMMR[TEAM_HORDE]);
+
+    // start bg
+    arena->StartBattleground();
 }
 
 bool Solo3v3BG::OnQueueUpdateValidity(BattlegroundQueue* /* queue */, uint32 /*diff*/, BattlegroundTypeId /* bgTypeId */, BattlegroundBracketId /* bracket_id */, uint8 arenaType, bool /* isRated */, uint32 /*arenaRatedTeamId*/)
@@ -534,6 +620,30 @@ bool Solo3v3BG::OnQueueUpdateValidity(BattlegroundQueue* /* queue */, uint32 /*d
     return true;
 }
 
+void Solo3v3BG::OnBattlegroundRemovePlayerAtLeave(Battleground* bg, Player* player)
+{
+    if (!bg || bg->GetArenaType() != ARENA_TYPE_3v3_SOLO)
+        return;
+
+    sSolo->OnPlayerLeftArena(bg, player);
+}
+
+void Solo3v3BG::OnBattlegroundAddPlayer(Battleground* bg, Player* player)
+{
+    if (!bg || bg->GetArenaType() != ARENA_TYPE_3v3_SOLO)
+        return;
+
+    sSolo->OnPlayerEnteredArena(bg, player);
+}
+
+void Solo3v3BG::OnBattlegroundEnd(Battleground* bg, TeamId /* winnerTeamId */)
+{
+    if (!bg || bg->GetArenaType() != ARENA_TYPE_3v3_SOLO)
+        return;
+
+    sSolo->OnArenaEnded(bg);
+}
+
 void Solo3v3BG::OnBattlegroundDestroy(Battleground* bg)
 {
     if (bg)
@@ -556,6 +666,9 @@ void Solo3v3BG::OnBattlegroundEndReward(Battleground* bg, Player* player, TeamId
         !contextItr->second.rewardedPlayers.insert(guidLow).second)
         return;
 
+    if (contextItr->second.rewardedPlayers.size() == 1)
+        sSolo->GetMetrics().Add(SOLO_METRIC_LADDER_MATCHES);
+
     TeamId const playerTeam = player->GetBgTeamId();
     uint32 const ownIndex = playerTeam == TEAM_HORDE ? TEAM_HORDE : TEAM_ALLIANCE;
     uint32 const opponentIndex = ownIndex == TEAM_HORDE ? TEAM_ALLIANCE : TEAM_HORDE;
@@ -579,6 +692,27 @@ void ConfigLoader3v3Arena::OnAfterConfigLoad(bool /*Reload*/)
     BattlegroundMgr::QueueToArenaType.emplace(BATTLEGROUND_QUEUE_3v3_SOLO, (ArenaType)ARENA_TYPE_3v3_SOLO);
 }
 
+void Solo3v3World::OnStartup()
+{
+    sSolo->LoadQueueJournal();
+    sSolo->StartMatchmakingAudit();
+    sSolo->StartShadowMatchmaking();
+}
+
+void Solo3v3World::OnUpdate(uint32 diff)
+{
+    sSolo->Update(diff);
+}
+
+void Solo3v3World::OnShutdown()
+{
+    sSolo->ReleaseInstancePool();
+    sSolo->CloseMatchTraceFile();
+    sSolo->StopMatchmakingAudit();
+    sSolo->StopShadowMatchmaking();
+    sSolo->FlushSoloLadder();
+}
+
 void Team3v3arena::OnGetSlotByType(const uint32 type, uint8& slot)
 {
     if (type == ARENA_TYPE_3v3_SOLO)
@@ -655,13 +789,10 @@ void PlayerScript3v3Arena::OnPlayerBattlegroundDesertion(Player* player, const B
                     if (sConfigMgr->GetOption<bool>("Solo.3v3.CastDeserterOnAfk", true) || sConfigMgr->GetOption<bool>("Solo.3v3.CastDeserterOnLeave", true))
                         player->CastSpell(player, 26013, true);
 
-                    // end arena if a player leaves while in preparation
-                    if (sConfigMgr->GetOption<bool>("Solo.3v3.StopGameIncomplete", true))
-                    {
-                        sSolo->SaveIncompleteMatchLogs(bg);
-                        bg->SetRated(false);
-                        bg->EndBattleground(TEAM_NEUTRAL);
-                    }
+                    // replace the leaver from the queue, or end arena if a player leaves while in preparation
+                    if (!TryBackfillDodger(bg, player->GetGUID()) &&
+                        sConfigMgr->GetOption<bool>("Solo.3v3.StopGameIncomplete", true))
+                        sSolo->AbortIncompleteMatch(bg, player);
 
                     sSolo->CountAsLoss(player, false);
                 }
@@ -679,6 +810,9 @@ void PlayerScript3v3Arena::OnPlayerBattlegroundDesertion(Player* player, const B
                     player->CastSpell(player, 26013, true);
 
                 sSolo->CountAsLoss(player, false);
+
+                if (Battleground* arena = sSolo->GetRosterArena(player->GetGUID()))
+                    TryBackfillDodger(arena, player->GetGUID());
             }
             break;
 
@@ -720,18 +854,28 @@ void PlayerScript3v3Arena::OnPlayerBattlegroundDesertion(Player* player, const B
 
 void PlayerScript3v3Arena::OnPlayerLogin(Player* pPlayer)
 {
+    sSolo->OnPlayerLogin(pPlayer);
+
     if (sConfigMgr->GetOption<bool>("Solo.3v3.ShowMessageOnLogin", false)) {
         ChatHandler(pPlayer->GetSession()).SendSysMessage("This server is running the |cff4CFF00Arena solo Q 3v3 |rmodule.");
     }
 }
 
+void PlayerScript3v3Arena::OnPlayerLogout(Player* player)
+{
+    sSolo->OnPlayerLogout(player);
+}
+
 void PlayerScript3v3Arena::OnPlayerGetArenaPersonalRating(Player* player, uint8 slot, uint32& rating)
 {
     if (!player || slot != ARENA_SLOT_SOLO_3v3)
         return;
 
+    // Keep what the core reported until the ladder row has loaded.
+    uint32 soloRating = 0;
     uint32 mmr = 0;
-    sSolo->GetSoloRatingAndMMR(player, rating, mmr);
+    if (sSolo->GetSoloRatingAndMMR(player, soloRating, mmr))
+        rating = soloRating;
 }
 
 void PlayerScript3v3Arena::OnPlayerGetMaxPersonalArenaRatingRequirement(const Player* player, uint32 minslot, uint32& maxArenaRating) const
@@ -745,8 +889,9 @@ void PlayerScript3v3Arena::OnPlayerGetMaxPersonalArenaRatingRequirement(const Pl
     {
         uint32 soloRating = 0;
         uint32 soloMmr = 0;
-        sSolo->GetSoloRatingAndMMR(const_cast<Player*>(player), soloRating, soloMmr);
-        maxArenaRating = std::max(soloRating, maxArenaRating);
+        // Not loaded yet right after login: no solo rating to grant.
+        if (sSolo->GetSoloRatingAndMMR(const_cast<Player*>(player), soloRating, soloMmr))
+            maxArenaRating = std::max(soloRating, maxArenaRating);
     }
 }
 
@@ -798,9 +943,10 @@ public:
         ROOT = 100
     };
 
-    PlayerGossip_Solo3v3Service() : PlayerGossip(91011)
+    PlayerGossip_Solo3v3Service() : PlayerGossip(SOLO_3V3_GOSSIP_MENU_ID)
     {
         RegisterAction(ROOT, OpenRoot);
+        RegisterAction(SOLO_3V3_GOSSIP_SENDER_READY_CHECK, OpenReadyCheck);
         RegisterAction(GOSSIP_SENDER_MAIN, Dispatch);
     }
 
@@ -810,6 +956,12 @@ public:
         script.OnGossipHello(player, nullptr);
     }
 
+    static void OpenReadyCheck(Player* player, int32, int32, std::any)
+    {
+        NpcSolo3v3 script;
+        script.SendReadyCheckMenu(player, nullptr);
+    }
+
     static void Dispatch(Player* player, int32 sender, int32 action, std::any)
     {
         NpcSolo3v3 script;
@@ -826,7 +978,7 @@ namespace RTG::Services::Solo3v3
 
         player->PlayerTalkClass->ClearMenus();
         CloseGossipMenuFor(player);
-        sPlayerGossipMgr->ShowGossipMenu(player, 91011, PlayerGossip_Solo3v3Service::ROOT, 0);
+        sPlayerGossipMgr->ShowGossipMenu(player, SOLO_3V3_GOSSIP_MENU_ID, PlayerGossip_Solo3v3Service::ROOT, 0);
         return true;
     }
 }
@@ -852,6 +1004,7 @@ void AddSC_Solo_3v3_Arena()
     new Solo3v3BG();
     new Team3v3arena();
     new ConfigLoader3v3Arena();
+    new Solo3v3World();
     new PlayerScript3v3Arena();
     new Arena_SC();
     new Solo3v3Spell();
@@ -38,28 +38,22 @@ enum Npc3v3Actions {
     NPC_3v3_ACTION_DISBAND_ARENATEAM = 5,
     NPC_3v3_ACTION_JOIN_QUEUE_ARENA_UNRATED = 6,
     NPC_3v3_ACTION_SCRIPT_INFO = 8,
-    NPC_3v3_ACTION_SCOREBOARD_RETURN = 9
+    NPC_3v3_ACTION_SCOREBOARD_RETURN = 9,
+    NPC_3v3_ACTION_READY_CHECK_ACCEPT = 10,
+    NPC_3v3_ACTION_READY_CHECK_DECLINE = 11
 };
 
 class NpcSolo3v3 : public CreatureScript
 {
 public:
-    NpcSolo3v3() : CreatureScript("npc_solo3v3")
-    {
-        Initialize();
-    }
+    NpcSolo3v3() : CreatureScript("npc_solo3v3") { }
 
-    void Initialize();
     bool OnGossipHello(Player* player, Creature* creature) override;
     bool OnGossipSelect(Player* player, Creature* creature, uint32 /*sender*/, uint32 action) override;
     bool ArenaCheckFullEquipAndTalents(Player* player);
     bool JoinQueueArena(Player* player, Creature* creature, bool isRated);
     bool CreateArenateam(Player* player, Creature* creature);
-
-private:
-    void fetchQueueList();
-    int cache3v3Queue[MAX_TALENT_CAT];
-    uint32 lastFetchQueueList;
+    void SendReadyCheckMenu(Player* player, Creature* creature);
 };
 
 class Solo3v3BG : public AllBattlegroundScript
@@ -69,12 +63,18 @@ public:
         ALLBATTLEGROUNDHOOK_ON_QUEUE_UPDATE,
         ALLBATTLEGROUNDHOOK_ON_QUEUE_UPDATE_VALIDITY,
         ALLBATTLEGROUNDHOOK_ON_BATTLEGROUND_DESTROY,
-        ALLBATTLEGROUNDHOOK_ON_BATTLEGROUND_END_REWARD
+        ALLBATTLEGROUNDHOOK_ON_BATTLEGROUND_END_REWARD,
+        ALLBATTLEGROUNDHOOK_ON_BATTLEGROUND_REMOVE_PLAYER_AT_LEAVE,
+        ALLBATTLEGROUNDHOOK_ON_BATTLEGROUND_ADD_PLAYER,
+        ALLBATTLEGROUNDHOOK_ON_BATTLEGROUND_END
     }) {}
 
     void OnQueueUpdate(BattlegroundQueue* queue, uint32 /*diff*/, BattlegroundTypeId bgTypeId, BattlegroundBracketId bracket_id, uint8 arenaType, bool isRated, uint32 /*arenaRatedTeamId*/) override;
     bool OnQueueUpdateValidity(BattlegroundQueue* /* queue */, uint32 /*diff*/, BattlegroundTypeId /* bgTypeId */, BattlegroundBracketId /* bracket_id */, uint8 arenaType, bool /* isRated */, uint32 /*arenaRatedTeamId*/) override;
     void OnBattlegroundDestroy(Battleground* bg) override;
+    void OnBattlegroundRemovePlayerAtLeave(Battleground* bg, Player* player) override;
+    void OnBattlegroundAddPlayer(Battleground* bg, Player* player) override;
+    void OnBattlegroundEnd(Battleground* bg, TeamId /* winnerTeamId */) override;
     void OnBattlegroundEndReward(Battleground* bg, Player* player, TeamId /* winnerTeamId */) override;
 };
 
@@ -88,6 +88,20 @@ public:
     virtual void OnAfterConfigLoad(bool /*Reload*/) override;
 };
 
+class Solo3v3World : public WorldScript
+{
+public:
+    Solo3v3World() : WorldScript("solo3v3_world", {
+        WORLDHOOK_ON_STARTUP,
+        WORLDHOOK_ON_UPDATE,
+        WORLDHOOK_ON_SHUTDOWN
+    }) {}
+
+    void OnStartup() override;
+    void OnUpdate(uint32 diff) override;
+    void OnShutdown() override;
+};
+
 class Team3v3arena : public ArenaTeamScript
 {
 public:
@@ -109,6 +123,7 @@ class PlayerScript3v3Arena : public PlayerScript
 public:
     PlayerScript3v3Arena() : PlayerScript("player_script_3v3_arena", {
         PLAYERHOOK_ON_LOGIN,
+        PLAYERHOOK_ON_LOGOUT,
         PLAYERHOOK_ON_GET_ARENA_PERSONAL_RATING,
         PLAYERHOOK_ON_GET_MAX_PERSONAL_ARENA_RATING_REQUIREMENT,
         PLAYERHOOK_ON_GET_ARENA_TEAM_ID,
@@ -118,6 +133,7 @@ public:
     }) {}
 
     void OnPlayerLogin(Player* pPlayer) override;
+    void OnPlayerLogout(Player* player) override;
     void OnPlayerGetArenaPersonalRating(Player* player, uint8 slot, uint32& rating) override;
     void OnPlayerGetMaxPersonalArenaRatingRequirement(const Player* player, uint32 minslot, uint32& maxArenaRating) const override;
     void OnPlayerGetArenaTeamId(Player* player, uint8 slot, uint32& result) override;
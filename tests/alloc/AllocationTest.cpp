@@ -0,0 +1,144 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include "AllocationTracker.h"
+#include "BoundedMpmcQueue.h"
+#include "InMemorySoloQueue.h"
+#include "MatchmakingAudit.h"
+#include "MetricsRegistry.h"
+#include "QueueEtaModel.h"
+
+#include <atomic>
+#include <thread>
+
+namespace
+{
+    using Matchmaker = SoloMatchmaker<InMemorySoloQueue>;
+
+    /// @p players queued, one healer in five, alternating factions.
+    void FillQueue(InMemorySoloQueue& queue, uint32_t players)
+    {
+        for (uint32_t i = 0; i < players; ++i)
+        {
+            InMemoryQueuedPlayer player;
+            player.id       = i + 1;
+            player.team     = uint8_t(i % 2);
+            player.role     = i % 5 == 0 ? uint8_t(SOLO_ROLE_HEALER) : uint8_t(i % 2);
+            player.mmr      = 1400 + (i * 37) % 300;
+            player.classId  = uint8_t(1 + i % 9);
+            player.joinTime = i;
+            queue.Add(player);
+        }
+    }
+
+    SoloMatchmakerConfig FilteredConfig()
+    {
+        SoloMatchmakerConfig config;
+        config.filterTalents = true;
+        return config;
+    }
+}
+
+/// The counter sees the calling thread's allocations only, and nests.
+TEST(AllocationTest, Counter_CountsCallingThread)
+{
+    std::vector<int> mine, nested, theirs;
+    std::atomic<bool> go{ false };
+    std::thread worker([&]() { while (!go) std::this_thread::yield(); theirs.reserve(64); });
+
+    uint64_t outerAllocations = 0, outerBytes = 0, nestedAllocations = 0;
+    {
+        ScopedAllocationCounter outer;
+        mine.reserve(16);
+        {
+            ScopedAllocationCounter inner;
+            nested.reserve(8);
+            nestedAllocations = inner.Allocations();
+        }
+        go = true;
+        worker.join();
+        outerAllocations = outer.Allocations();
+        outerBytes       = outer.Bytes();
+    }
+
+    EXPECT_EQ(nestedAllocations, 1u);
+    EXPECT_EQ(outerAllocations, 1u);
+    EXPECT_EQ(outerBytes, 16 * sizeof(int));
+    EXPECT_GE(theirs.capacity(), 64u);
+    EXPECT_NO_ALLOCATIONS(mine.push_back(1));
+}
+
+/// A matchmaking pass that reuses its scratch buffers and result allocates
+/// nothing, except list nodes for the groups it moves to the other faction.
+TEST(AllocationTest, Matchmaking_SteadyStatePass)
+{
+    InMemorySoloQueue queue;
+    FillQueue(queue, 60);
+
+    Matchmaker::Scratch scratch;
+    Matchmaker matchmaker(queue, FilteredConfig(), &scratch);
+    Matchmaker::Result result;
+
+    // The first pass sizes the buffers. Later ones only allocate a list
+    // node for each player that changes faction bucket.
+    ASSERT_TRUE(matchmaker.Check(0, false, result));
+    for (uint32_t pass = 0; pass < 5; ++pass)
+    {
+        queue.RemovePooled();
+        EXPECT_MAX_ALLOCATIONS(6, EXPECT_TRUE(matchmaker.Check(0, false, result)));
+    }
+
+    // Passes that stop before the split.
+    InMemorySoloQueue small;
+    FillQueue(small, 5);
+    Matchmaker shortQueue(small, FilteredConfig(), &scratch);
+    EXPECT_NO_ALLOCATIONS(EXPECT_FALSE(shortQueue.Check(0, false, result)));
+}
+
+/// The split phase scores every team split on the reused buffers.
+TEST(AllocationTest, Matchmaking_SplitWithAudit)
+{
+    InMemorySoloQueue queue;
+    FillQueue(queue, 6); // two healers
+
+    Matchmaker::Scratch scratch;
+    Matchmaker matchmaker(queue, FilteredConfig(), &scratch);
+    Matchmaker::Result result;
+    std::vector<MatchmakingAuditRecord> splits;
+    splits.reserve(20);
+
+    ASSERT_TRUE(matchmaker.Check(0, false, result, &splits));
+    splits.clear();
+    EXPECT_NO_ALLOCATIONS(EXPECT_TRUE(matchmaker.Check(0, false, result, &splits)));
+    EXPECT_EQ(splits.size(), 20u);
+}
+
+/// Counters and histograms recorded at match formation and match end.
+TEST(AllocationTest, MatchEnd_MetricsAndEta)
+{
+    MetricsRegistry<2, 2> metrics;
+    metrics.Add(0); // registers the calling thread's shard
+    EXPECT_NO_ALLOCATIONS(metrics.Add(0); metrics.Record(1, 250));
+
+    QueueEtaModel eta;
+    EXPECT_NO_ALLOCATIONS(eta.OnJoin(SOLO_ROLE_HEALER, 1000); eta.OnMatched(SOLO_ROLE_HEALER, 61000, 60000));
+
+    BoundedMpmcQueue<MatchmakingAuditRecord> journal(64);
+    MatchmakingAuditRecord record;
+    EXPECT_NO_ALLOCATIONS(journal.TryPush(record); journal.TryPop(record));
+}
@@ -0,0 +1,89 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Counting replacements of the global allocation functions, see
+// AllocationTracker.h. The array, nothrow and sized forms all end up
+// here; memory comes from malloc so it can be released by either delete.
+
+#include "AllocationTracker.h"
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+    thread_local AllocationTracker::Counts* activeCounts = nullptr;
+
+    void* Allocate(std::size_t size, std::size_t alignment)
+    {
+        if (size == 0)
+            size = 1;
+
+        void* p = alignment > alignof(std::max_align_t)
+            ? std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment)
+            : std::malloc(size);
+        if (!p)
+            throw std::bad_alloc();
+
+        if (AllocationTracker::Counts* counts = activeCounts)
+        {
+            ++counts->allocations;
+            counts->bytes += size;
+        }
+        return p;
+    }
+
+    void Release(void* p) noexcept
+    {
+        if (!p)
+            return;
+
+        if (AllocationTracker::Counts* counts = activeCounts)
+            ++counts->frees;
+        std::free(p);
+    }
+}
+
+AllocationTracker::Counts*& AllocationTracker::Active()
+{
+    return activeCounts;
+}
+
+void* operator new(std::size_t size) { return Allocate(size, 0); }
+void* operator new[](std::size_t size) { return Allocate(size, 0); }
+void* operator new(std::size_t size, std::align_val_t align) { return Allocate(size, std::size_t(align)); }
+void* operator new[](std::size_t size, std::align_val_t align) { return Allocate(size, std::size_t(align)); }
+
+void* operator new(std::size_t size, std::nothrow_t const&) noexcept
+{
+    try { return Allocate(size, 0); } catch (std::bad_alloc const&) { return nullptr; }
+}
+
+void* operator new[](std::size_t size, std::nothrow_t const&) noexcept
+{
+    try { return Allocate(size, 0); } catch (std::bad_alloc const&) { return nullptr; }
+}
+
+void operator delete(void* p) noexcept { Release(p); }
+void operator delete[](void* p) noexcept { Release(p); }
+void operator delete(void* p, std::size_t) noexcept { Release(p); }
+void operator delete[](void* p, std::size_t) noexcept { Release(p); }
+void operator delete(void* p, std::align_val_t) noexcept { Release(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { Release(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { Release(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { Release(p); }
@@ -0,0 +1,77 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _ALLOCATION_TRACKER_H_
+#define _ALLOCATION_TRACKER_H_
+
+#include <cstdint>
+
+/// Heap allocation counting for tests. AllocationTracker.cpp replaces the
+/// global operator new/delete, so it is linked only into the allocation test
+/// runner (solo3v3_alloc_tests) and never into the shared unit test runner.
+/// The replacements only count on a thread that has a
+/// ScopedAllocationCounter alive, so background threads are unaffected.
+namespace AllocationTracker
+{
+    struct Counts
+    {
+        uint64_t allocations = 0;
+        uint64_t frees       = 0;
+        uint64_t bytes       = 0;
+    };
+
+    /// Counts of the calling thread, or nullptr when it is not counting.
+    Counts*& Active();
+}
+
+/// Counts the calling thread's allocations for its lifetime. Nests: the
+/// outer counter resumes when the inner one is destroyed.
+class ScopedAllocationCounter
+{
+public:
+    ScopedAllocationCounter() : _outer(AllocationTracker::Active()) { AllocationTracker::Active() = &_counts; }
+    ~ScopedAllocationCounter() { AllocationTracker::Active() = _outer; }
+
+    ScopedAllocationCounter(ScopedAllocationCounter const&) = delete;
+    ScopedAllocationCounter& operator=(ScopedAllocationCounter const&) = delete;
+
+    uint64_t Allocations() const { return _counts.allocations; }
+    uint64_t Frees()       const { return _counts.frees; }
+    uint64_t Bytes()       const { return _counts.bytes; }
+
+private:
+    AllocationTracker::Counts  _counts;
+    AllocationTracker::Counts* _outer;
+};
+
+/// Number of heap allocations @p fn makes on the calling thread.
+template <typename F>
+uint64_t CountAllocations(F&& fn)
+{
+    ScopedAllocationCounter counter;
+    fn();
+    return counter.Allocations();
+}
+
+/// Fails when @p statement allocates more than @p max times. Warm caches
+/// and scratch buffers with one call first to assert the steady state.
+#define EXPECT_MAX_ALLOCATIONS(max, statement) \
+    EXPECT_LE(CountAllocations([&]() { statement; }), uint64_t(max)) << "allocations in: " #statement
+
+#define EXPECT_NO_ALLOCATIONS(statement) EXPECT_MAX_ALLOCATIONS(0, statement)
+
+#endif // _ALLOCATION_TRACKER_H_
@@ -0,0 +1,267 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "benchmark/benchmark.h"
+#include "InMemorySoloQueue.h"
+#include "MatchmakingComposer.h"
+#include "SoloLadderStorage.h"
+#include "TalentClassifier.h"
+
+#include <random>
+#include <unordered_set>
+
+namespace
+{
+    /// FIFO queue of @p size candidates, ~20% healers, classes and MMR spread.
+    std::vector<QueuedCandidate> MakeQueue(uint32_t size, double healerShare, uint64_t seed = 1)
+    {
+        std::mt19937_64 rng(seed);
+        std::bernoulli_distribution healer(healerShare);
+        std::normal_distribution<double> mmr(1500.0, 250.0);
+        std::uniform_int_distribution<uint32_t> classId(1, 10);
+
+        std::vector<QueuedCandidate> queue;
+        queue.reserve(size);
+        for (uint32_t i = 0; i < size; ++i)
+        {
+            uint32_t const cls = classId(rng);
+            queue.push_back({ i + 1, healer(rng) ? PlayerRole::HEALER : PlayerRole::DPS,
+                uint32_t(std::max(0.0, mmr(rng))), i * 1000, uint8_t(cls == 10 ? 11 : cls) });
+        }
+        return queue;
+    }
+
+    /// Six players: two healers and four DPS with two duplicated classes, so
+    /// every class-stacking level has work to reject.
+    std::vector<QueuedCandidate> MakeSelection()
+    {
+        return {
+            { 1, PlayerRole::HEALER, 1620, 0, 11 },
+            { 2, PlayerRole::HEALER, 1480, 0, 5  },
+            { 3, PlayerRole::DPS,    1710, 0, 11 },
+            { 4, PlayerRole::DPS,    1390, 0, 4  },
+            { 5, PlayerRole::DPS,    1550, 0, 4  },
+            { 6, PlayerRole::DPS,    1505, 0, 8  },
+        };
+    }
+}
+
+// Phase 2 over the whole queue, as CheckSolo3v3Arena runs it on every update.
+static void BM_SelectCandidates(benchmark::State& state)
+{
+    MatchmakingComposer const composer;
+    std::vector<QueuedCandidate> const queue = MakeQueue(uint32_t(state.range(0)), 0.2);
+    std::vector<QueuedCandidate> selected;
+    bool allDps = false;
+
+    for (auto _ : state)
+    {
+        bool const ok = composer.SelectCandidates(queue, 3, true, 60000, 10000000, selected, allDps);
+        benchmark::DoNotOptimize(ok);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SelectCandidates)->RangeMultiplier(4)->Range(6, 5000);
+
+// Healer-starved queue: every pass walks the all-DPS fallback.
+static void BM_SelectCandidates_AllDps(benchmark::State& state)
+{
+    MatchmakingComposer const composer;
+    std::vector<QueuedCandidate> const queue = MakeQueue(uint32_t(state.range(0)), 0.0);
+    std::vector<QueuedCandidate> selected;
+    bool allDps = false;
+
+    for (auto _ : state)
+    {
+        bool const ok = composer.SelectCandidates(queue, 3, true, 60000, 10000000, selected, allDps);
+        benchmark::DoNotOptimize(ok);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SelectCandidates_AllDps)->RangeMultiplier(4)->Range(6, 5000);
+
+// Phase 3, C(6,3) = 20 splits, at Solo.3v3.PreventClassStacking 0-6.
+static void BM_FindBestTeamSplit(benchmark::State& state)
+{
+    MatchmakingComposer const composer;
+    std::vector<QueuedCandidate> const selected = MakeSelection();
+    uint8_t const level = uint8_t(state.range(0));
+
+    for (auto _ : state)
+    {
+        TeamSplitResult result = composer.FindBestTeamSplit(selected, 3, true, false, level, 0);
+        benchmark::DoNotOptimize(result);
+    }
+}
+BENCHMARK(BM_FindBestTeamSplit)->DenseRange(0, 6);
+
+// Phase 3 with the Solo.3v3.AvoidSameTeamIgnore tie-breaker; the lookup
+// stands in for PlayerSocial::HasIgnore.
+static void BM_FindBestTeamSplit_IgnoreTieBreak(benchmark::State& state)
+{
+    MatchmakingComposer const composer;
+    std::vector<QueuedCandidate> const selected = MakeSelection();
+    std::unordered_set<uint64_t> const ignoreList = { (3ull << 32) | 4, (5ull << 32) | 6 };
+    IgnorePredicate const ignores = [&ignoreList](QueuedCandidate const& a, QueuedCandidate const& b)
+    {
+        return ignoreList.count((uint64_t(a.id) << 32) | b.id) || ignoreList.count((uint64_t(b.id) << 32) | a.id);
+    };
+
+    for (auto _ : state)
+    {
+        TeamSplitResult result = composer.FindBestTeamSplit(selected, 3, true, false, 0, 0, ignores);
+        benchmark::DoNotOptimize(result);
+    }
+}
+BENCHMARK(BM_FindBestTeamSplit_IgnoreTieBreak);
+
+// The whole CheckSolo3v3Arena pass over an in-memory queue of 1k-50k
+// players, ~20% healers across both factions; every formed match is put
+// back so each iteration sees the same queue size.
+static void BM_SoloMatchmaker_Check(benchmark::State& state)
+{
+    std::mt19937_64 rng(1);
+    std::bernoulli_distribution healer(0.2);
+    std::normal_distribution<double> mmr(1500.0, 250.0);
+    std::uniform_int_distribution<uint32_t> classId(1, 9);
+
+    InMemorySoloQueue queue;
+    uint32_t joinTime = 0;
+    for (int64_t i = 0; i < state.range(0); ++i)
+    {
+        InMemoryQueuedPlayer player;
+        player.id       = uint64_t(i + 1);
+        player.team     = uint8_t(i % 2);
+        player.role     = healer(rng) ? uint8_t(SOLO_ROLE_HEALER) : uint8_t(i % 2);
+        player.mmr      = uint32_t(std::max(0.0, mmr(rng)));
+        player.classId  = uint8_t(classId(rng));
+        player.joinTime = joinTime++;
+        queue.Add(player);
+    }
+
+    SoloMatchmakerConfig config;
+    config.filterTalents = true;
+    SoloMatchmaker<InMemorySoloQueue> matchmaker(queue, config);
+
+    for (auto _ : state)
+    {
+        SoloMatchResult<InMemorySoloQueue> result;
+        bool const ok = matchmaker.Check(0, false, result);
+        benchmark::DoNotOptimize(ok);
+
+        state.PauseTiming();
+        std::vector<InMemoryQueuedPlayer> matched;
+        for (uint8_t team : { SOLO_TEAM_ALLIANCE, SOLO_TEAM_HORDE })
+            for (InMemoryQueuedPlayer const* player : queue.Pool(team))
+                matched.push_back(*player);
+        queue.RemovePooled();
+        for (InMemoryQueuedPlayer& player : matched)
+        {
+            player.joinTime = joinTime++;
+            queue.Add(player);
+        }
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SoloMatchmaker_Check)->RangeMultiplier(5)->Range(1000, 50000)->Unit(benchmark::kMicrosecond);
+
+// Ladder work of one match end as UpdateSoloLadderAfterMatch does it for six
+// players: load, Elo delta, update. In memory and behind the timing wrapper,
+// so this is the module's own cost without the database.
+static void BM_SoloLadder_MatchEnd(benchmark::State& state)
+{
+    InMemorySoloLadderStorage backend;
+    uint64_t recorded = 0;
+    TimedSoloLadderStorage storage(backend, [&recorded](SoloLadderOp, uint64_t us) { recorded += us; });
+    for (uint32_t guid = 1; guid <= uint32_t(state.range(0)); ++guid)
+        storage.Create(guid, 0);
+
+    uint32_t guid = 0;
+    for (auto _ : state)
+    {
+        for (uint32_t player = 0; player < 6; ++player)
+        {
+            guid = guid % uint32_t(state.range(0)) + 1;
+            SoloLadderRow row;
+            storage.Load(guid, row);
+
+            SoloLadderUpdate update;
+            update.delta  = SoloLadder::MatchDelta(row.mmr, 1500, 32, player < 3);
+            update.games  = 1;
+            update.wins   = player < 3;
+            update.losses = player >= 3;
+            storage.Update(guid, update, 0);
+        }
+    }
+    benchmark::DoNotOptimize(recorded);
+    state.SetItemsProcessed(state.iterations() * 6);
+}
+BENCHMARK(BM_SoloLadder_MatchEnd)->Arg(1000)->Arg(100000);
+
+// Talent classification as GetTalentCatForSolo3v3 runs it: walk a talent
+// store shaped like 3.3.5 Talent.dbc (~30 tabs, 5 rank ids per talent) and
+// count the ranks a 71-point player has learned.
+static void BM_TalentClassify(benchmark::State& state)
+{
+    static uint32_t const melee[] = { 383, 163, 161, 182, 398, 164, 181, 263, 281, 399, 183, 0 };
+    static uint32_t const range[] = { 81, 261, 283, 302, 361, 41, 303, 363, 61, 203, 301, 0 };
+    static uint32_t const heal[]  = { 201, 202, 382, 262, 282, 0 };
+    static uint32_t const tabs[]  = { 161, 163, 164, 181, 182, 183, 201, 202, 203, 261, 262, 263, 281, 282, 283,
+        301, 302, 303, 361, 362, 363, 381, 382, 383, 398, 399, 400, 41, 61, 81 };
+
+    struct Talent { uint32_t tab; uint32_t rankId[5]; };
+    std::vector<Talent> store;
+    uint32_t spellId = 10000;
+    for (uint32_t i = 0; i < 900; ++i)
+    {
+        Talent talent = { tabs[i % (sizeof(tabs) / sizeof(tabs[0]))], { } };
+        for (uint32_t& rank : talent.rankId)
+            rank = spellId++;
+        store.push_back(talent);
+    }
+
+    // 71 points: mostly one healing tab, the rest in a melee tab.
+    std::unordered_set<uint32_t> learned;
+    uint32_t points = 0;
+    for (Talent const& talent : store)
+    {
+        if (points < 71 && (talent.tab == 282 || talent.tab == 281))
+        {
+            learned.insert(talent.rankId[2]);
+            points += 3;
+        }
+    }
+
+    SoloTalentClassifier const classifier(melee, range, heal);
+    for (auto _ : state)
+    {
+        uint32_t count[SoloTalentClassifier::ROLES] = { };
+        for (Talent const& talent : store)
+        {
+            int8_t const role = classifier.RoleOf(talent.tab);
+            if (role == SoloTalentClassifier::NONE)
+                continue;
+
+            for (int rank = 4; rank >= 0; --rank)
+                if (learned.count(talent.rankId[rank]))
+                    count[role] += rank + 1;
+        }
+        benchmark::DoNotOptimize(SoloTalentClassifier::Pick(count));
+    }
+}
+BENCHMARK(BM_TalentClassify);
@@ -0,0 +1,92 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include "LatencyHistogram.h"
+
+/// Small values are recorded exactly, one bucket per value.
+TEST(LatencyHistogramTest, SmallValues_AreExact)
+{
+    for (uint64_t v = 0; v < LatencyHistogram::SUB_BUCKETS; ++v)
+    {
+        EXPECT_EQ(LatencyHistogram::BucketIndex(v), v);
+        EXPECT_EQ(LatencyHistogram::BucketUpperBound(static_cast<uint32_t>(v)), v);
+    }
+}
+
+/// Every value falls inside the bounds of the bucket it maps to, and bucket
+/// indices never exceed BUCKET_COUNT even for the largest uint64 value.
+TEST(LatencyHistogramTest, BucketIndex_ValueWithinBucketBounds)
+{
+    uint64_t const samples[] = { 16, 17, 31, 32, 100, 1000, 4095, 4096, 123456789,
+                                 std::numeric_limits<uint64_t>::max() };
+
+    for (uint64_t v : samples)
+    {
+        uint32_t const idx = LatencyHistogram::BucketIndex(v);
+        ASSERT_LT(idx, LatencyHistogram::BUCKET_COUNT);
+        EXPECT_LE(v, LatencyHistogram::BucketUpperBound(idx)) << "value " << v;
+        if (idx > 0)
+        {
+            EXPECT_GT(v, LatencyHistogram::BucketUpperBound(idx - 1)) << "value " << v;
+        }
+    }
+}
+
+/// Percentiles stay within the advertised relative error.
+TEST(LatencyHistogramTest, Percentile_WithinRelativeError)
+{
+    LatencyHistogram h;
+    for (uint64_t v = 1; v <= 10000; ++v)
+        h.Record(v);
+
+    EXPECT_EQ(h.Count(), 10000u);
+    EXPECT_EQ(h.Min(), 1u);
+    EXPECT_EQ(h.Max(), 10000u);
+    EXPECT_NEAR(h.Mean(), 5000.5, 0.001);
+
+    double const tolerance = 1.0 / LatencyHistogram::SUB_BUCKETS;
+    EXPECT_NEAR(double(h.Percentile(50)), 5000.0, 5000.0 * tolerance);
+    EXPECT_NEAR(double(h.Percentile(99)), 9900.0, 9900.0 * tolerance);
+    EXPECT_EQ(h.Percentile(100), 10000u);
+}
+
+/// Merging two histograms is equivalent to recording all samples in one.
+TEST(LatencyHistogramTest, Merge_CombinesSamples)
+{
+    LatencyHistogram a, b, all;
+    for (uint64_t v = 0; v < 500; ++v)
+    {
+        a.Record(v);
+        all.Record(v);
+    }
+    for (uint64_t v = 500; v < 2000; v += 3)
+    {
+        b.Record(v);
+        all.Record(v);
+    }
+
+    a.Merge(b);
+    EXPECT_EQ(a.Count(), all.Count());
+    EXPECT_EQ(a.Sum(), all.Sum());
+    EXPECT_EQ(a.Max(), all.Max());
+    EXPECT_EQ(a.Percentile(90), all.Percentile(90));
+
+    a.Reset();
+    EXPECT_EQ(a.Count(), 0u);
+    EXPECT_EQ(a.Percentile(50), 0u);
+}
@@ -0,0 +1,133 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include "MatchTrace.h"
+
+#include <fstream>
+#include <sstream>
+
+namespace
+{
+    std::string ReadFile(std::string const& path)
+    {
+        std::ifstream in(path, std::ios::binary);
+        std::stringstream ss;
+        ss << in.rdbuf();
+        return ss.str();
+    }
+
+    bool Exists(std::string const& path)
+    {
+        return std::ifstream(path).good();
+    }
+}
+
+/// An inactive trace ignores every event.
+TEST(MatchTraceTest, Inactive_RecordsNothing)
+{
+    MatchTrace trace;
+    trace.Instant("start", 0, 10);
+    trace.Span("queued", 5, 0, 10);
+    trace.NameThread(5, "Someone");
+    EXPECT_FALSE(trace.Active());
+    EXPECT_TRUE(trace.Events().empty());
+    EXPECT_TRUE(trace.ThreadNames().empty());
+}
+
+/// Spans become complete ("X") events, instants "i" events, and names are
+/// emitted as metadata with quotes escaped.
+TEST(MatchTraceTest, Encode_ChromeEvents)
+{
+    MatchTrace trace;
+    trace.Start(1000);
+    trace.NameThread(42, "Pl\"ayer");
+    trace.Span("queued", 42, 1000, 6000);
+    trace.Instant("arena_start", 0, 9000);
+
+    std::string out;
+    ChromeTraceWriter::Encode(7, "arena 7", trace, out);
+
+    EXPECT_NE(out.find("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":7,\"args\":{\"name\":\"arena 7\"}},"), std::string::npos);
+    EXPECT_NE(out.find("\"args\":{\"name\":\"Pl\\\"ayer\"}"), std::string::npos);
+    EXPECT_NE(out.find("{\"name\":\"queued\",\"ph\":\"X\",\"dur\":5000,\"ts\":1000,\"pid\":7,\"tid\":42},"), std::string::npos);
+    EXPECT_NE(out.find("{\"name\":\"arena_start\",\"ph\":\"i\",\"s\":\"t\",\"ts\":9000,\"pid\":7,\"tid\":0},"), std::string::npos);
+}
+
+/// The file rotates once it passes the size limit, keeping maxFiles files,
+/// each starting a fresh JSON array.
+TEST(MatchTraceTest, Writer_RotatesFiles)
+{
+    std::string const path = testing::TempDir() + "solo_trace_test.json";
+    for (char const* suffix : { "", ".1", ".2", ".3" })
+        std::remove((path + suffix).c_str());
+
+    MatchTrace trace;
+    trace.Start(0);
+    for (uint32_t i = 0; i < 10; ++i)
+        trace.Span("stage", i, i * 100, i * 100 + 50);
+
+    {
+        ChromeTraceWriter writer;
+        ASSERT_TRUE(writer.Open(path, 1024, 3));
+        for (uint32_t pid = 1; pid <= 20; ++pid)
+            writer.Write(pid, "arena", trace);
+    }
+
+    EXPECT_TRUE(Exists(path));
+    EXPECT_TRUE(Exists(path + ".1"));
+    EXPECT_TRUE(Exists(path + ".2"));
+    EXPECT_FALSE(Exists(path + ".3"));
+
+    std::string const rotated = ReadFile(path + ".1");
+    EXPECT_EQ(rotated.compare(0, 2, "[\n"), 0);
+    EXPECT_GE(rotated.size(), 1024u);
+
+    for (char const* suffix : { "", ".1", ".2" })
+        std::remove((path + suffix).c_str());
+}
+
+/// Opening over a previous run's trace keeps it as path.1.
+TEST(MatchTraceTest, Writer_OpenRotatesPreviousRun)
+{
+    std::string const path = testing::TempDir() + "solo_trace_restart_test.json";
+    for (char const* suffix : { "", ".1", ".2" })
+        std::remove((path + suffix).c_str());
+
+    MatchTrace trace;
+    trace.Start(0);
+    trace.Instant("invite", 0, 10);
+
+    for (uint32_t run = 0; run < 2; ++run)
+    {
+        ChromeTraceWriter writer;
+        ASSERT_TRUE(writer.Open(path, 0, 3));
+        EXPECT_TRUE(writer.Write(run + 1, "arena", trace));
+        writer.Close();
+        EXPECT_FALSE(writer.IsOpen());
+        EXPECT_EQ(writer.Written(), 1u);
+        EXPECT_EQ(writer.Dropped(), 0u);
+    }
+
+    EXPECT_NE(ReadFile(path + ".1").find("\"pid\":1,"), std::string::npos);
+    EXPECT_NE(ReadFile(path).find("\"pid\":2,"), std::string::npos);
+    EXPECT_EQ(ReadFile(path).find("\"pid\":1,"), std::string::npos);
+    EXPECT_FALSE(Exists(path + ".2"));
+
+    for (char const* suffix : { "", ".1", ".2" })
+        std::remove((path + suffix).c_str());
+}
@@ -0,0 +1,252 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include "MatchmakingAudit.h"
+
+#include <fstream>
+#include <iterator>
+#include <set>
+#include <thread>
+
+namespace
+{
+    std::vector<uint8_t> ReadFile(std::string const& path)
+    {
+        std::ifstream in(path, std::ios::binary);
+        return std::vector<uint8_t>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    /// Decodes every record of @p path into @p out; returns false on a bad header.
+    bool DecodeFile(std::string const& path, std::vector<MatchmakingAuditRecord>& out)
+    {
+        std::vector<uint8_t> const data = ReadFile(path);
+        if (!MatchmakingAuditWriter::IsHeader(data.data(), data.size()))
+            return false;
+
+        for (size_t offset = MatchmakingAuditWriter::HEADER_SIZE; offset + MatchmakingAuditWriter::RECORD_SIZE <= data.size();
+            offset += MatchmakingAuditWriter::RECORD_SIZE)
+        {
+            MatchmakingAuditRecord record;
+            if (!MatchmakingAuditWriter::DecodeRecord(data.data() + offset, record))
+                break;
+            out.push_back(record);
+        }
+        return true;
+    }
+}
+
+/// The queue is FIFO for a single producer and refuses pushes when full.
+TEST(MatchmakingAuditTest, Queue_FifoAndFull)
+{
+    BoundedMpmcQueue<uint32_t> queue(5); // rounded up to 8
+    EXPECT_EQ(queue.Capacity(), 8u);
+
+    for (uint32_t i = 0; i < 8; ++i)
+        EXPECT_TRUE(queue.TryPush(i));
+    EXPECT_FALSE(queue.TryPush(99));
+
+    uint32_t value = 0;
+    for (uint32_t i = 0; i < 8; ++i)
+    {
+        ASSERT_TRUE(queue.TryPop(value));
+        EXPECT_EQ(value, i);
+    }
+    EXPECT_FALSE(queue.TryPop(value));
+}
+
+/// Concurrent producers and consumers neither lose nor duplicate items.
+TEST(MatchmakingAuditTest, Queue_ConcurrentProducersConsumers)
+{
+    BoundedMpmcQueue<uint64_t> queue(1024);
+    constexpr uint64_t PRODUCERS = 4;
+    constexpr uint64_t PER_PRODUCER = 20000;
+
+    std::atomic<uint64_t> consumed{ 0 };
+    std::vector<std::vector<uint64_t>> seen(2);
+    std::vector<std::thread> threads;
+
+    for (uint64_t p = 0; p < PRODUCERS; ++p)
+        threads.emplace_back([&queue, p]()
+        {
+            for (uint64_t i = 0; i < PER_PRODUCER; ++i)
+                while (!queue.TryPush(p * PER_PRODUCER + i))
+                    std::this_thread::yield();
+        });
+
+    for (uint32_t c = 0; c < 2; ++c)
+        threads.emplace_back([&queue, &consumed, &seen, c]()
+        {
+            uint64_t value = 0;
+            while (consumed.load() < PRODUCERS * PER_PRODUCER)
+            {
+                if (queue.TryPop(value))
+                {
+                    seen[c].push_back(value);
+                    consumed.fetch_add(1);
+                }
+                else
+                    std::this_thread::yield();
+            }
+        });
+
+    for (std::thread& thread : threads)
+        thread.join();
+
+    std::set<uint64_t> all(seen[0].begin(), seen[0].end());
+    all.insert(seen[1].begin(), seen[1].end());
+    EXPECT_EQ(seen[0].size() + seen[1].size(), PRODUCERS * PER_PRODUCER);
+    EXPECT_EQ(all.size(), PRODUCERS * PER_PRODUCER);
+}
+
+/// Records survive an encode/decode round trip, and corruption is caught.
+TEST(MatchmakingAuditTest, Record_RoundTrip)
+{
+    MatchmakingAuditRecord in;
+    in.timeMs     = 1700000000123ull;
+    in.guid       = 0x0000000100000abcull;
+    in.value      = 4242;
+    in.decisionId = 77;
+    in.mmr        = 1834;
+    in.rating     = 1710;
+    in.mask       = 0x15;
+    in.type       = AUDIT_SPLIT;
+    in.bracket    = 5;
+    in.role       = 2;
+    in.classId    = 11;
+    in.reason     = AUDIT_REASON_SPLIT_CLASS_STACK;
+    in.flags      = AUDIT_FLAG_RATED | AUDIT_FLAG_CHOSEN;
+
+    std::vector<uint8_t> buf;
+    MatchmakingAuditWriter::EncodeRecord(in, buf);
+    ASSERT_EQ(buf.size(), MatchmakingAuditWriter::RECORD_SIZE);
+
+    MatchmakingAuditRecord out;
+    ASSERT_TRUE(MatchmakingAuditWriter::DecodeRecord(buf.data(), out));
+    EXPECT_EQ(out.timeMs, in.timeMs);
+    EXPECT_EQ(out.guid, in.guid);
+    EXPECT_EQ(out.value, in.value);
+    EXPECT_EQ(out.decisionId, in.decisionId);
+    EXPECT_EQ(out.mmr, in.mmr);
+    EXPECT_EQ(out.rating, in.rating);
+    EXPECT_EQ(out.mask, in.mask);
+    EXPECT_EQ(out.type, in.type);
+    EXPECT_EQ(out.bracket, in.bracket);
+    EXPECT_EQ(out.role, in.role);
+    EXPECT_EQ(out.classId, in.classId);
+    EXPECT_EQ(out.reason, in.reason);
+    EXPECT_EQ(out.flags, in.flags);
+
+    buf[10] ^= 0x01;
+    EXPECT_FALSE(MatchmakingAuditWriter::DecodeRecord(buf.data(), out));
+}
+
+/// Everything submitted before Stop() reaches the files, in order, across
+/// rotations.
+TEST(MatchmakingAuditTest, Writer_DrainsOnStopAndRotates)
+{
+    std::string const path = testing::TempDir() + "solo_audit_test.bin";
+    for (char const* suffix : { "", ".1", ".2" })
+        std::remove((path + suffix).c_str());
+
+    constexpr uint32_t RECORDS = 300;
+    {
+        MatchmakingAuditWriter writer(512);
+        // Large enough that the 300 records need at most one rotation.
+        writer.Start(path, MatchmakingAuditWriter::HEADER_SIZE + 200 * MatchmakingAuditWriter::RECORD_SIZE, 3);
+        EXPECT_TRUE(writer.IsRunning());
+
+        for (uint32_t i = 0; i < RECORDS; ++i)
+        {
+            MatchmakingAuditRecord record;
+            record.type       = AUDIT_JOIN;
+            record.decisionId = i;
+            while (!writer.Submit(record))
+                std::this_thread::yield();
+        }
+
+        writer.Stop();
+        EXPECT_FALSE(writer.IsRunning());
+        EXPECT_FALSE(writer.OpenFailed());
+        EXPECT_EQ(writer.Written(), RECORDS);
+    }
+
+    std::vector<MatchmakingAuditRecord> records;
+    if (std::ifstream(path + ".1").good())
+    {
+        ASSERT_TRUE(DecodeFile(path + ".1", records));
+    }
+    ASSERT_TRUE(DecodeFile(path, records));
+
+    ASSERT_EQ(records.size(), RECORDS);
+    for (uint32_t i = 0; i < RECORDS; ++i)
+        EXPECT_EQ(records[i].decisionId, i);
+
+    for (char const* suffix : { "", ".1", ".2" })
+        std::remove((path + suffix).c_str());
+}
+
+/// A restart appends to a complete journal of the previous run and rotates
+/// a torn one to path.1 instead of truncating it.
+TEST(MatchmakingAuditTest, Writer_RestartKeepsPreviousJournal)
+{
+    std::string const path = testing::TempDir() + "solo_audit_restart_test.bin";
+    for (char const* suffix : { "", ".1", ".2" })
+        std::remove((path + suffix).c_str());
+
+    auto runSession = [&path](uint32_t first, uint32_t count)
+    {
+        MatchmakingAuditWriter writer(64);
+        writer.Start(path, 0, 3);
+        for (uint32_t i = first; i < first + count; ++i)
+        {
+            MatchmakingAuditRecord record;
+            record.type       = AUDIT_JOIN;
+            record.decisionId = i;
+            while (!writer.Submit(record))
+                std::this_thread::yield();
+        }
+        writer.Stop();
+        EXPECT_FALSE(writer.OpenFailed());
+    };
+
+    runSession(0, 10);
+    runSession(10, 10);
+
+    std::vector<MatchmakingAuditRecord> records;
+    ASSERT_TRUE(DecodeFile(path, records));
+    ASSERT_EQ(records.size(), 20u);
+    for (uint32_t i = 0; i < 20; ++i)
+        EXPECT_EQ(records[i].decisionId, i);
+    EXPECT_FALSE(std::ifstream(path + ".1").good());
+
+    // A crash mid-record leaves a torn tail; don't append after it.
+    std::ofstream(path, std::ios::binary | std::ios::app).put(0);
+    runSession(20, 5);
+
+    records.clear();
+    ASSERT_TRUE(DecodeFile(path + ".1", records));
+    EXPECT_EQ(records.size(), 20u);
+
+    records.clear();
+    ASSERT_TRUE(DecodeFile(path, records));
+    ASSERT_EQ(records.size(), 5u);
+    EXPECT_EQ(records[0].decisionId, 20u);
+
+    for (char const* suffix : { "", ".1", ".2" })
+        std::remove((path + suffix).c_str());
+}
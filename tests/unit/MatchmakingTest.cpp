@@ -740,3 +740,43 @@ TEST_F(MatchmakingTest, ClassStacking_Level6_HealerDPSSameClass_BlockedTogether)
     EXPECT_NE(druidHealerOnTeam1, druidDPSOnTeam1)
         << "Resto Druid and Balance Druid must not share a team (level 6)";
 }
+
+/// Test 26: Among equally balanced splits the one with the fewest same-team
+/// ignore pairs wins; MMR balance still comes first.
+TEST_F(MatchmakingTest, IgnoreTieBreaker_SeparatesIgnoringPlayers)
+{
+    auto selected = MakeCandidates({
+        {PlayerRole::HEALER, 1500},
+        {PlayerRole::HEALER, 1500},
+        {PlayerRole::DPS,    1500},
+        {PlayerRole::DPS,    1500},
+        {PlayerRole::DPS,    1500},
+        {PlayerRole::DPS,    1500},
+    });
+
+    // DPS ids 3 and 4 ignore each other.
+    IgnorePredicate const ignores = [](QueuedCandidate const& a, QueuedCandidate const& b)
+    {
+        return (a.id == 3 && b.id == 4) || (a.id == 4 && b.id == 3);
+    };
+
+    auto result = composer.FindBestTeamSplit(selected, TEAM_SIZE, true, false, 0, 0, ignores);
+
+    ASSERT_TRUE(result.valid);
+    EXPECT_EQ(result.mmrDiff, 0u);
+    EXPECT_EQ(result.ignorePairs, 0);
+
+    bool aOnTeam1 = std::find(result.team1Indices.begin(), result.team1Indices.end(), 2u) != result.team1Indices.end();
+    bool bOnTeam1 = std::find(result.team1Indices.begin(), result.team1Indices.end(), 3u) != result.team1Indices.end();
+    EXPECT_NE(aOnTeam1, bOnTeam1) << "Players ignoring each other must be split when MMR allows it";
+
+    // MMR balance outweighs the ignore pair: only {1000, 2000} vs {1400, 1600} is even.
+    selected[2].mmr = 1000;
+    selected[3].mmr = 2000;
+    selected[4].mmr = 1400;
+    selected[5].mmr = 1600;
+    result = composer.FindBestTeamSplit(selected, TEAM_SIZE, true, false, 0, 0, ignores);
+    ASSERT_TRUE(result.valid);
+    EXPECT_EQ(result.mmrDiff, 0u);
+    EXPECT_EQ(result.ignorePairs, 1);
+}
@@ -0,0 +1,123 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include "MetricsRegistry.h"
+
+#include <thread>
+
+namespace
+{
+    using Registry = MetricsRegistry<3, 2>;
+}
+
+/// Counters and histograms recorded on one thread show up in a snapshot;
+/// out-of-range ids are ignored.
+TEST(MetricsRegistryTest, SingleThread_CountersAndHistograms)
+{
+    Registry metrics;
+    metrics.Add(0);
+    metrics.Add(0, 4);
+    metrics.Add(2, 7);
+    metrics.Add(3, 100); // ignored
+    for (uint64_t v = 1; v <= 100; ++v)
+        metrics.Record(1, v);
+    metrics.Record(5, 1); // ignored
+
+    Registry::Snapshot snap;
+    metrics.Collect(snap);
+    EXPECT_EQ(snap.counters[0], 5u);
+    EXPECT_EQ(snap.counters[1], 0u);
+    EXPECT_EQ(snap.counters[2], 7u);
+    EXPECT_EQ(snap.histograms[0].Count(), 0u);
+    EXPECT_EQ(snap.histograms[1].Count(), 100u);
+    EXPECT_EQ(snap.histograms[1].Min(), 1u);
+    EXPECT_EQ(snap.histograms[1].Max(), 100u);
+    EXPECT_EQ(snap.histograms[1].Sum(), 5050u);
+    EXPECT_EQ(metrics.ShardCount(), 1u);
+}
+
+/// Each thread writes its own shard; after the threads exit their samples
+/// are still part of the snapshot.
+TEST(MetricsRegistryTest, ManyThreads_MergeOnCollect)
+{
+    Registry metrics;
+    constexpr uint32_t THREADS = 4;
+    constexpr uint32_t PER_THREAD = 10000;
+
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < THREADS; ++t)
+    {
+        threads.emplace_back([&metrics, t]()
+        {
+            for (uint32_t i = 0; i < PER_THREAD; ++i)
+            {
+                metrics.Add(1);
+                metrics.Record(0, t * PER_THREAD + i);
+            }
+        });
+    }
+
+    // Collecting while writers are running is allowed.
+    Registry::Snapshot partial;
+    metrics.Collect(partial);
+    EXPECT_LE(partial.counters[1], uint64_t(THREADS) * PER_THREAD);
+
+    for (std::thread& thread : threads)
+        thread.join();
+
+    Registry::Snapshot snap;
+    metrics.Collect(snap);
+    EXPECT_EQ(snap.counters[1], uint64_t(THREADS) * PER_THREAD);
+    EXPECT_EQ(snap.histograms[0].Count(), uint64_t(THREADS) * PER_THREAD);
+    EXPECT_EQ(snap.histograms[0].Min(), 0u);
+    EXPECT_EQ(snap.histograms[0].Max(), uint64_t(THREADS) * PER_THREAD - 1);
+    EXPECT_EQ(metrics.ShardCount(), THREADS);
+}
+
+/// Two registries on the same thread keep separate shards, including a new
+/// registry constructed where an old one used to live.
+TEST(MetricsRegistryTest, SeparateRegistries_DoNotShareShards)
+{
+    {
+        Registry first;
+        first.Add(0, 3);
+    }
+
+    Registry a, b;
+    a.Add(0, 1);
+    b.Add(0, 2);
+
+    Registry::Snapshot snapA, snapB;
+    a.Collect(snapA);
+    b.Collect(snapB);
+    EXPECT_EQ(snapA.counters[0], 1u);
+    EXPECT_EQ(snapB.counters[0], 2u);
+}
+
+/// The scoped timer records one sample on destruction.
+TEST(MetricsRegistryTest, ScopedTimer_RecordsOnce)
+{
+    Registry metrics;
+    {
+        ScopedMetricTimer<Registry> timer(metrics, 0);
+    }
+
+    Registry::Snapshot snap;
+    metrics.Collect(snap);
+    EXPECT_EQ(snap.histograms[0].Count(), 1u);
+}
@@ -0,0 +1,97 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include "QueueEtaModel.h"
+
+namespace
+{
+    constexpr uint32_t DPS    = 0;
+    constexpr uint32_t HEALER = 2;
+}
+
+/// A steady event stream converges on its true rate, both before and after
+/// a full half-life of history.
+TEST(QueueEtaModelTest, DecayedRate_TracksSteadyRate)
+{
+    DecayedRate rate;
+    double const halfLifeMs = 60000.0;
+
+    uint64_t now = 1000;
+    for (uint32_t i = 0; i < 20; ++i, now += 500) // 2 per second for 10 s
+        rate.Add(now, halfLifeMs);
+    EXPECT_NEAR(rate.Rate(now, halfLifeMs), 2.0, 0.2);
+
+    for (uint32_t i = 0; i < 2000; ++i, now += 500) // ~16 more half-lives
+        rate.Add(now, halfLifeMs);
+    EXPECT_NEAR(rate.Rate(now, halfLifeMs), 2.0, 0.05);
+
+    // With no more events the rate halves every half-life.
+    EXPECT_NEAR(rate.Rate(now + 60000, halfLifeMs), 1.0, 0.05);
+}
+
+/// Roles are independent: a slow DPS match rate means long DPS waits while
+/// healers, matched often, get short ones.
+TEST(QueueEtaModelTest, Estimate_IsRoleAware)
+{
+    QueueEtaModel model(600);
+
+    uint64_t now = 1000;
+    for (uint32_t i = 0; i < 120; ++i, now += 1000)
+    {
+        model.OnJoin(DPS, now);
+        if (i % 10 == 0)
+            model.OnMatched(DPS, now, 300000);  // one DPS every 10 s
+        model.OnMatched(HEALER, now, 5000);     // one healer every second
+    }
+
+    uint64_t const dps    = model.EstimateWaitMs(DPS, 4, now);
+    uint64_t const healer = model.EstimateWaitMs(HEALER, 4, now);
+    EXPECT_NEAR(double(dps), 50000.0, 8000.0);
+    EXPECT_NEAR(double(healer), 5000.0, 800.0);
+    EXPECT_GT(model.ArrivalRate(DPS, now), model.MatchRate(DPS, now));
+}
+
+/// Without match history there is no estimate; once waits are recorded the
+/// histogram median is used until the match rate is known.
+TEST(QueueEtaModelTest, Estimate_EmptyAndHistogramFallback)
+{
+    QueueEtaModel model(600);
+    EXPECT_EQ(model.EstimateWaitMs(DPS, 0, 5000), 0u);
+    EXPECT_EQ(model.EstimateWaitMs(7, 0, 5000), 0u); // unknown role
+
+    for (uint32_t i = 0; i < 50; ++i)
+        model.OnMatched(HEALER, 10000, 30000 + i * 1000);
+
+    EXPECT_EQ(model.MatchedSamples(HEALER), 50u);
+    EXPECT_NEAR(double(model.WaitPercentileSec(HEALER, 50)), 55.0, 55.0 / LatencyHistogram::SUB_BUCKETS);
+}
+
+/// Wait samples older than two half-lives are dropped.
+TEST(QueueEtaModelTest, WaitHistogram_AgesOut)
+{
+    QueueEtaModel model(60);
+    model.OnMatched(DPS, 1000, 600000);
+    EXPECT_EQ(model.WaitPercentileSec(DPS, 50), 600u);
+
+    model.OnMatched(DPS, 70000, 10000);  // rotates: the 600 s sample is now "previous"
+    EXPECT_EQ(model.MatchedSamples(DPS), 2u);
+
+    model.OnMatched(DPS, 140000, 10000); // rotates again: the 600 s sample is gone
+    EXPECT_EQ(model.MatchedSamples(DPS), 2u);
+    EXPECT_EQ(model.WaitPercentileSec(DPS, 100), 10u);
+}
@@ -0,0 +1,121 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include "QueueSimulator.h"
+
+#include <memory>
+
+namespace
+{
+    /// Feeds a fixed list of arrivals to QueueSimulator::Run.
+    std::function<bool(SimArrival&)> Script(std::vector<SimArrival> arrivals)
+    {
+        auto next = std::make_shared<size_t>(0);
+        auto list = std::make_shared<std::vector<SimArrival>>(std::move(arrivals));
+        return [next, list](SimArrival& out)
+        {
+            if (*next >= list->size())
+                return false;
+            out = (*list)[(*next)++];
+            return true;
+        };
+    }
+
+    SimArrival Arrive(uint64_t timeMs, PlayerRole role, uint32_t mmr = 1500, uint8_t classId = 1)
+    {
+        SimArrival arrival;
+        arrival.timeMs  = timeMs;
+        arrival.role    = role;
+        arrival.mmr     = mmr;
+        arrival.classId = classId;
+        return arrival;
+    }
+}
+
+/// Two healers and four DPS form one match the moment the last one joins.
+TEST(QueueSimulatorTest, StandardMatch_WaitsAndBalance)
+{
+    std::vector<SimArrival> arrivals;
+    arrivals.push_back(Arrive(0,     PlayerRole::HEALER, 1500, 5));
+    arrivals.push_back(Arrive(1000,  PlayerRole::DPS,    1600, 1));
+    arrivals.push_back(Arrive(2000,  PlayerRole::DPS,    1400, 4));
+    arrivals.push_back(Arrive(3000,  PlayerRole::DPS,    1550, 8));
+    arrivals.push_back(Arrive(4000,  PlayerRole::DPS,    1450, 9));
+    arrivals.push_back(Arrive(10000, PlayerRole::HEALER, 1500, 7));
+
+    QueueSimulator sim(SimSettings{});
+    SimReport const report = sim.Run(Script(arrivals), 60000);
+
+    EXPECT_EQ(report.matches, 1u);
+    EXPECT_EQ(report.allDpsMatches, 0u);
+    EXPECT_EQ(report.stillQueued[0] + report.stillQueued[1], 0u);
+    EXPECT_EQ(report.waitSec[uint32_t(PlayerRole::HEALER)].Max(), 10u);
+    EXPECT_EQ(report.waitSec[uint32_t(PlayerRole::DPS)].Count(), 4u);
+    EXPECT_EQ(report.mmrDiff.Max(), 0u);
+
+    // Four DPS waited from t=4s until the second healer showed up.
+    EXPECT_EQ(report.healerStarvedMs, 6000u);
+}
+
+/// Without healers, DPS only match once their AllDPS timer has run out
+/// (straight away with a zero timer).
+TEST(QueueSimulatorTest, AllDpsTimer_DelaysFallbackMatch)
+{
+    std::vector<SimArrival> arrivals;
+    for (uint32_t i = 0; i < 6; ++i)
+        arrivals.push_back(Arrive(i * 1000, PlayerRole::DPS, 1500, uint8_t(i + 1)));
+
+    SimSettings settings;
+    settings.allDpsTimerMs = 60000;
+    QueueSimulator timed(settings);
+    SimReport const report = timed.Run(Script(arrivals), 120000);
+
+    EXPECT_EQ(report.matches, 1u);
+    EXPECT_EQ(report.allDpsMatches, 1u);
+    // The youngest DPS's timer fires at 65s, so the oldest waited 65s.
+    EXPECT_EQ(report.waitSec[uint32_t(PlayerRole::DPS)].Max(), 65u);
+
+    // A zero timer makes DPS eligible at join, as on the server: the match
+    // forms as soon as the sixth DPS arrives.
+    settings.allDpsTimerMs = 0;
+    QueueSimulator immediate(settings);
+    SimReport const early = immediate.Run(Script(arrivals), 120000);
+    EXPECT_EQ(early.matches, 1u);
+    EXPECT_EQ(early.allDpsMatches, 1u);
+    EXPECT_EQ(early.waitSec[uint32_t(PlayerRole::DPS)].Max(), 5u);
+}
+
+/// Impatient players leave, and a synthetic run keeps its bookkeeping
+/// consistent: every arrival is matched, abandoned or still queued.
+TEST(QueueSimulatorTest, Synthetic_ConservesPlayers)
+{
+    SimArrivalGenerator generator(20.0, 0.15, 1500.0, 200.0, {}, 42);
+    SimSettings settings;
+    settings.allDpsTimerMs        = 120000;
+    settings.preventClassStacking = 1;
+    settings.meanPatienceMs       = 10 * 60000;
+
+    QueueSimulator sim(settings, 7);
+    SimReport const report = sim.Run([&generator](SimArrival& out) { out = generator.Next(); return true; },
+        7ull * 24 * 60 * 60000);
+
+    EXPECT_GT(report.matches, 0u);
+    EXPECT_GT(report.abandoned[uint32_t(PlayerRole::DPS)], 0u);
+    for (uint32_t role = 0; role < 2; ++role)
+        EXPECT_EQ(report.arrivals[role], report.waitSec[role].Count() + report.abandoned[role] + report.stillQueued[role]);
+}
@@ -0,0 +1,130 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include "ShadowMatchmaking.h"
+
+namespace
+{
+    /// @p players queued a second apart, one healer in three, taken 60s
+    /// after the first joined.
+    ShadowSnapshot MakeSnapshot(uint32_t players)
+    {
+        ShadowSnapshot snapshot;
+        snapshot.takenMs = 60000;
+        for (uint32_t i = 0; i < players; ++i)
+        {
+            InMemoryQueuedPlayer player;
+            player.id       = i + 1;
+            player.team     = uint8_t(i % 2);
+            player.role     = i % 3 == 0 ? uint8_t(SOLO_ROLE_HEALER) : uint8_t(i % 2);
+            player.mmr      = 1500 + i * 10;
+            player.classId  = uint8_t(1 + i % 9);
+            player.joinTime = i * 1000;
+            snapshot.entries.push_back(player);
+        }
+        return snapshot;
+    }
+
+    SoloMatchmakerConfig FilteredConfig()
+    {
+        SoloMatchmakerConfig config;
+        config.filterTalents = true;
+        return config;
+    }
+}
+
+TEST(ShadowMatchmakingTest, ParsePolicies)
+{
+    std::vector<ShadowPolicy> policies;
+    std::string error;
+    ASSERT_TRUE(ShadowMatchmaking::ParsePolicies(" stack2 : PreventClassStacking=2, PreventClassStacking.Classes=6 ;"
+        "window:MaxMMRSpread=150;plain", FilteredConfig(), policies, error)) << error;
+
+    ASSERT_EQ(policies.size(), 3u);
+    EXPECT_EQ(policies[0].name, "stack2");
+    EXPECT_EQ(policies[0].config.preventClassStacking, 2u);
+    EXPECT_EQ(policies[0].config.classStackMask, 6u);
+    EXPECT_TRUE(policies[0].config.filterTalents);
+    EXPECT_EQ(policies[1].maxMmrSpread, 150u);
+    EXPECT_EQ(policies[2].name, "plain");
+    EXPECT_EQ(policies[2].maxMmrSpread, 0u);
+
+    policies.clear();
+    EXPECT_FALSE(ShadowMatchmaking::ParsePolicies("bad:LookAhead=2", FilteredConfig(), policies, error));
+    EXPECT_NE(error.find("LookAhead"), std::string::npos);
+    EXPECT_FALSE(ShadowMatchmaking::ParsePolicies("bad:MaxMMRSpread=x", FilteredConfig(), policies, error));
+    EXPECT_FALSE(ShadowMatchmaking::ParsePolicies(":MaxMMRSpread=1", FilteredConfig(), policies, error));
+}
+
+/// A snapshot is matched to exhaustion; an MMR window stops at the first
+/// match that is too wide, and the snapshot itself is left untouched.
+TEST(ShadowMatchmakingTest, Evaluate_ComparesPolicies)
+{
+    ShadowSnapshot const snapshot = MakeSnapshot(12);
+
+    ShadowPolicy live{ "live", FilteredConfig(), 0 };
+    ShadowPolicyStats liveStats;
+    ShadowMatchmaking::Evaluate(live, snapshot, 100, liveStats);
+    EXPECT_EQ(liveStats.snapshots, 1u);
+    EXPECT_EQ(liveStats.matches, 2u);
+    EXPECT_EQ(liveStats.stops[AUDIT_REASON_TOO_FEW], 1u);
+    EXPECT_EQ(liveStats.mmrDiff.Count(), 2u);
+    EXPECT_EQ(liveStats.waitSec.Count(), 12u);
+    EXPECT_EQ(liveStats.waitSec.Max(), 60u);
+    EXPECT_EQ(liveStats.evalUs.Count(), 1u);
+
+    ShadowPolicy window{ "window", FilteredConfig(), 10 };
+    ShadowPolicyStats windowStats;
+    ShadowMatchmaking::Evaluate(window, snapshot, 100, windowStats);
+    EXPECT_EQ(windowStats.matches, 0u);
+    EXPECT_EQ(windowStats.windowStops, 1u);
+
+    ShadowPolicyStats capped;
+    ShadowMatchmaking::Evaluate(live, snapshot, 1, capped);
+    EXPECT_EQ(capped.matches, 1u);
+    EXPECT_EQ(snapshot.entries.size(), 12u);
+}
+
+/// Submit never blocks: snapshots beyond the queue capacity are dropped,
+/// and Stop() evaluates what was accepted before joining.
+TEST(ShadowMatchmakingTest, Thread_BoundedAndDrainedOnStop)
+{
+    ShadowMatchmaking shadow(2);
+    uint32_t accepted = 0;
+    for (uint32_t i = 0; i < 5; ++i)
+        accepted += shadow.Submit(MakeSnapshot(12));
+    EXPECT_EQ(accepted, 2u);
+    EXPECT_EQ(shadow.Dropped(), 3u);
+
+    std::vector<ShadowPolicy> policies;
+    policies.push_back({ "live", FilteredConfig(), 0 });
+    policies.push_back({ "window", FilteredConfig(), 10 });
+    shadow.Start(policies, 100);
+    EXPECT_TRUE(shadow.IsRunning());
+    shadow.Stop();
+    EXPECT_FALSE(shadow.IsRunning());
+    EXPECT_EQ(shadow.Evaluated(), 2u);
+
+    std::vector<ShadowPolicyStats> stats;
+    shadow.Collect(stats);
+    ASSERT_EQ(stats.size(), 2u);
+    EXPECT_EQ(stats[0].name, "live");
+    EXPECT_EQ(stats[0].snapshots, 2u);
+    EXPECT_EQ(stats[0].matches, 4u);
+    EXPECT_EQ(stats[1].windowStops, 2u);
+}
@@ -0,0 +1,104 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include "SoloLadderStorage.h"
+
+#include <vector>
+
+TEST(SoloLadderStorageTest, RatingRules)
+{
+    EXPECT_FLOAT_EQ(SoloLadder::ExpectedScore(1500, 1500), 0.5f);
+    EXPECT_NEAR(SoloLadder::ExpectedScore(1900, 1500), 0.909f, 0.001f);
+
+    EXPECT_EQ(SoloLadder::MatchDelta(1500, 1500, 32, true), 16);
+    EXPECT_EQ(SoloLadder::MatchDelta(1500, 1500, 32, false), -16);
+    EXPECT_EQ(SoloLadder::MatchDelta(1900, 1500, 32, true), 3);
+
+    EXPECT_EQ(SoloLadder::ApplyDelta(10, -50), 0u);
+    EXPECT_EQ(SoloLadder::ApplyDelta(SOLO_RATING_MAX - 5, 50), SOLO_RATING_MAX);
+}
+
+/// Updates work on rows that do not exist yet, starting from the defaults,
+/// and Create never resets a row.
+TEST(SoloLadderStorageTest, InMemory_CreateAndUpdate)
+{
+    InMemorySoloLadderStorage storage;
+    SoloLadderRow row;
+    EXPECT_FALSE(storage.Load(7, row));
+
+    SoloLadderUpdate win;
+    win.delta = 16;
+    win.games = 1;
+    win.wins  = 1;
+    storage.Update(7, win, 100);
+    ASSERT_TRUE(storage.Load(7, row));
+    EXPECT_EQ(row.rating, SOLO_RATING_DEFAULT + 16);
+    EXPECT_EQ(row.mmr, SOLO_RATING_DEFAULT + 16);
+    EXPECT_EQ(row.games, 1u);
+    EXPECT_EQ(row.wins, 1u);
+
+    storage.Create(7, 200);
+    storage.Create(8, 200);
+    ASSERT_TRUE(storage.Load(7, row));
+    EXPECT_EQ(row.games, 1u);
+    EXPECT_EQ(storage.Size(), 2u);
+
+    SoloLadderUpdate penalty;
+    penalty.delta  = -int32_t(SOLO_RATING_MAX);
+    penalty.games  = 1;
+    penalty.losses = 1;
+    storage.Update(8, penalty, 300);
+    ASSERT_TRUE(storage.Load(8, row));
+    EXPECT_EQ(row.rating, 0u);
+    EXPECT_EQ(row.losses, 1u);
+
+    bool called = false;
+    storage.LoadAsync(9, [&called](bool found, SoloLadderRow const& loaded)
+    {
+        called = true;
+        EXPECT_FALSE(found);
+        EXPECT_EQ(loaded.rating, SOLO_RATING_DEFAULT);
+    });
+    EXPECT_TRUE(called);
+}
+
+/// The timing wrapper forwards every call and reports each one once.
+TEST(SoloLadderStorageTest, Timed_ReportsEveryCall)
+{
+    InMemorySoloLadderStorage backend;
+    std::vector<SoloLadderOp> ops;
+    TimedSoloLadderStorage storage(backend, [&ops](SoloLadderOp op, uint64_t) { ops.push_back(op); });
+
+    EXPECT_TRUE(storage.Available());
+    backend.SetAvailable(false);
+    EXPECT_FALSE(storage.Available());
+
+    SoloLadderRow row;
+    storage.Create(1, 0);
+    EXPECT_TRUE(storage.Load(1, row));
+    storage.Update(1, SoloLadderUpdate(), 0);
+    bool found = false;
+    storage.LoadAsync(1, [&found](bool rowFound, SoloLadderRow const&) { found = rowFound; });
+    storage.ProcessCallbacks();
+    EXPECT_TRUE(found);
+
+    std::vector<SoloLadderOp> const expected = { SOLO_LADDER_OP_AVAILABLE, SOLO_LADDER_OP_AVAILABLE, SOLO_LADDER_OP_CREATE,
+        SOLO_LADDER_OP_LOAD, SOLO_LADDER_OP_UPDATE, SOLO_LADDER_OP_LOAD_ASYNC };
+    EXPECT_EQ(ops, expected);
+    EXPECT_EQ(backend.Size(), 1u);
+}
@@ -0,0 +1,129 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include "SoloLadderWriteBehind.h"
+
+namespace
+{
+    /// In-memory ladder that counts the batches it is handed.
+    class BatchCountingStorage : public InMemorySoloLadderStorage
+    {
+    public:
+        uint32_t UpdateBatch(std::vector<SoloLadderBatchRow> const& rows, uint32_t now) override
+        {
+            ++batches;
+            InMemorySoloLadderStorage::UpdateBatch(rows, now);
+            return 2;
+        }
+
+        uint32_t batches = 0;
+    };
+
+    SoloLadderUpdate Result(int32_t delta, bool isWin)
+    {
+        SoloLadderUpdate update;
+        update.delta  = delta;
+        update.games  = 1;
+        update.wins   = isWin;
+        update.losses = !isWin;
+        return update;
+    }
+}
+
+/// Six results of a match are one batch; a player's changes are merged, and
+/// reads see them before they are written.
+TEST(SoloLadderWriteBehindTest, MergesAndFlushesAfterDelay)
+{
+    BatchCountingStorage backend;
+    std::vector<SoloLadderFlush> flushes;
+    WriteBehindSoloLadderStorage storage(backend, 5000, 100, [&flushes](SoloLadderFlush const& flush) { flushes.push_back(flush); });
+
+    storage.FlushIfDue(1000);
+    for (uint32_t guid = 1; guid <= 6; ++guid)
+        storage.Update(guid, Result(guid <= 3 ? 16 : -16, guid <= 3), 1);
+    storage.Update(1, Result(-50, false), 1); // leaver penalty on top
+
+    EXPECT_EQ(storage.PendingRows(), 6u);
+    SoloLadderRow row;
+    ASSERT_TRUE(storage.Load(1, row));
+    EXPECT_EQ(row.rating, SOLO_RATING_DEFAULT - 34);
+    EXPECT_EQ(row.games, 2u);
+    EXPECT_FALSE(backend.Load(1, row));
+
+    storage.FlushIfDue(5999);
+    EXPECT_EQ(backend.batches, 0u);
+    storage.FlushIfDue(6000);
+    EXPECT_EQ(backend.batches, 1u);
+    EXPECT_EQ(storage.PendingRows(), 0u);
+
+    ASSERT_EQ(flushes.size(), 1u);
+    EXPECT_EQ(flushes[0].rows, 6u);
+    EXPECT_EQ(flushes[0].updates, 7u);
+    EXPECT_EQ(flushes[0].statements, 2u);
+
+    ASSERT_TRUE(backend.Load(1, row));
+    EXPECT_EQ(row.rating, SOLO_RATING_DEFAULT - 34);
+    EXPECT_EQ(row.wins, 1u);
+    EXPECT_EQ(row.losses, 1u);
+    ASSERT_TRUE(backend.Load(6, row));
+    EXPECT_EQ(row.rating, SOLO_RATING_DEFAULT - 16);
+
+    storage.Flush();
+    EXPECT_EQ(backend.batches, 1u); // nothing pending
+}
+
+/// The row threshold flushes at once; the delay counts from the oldest change.
+TEST(SoloLadderWriteBehindTest, FlushesAtRowLimit)
+{
+    BatchCountingStorage backend;
+    WriteBehindSoloLadderStorage storage(backend, 5000, 3);
+
+    storage.FlushIfDue(0);
+    storage.Update(1, Result(10, true), 1);
+    storage.Update(2, Result(10, true), 1);
+    storage.Update(1, Result(10, true), 1);
+    EXPECT_EQ(backend.batches, 0u);
+    storage.Update(3, Result(10, true), 1);
+    EXPECT_EQ(backend.batches, 1u);
+
+    storage.FlushIfDue(4000);
+    storage.Update(4, Result(10, true), 1);
+    storage.FlushIfDue(8999);
+    EXPECT_EQ(backend.batches, 1u);
+    storage.FlushIfDue(9000);
+    EXPECT_EQ(backend.batches, 2u);
+    EXPECT_EQ(backend.Size(), 4u);
+}
+
+/// An async load adds the changes that were pending when it was issued.
+TEST(SoloLadderWriteBehindTest, LoadAsyncSeesPendingChanges)
+{
+    InMemorySoloLadderStorage backend;
+    WriteBehindSoloLadderStorage storage(backend, 5000, 100);
+
+    storage.Update(9, Result(20, true), 1);
+    bool found = false;
+    SoloLadderRow loaded;
+    storage.LoadAsync(9, [&](bool rowFound, SoloLadderRow const& row) { found = rowFound; loaded = row; });
+    EXPECT_TRUE(found);
+    EXPECT_EQ(loaded.rating, SOLO_RATING_DEFAULT + 20);
+    EXPECT_EQ(loaded.wins, 1u);
+
+    storage.LoadAsync(10, [&](bool rowFound, SoloLadderRow const&) { found = rowFound; });
+    EXPECT_FALSE(found);
+}
@@ -0,0 +1,206 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include "InMemorySoloQueue.h"
+
+#include <random>
+
+namespace
+{
+    using Matchmaker = SoloMatchmaker<InMemorySoloQueue>;
+
+    SoloMatchmakerConfig FilteredConfig()
+    {
+        SoloMatchmakerConfig config;
+        config.filterTalents = true;
+        return config;
+    }
+
+    InMemoryQueuedPlayer Player(uint64_t id, uint8_t role, uint32_t mmr, uint8_t classId, uint32_t joinTime,
+        uint8_t team = SOLO_TEAM_ALLIANCE)
+    {
+        InMemoryQueuedPlayer player;
+        player.id       = id;
+        player.role     = role;
+        player.mmr      = mmr;
+        player.classId  = classId;
+        player.joinTime = joinTime;
+        player.team     = team;
+        return player;
+    }
+
+    bool IsJoinTimeOrdered(InMemorySoloQueue::Bucket const& bucket)
+    {
+        return std::is_sorted(bucket.begin(), bucket.end(),
+            [](InMemoryQueuedPlayer const* a, InMemoryQueuedPlayer const* b) { return a->joinTime < b->joinTime; });
+    }
+}
+
+/// A full queue forms a match: one healer per pool, and the players picked
+/// for the Horde pool move to the Horde bucket in JoinTime order.
+TEST(SoloMatchmakerTest, Check_FormsMatchAndMovesBuckets)
+{
+    InMemorySoloQueue queue;
+    queue.Add(Player(1, SOLO_ROLE_HEALER, 1500, 5,  100));
+    queue.Add(Player(2, SOLO_ROLE_MELEE,  1600, 1,  200));
+    queue.Add(Player(3, SOLO_ROLE_RANGE,  1400, 8,  300));
+    queue.Add(Player(4, SOLO_ROLE_HEALER, 1500, 7,  50, SOLO_TEAM_HORDE));
+    queue.Add(Player(5, SOLO_ROLE_MELEE,  1550, 4,  400));
+    queue.Add(Player(6, SOLO_ROLE_RANGE,  1450, 9,  500));
+
+    Matchmaker matchmaker(queue, FilteredConfig());
+    Matchmaker::Result result;
+    ASSERT_TRUE(matchmaker.Check(0, false, result));
+
+    EXPECT_EQ(result.reason, AUDIT_REASON_OK);
+    EXPECT_EQ(result.candidates, 6u);
+    EXPECT_EQ(result.phases, 3u);
+    ASSERT_EQ(queue.Pool(SOLO_TEAM_ALLIANCE).size(), 3u);
+    ASSERT_EQ(queue.Pool(SOLO_TEAM_HORDE).size(), 3u);
+
+    for (uint8_t team : { SOLO_TEAM_ALLIANCE, SOLO_TEAM_HORDE })
+    {
+        uint32_t healers = 0;
+        for (InMemoryQueuedPlayer const* player : queue.Pool(team))
+        {
+            healers += player->role == SOLO_ROLE_HEALER;
+            EXPECT_EQ(player->team, team);
+            EXPECT_EQ(player->bucket, team == SOLO_TEAM_ALLIANCE ? SOLO_BUCKET_NORMAL_ALLIANCE : SOLO_BUCKET_NORMAL_HORDE);
+        }
+        EXPECT_EQ(healers, 1u);
+    }
+
+    EXPECT_EQ(queue.Queued(0, SOLO_BUCKET_NORMAL_ALLIANCE).size(), 3u);
+    EXPECT_EQ(queue.Queued(0, SOLO_BUCKET_NORMAL_HORDE).size(), 3u);
+    EXPECT_TRUE(IsJoinTimeOrdered(queue.Queued(0, SOLO_BUCKET_NORMAL_ALLIANCE)));
+    EXPECT_TRUE(IsJoinTimeOrdered(queue.Queued(0, SOLO_BUCKET_NORMAL_HORDE)));
+}
+
+/// Each way a pass can fail reports its reason.
+TEST(SoloMatchmakerTest, Check_ReportsNoMatchReasons)
+{
+    Matchmaker::Result result;
+    {
+        InMemorySoloQueue queue;
+        for (uint64_t id = 1; id <= 5; ++id)
+            queue.Add(Player(id, SOLO_ROLE_MELEE, 1500, uint8_t(id), uint32_t(id)));
+        Matchmaker matchmaker(queue, FilteredConfig());
+        EXPECT_FALSE(matchmaker.Check(0, false, result));
+        EXPECT_EQ(result.reason, AUDIT_REASON_TOO_FEW);
+    }
+    {
+        InMemorySoloQueue queue;
+        queue.Add(Player(1, SOLO_ROLE_HEALER, 1500, 5, 1));
+        for (uint64_t id = 2; id <= 7; ++id)
+            queue.Add(Player(id, SOLO_ROLE_MELEE, 1500, uint8_t(id), uint32_t(id)));
+        Matchmaker matchmaker(queue, FilteredConfig());
+        result = Matchmaker::Result();
+        EXPECT_FALSE(matchmaker.Check(0, false, result));
+        EXPECT_EQ(result.reason, AUDIT_REASON_ONE_HEALER);
+    }
+    {
+        InMemorySoloQueue queue;
+        for (uint64_t id = 1; id <= 6; ++id)
+            queue.Add(Player(id, SOLO_ROLE_MELEE, 1500, uint8_t(id), uint32_t(id))).allDpsReady = id < 6;
+        Matchmaker matchmaker(queue, FilteredConfig());
+        result = Matchmaker::Result();
+        EXPECT_FALSE(matchmaker.Check(0, false, result));
+        EXPECT_EQ(result.reason, AUDIT_REASON_ALL_DPS_WAIT);
+    }
+    {
+        // Every player is a warrior: no split survives class stacking level 1.
+        InMemorySoloQueue queue;
+        queue.Add(Player(1, SOLO_ROLE_HEALER, 1500, 1, 1));
+        queue.Add(Player(2, SOLO_ROLE_HEALER, 1500, 1, 2));
+        for (uint64_t id = 3; id <= 6; ++id)
+            queue.Add(Player(id, SOLO_ROLE_MELEE, 1500, 1, uint32_t(id)));
+        SoloMatchmakerConfig config = FilteredConfig();
+        config.preventClassStacking = 1;
+        Matchmaker matchmaker(queue, config);
+        std::vector<MatchmakingAuditRecord> splits;
+        result = Matchmaker::Result();
+        EXPECT_FALSE(matchmaker.Check(0, false, result, &splits));
+        EXPECT_EQ(result.reason, AUDIT_REASON_NO_SPLIT);
+        EXPECT_EQ(splits.size(), 20u);
+        EXPECT_TRUE(queue.Pool(SOLO_TEAM_ALLIANCE).empty());
+    }
+}
+
+/// Ties on MMR go to the split with fewer same-team ignore pairs.
+TEST(SoloMatchmakerTest, Check_IgnoreTieBreaker)
+{
+    InMemorySoloQueue queue;
+    queue.Add(Player(1, SOLO_ROLE_HEALER, 1500, 5, 1));
+    queue.Add(Player(2, SOLO_ROLE_HEALER, 1500, 7, 2));
+    for (uint64_t id = 3; id <= 6; ++id)
+        queue.Add(Player(id, SOLO_ROLE_MELEE, 1500, uint8_t(id), uint32_t(id)));
+    queue.AddIgnore(3, 4);
+
+    Matchmaker matchmaker(queue, FilteredConfig());
+    Matchmaker::Result result;
+    ASSERT_TRUE(matchmaker.Check(0, false, result));
+
+    auto onAlliance = [&queue](uint64_t id)
+    {
+        for (InMemoryQueuedPlayer const* player : queue.Pool(SOLO_TEAM_ALLIANCE))
+            if (player->id == id)
+                return true;
+        return false;
+    };
+    EXPECT_NE(onAlliance(3), onAlliance(4));
+}
+
+/// A queue of tens of thousands keeps forming valid matches, with the
+/// buckets staying in JoinTime order as players are moved and removed.
+TEST(SoloMatchmakerTest, Load_LargeQueue)
+{
+    constexpr uint32_t PLAYERS = 30000;
+    constexpr uint32_t MATCHES = 200;
+
+    std::mt19937_64 rng(3);
+    std::uniform_int_distribution<uint32_t> roll(0, 99);
+    std::normal_distribution<double> mmr(1500.0, 200.0);
+
+    InMemorySoloQueue queue;
+    for (uint32_t i = 0; i < PLAYERS; ++i)
+    {
+        uint8_t const role = roll(rng) < 33 ? uint8_t(SOLO_ROLE_HEALER) : uint8_t(roll(rng) % 2);
+        queue.Add(Player(i + 1, role, uint32_t(std::max(0.0, mmr(rng))), uint8_t(1 + roll(rng) % 9), i, uint8_t(roll(rng) % 2)));
+    }
+
+    Matchmaker matchmaker(queue, FilteredConfig());
+    for (uint32_t match = 0; match < MATCHES; ++match)
+    {
+        Matchmaker::Result result;
+        ASSERT_TRUE(matchmaker.Check(0, false, result));
+        ASSERT_EQ(result.candidates, PLAYERS - match * 6);
+
+        for (uint8_t team : { SOLO_TEAM_ALLIANCE, SOLO_TEAM_HORDE })
+        {
+            uint32_t healers = 0;
+            for (InMemoryQueuedPlayer const* player : queue.Pool(team))
+                healers += player->role == SOLO_ROLE_HEALER;
+            ASSERT_EQ(healers, 1u);
+        }
+        ASSERT_EQ(queue.RemovePooled(), 6u);
+    }
+
+    EXPECT_EQ(queue.QueuedCount(), PLAYERS - MATCHES * 6);
+    EXPECT_TRUE(IsJoinTimeOrdered(queue.Queued(0, SOLO_BUCKET_NORMAL_ALLIANCE)));
+    EXPECT_TRUE(IsJoinTimeOrdered(queue.Queued(0, SOLO_BUCKET_NORMAL_HORDE)));
+}
@@ -0,0 +1,186 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include "SoloQueueJournal.h"
+
+#include <chrono>
+#include <cstdio>
+
+namespace
+{
+    SoloJournalEntry MakeEntry(uint64_t guid)
+    {
+        SoloJournalEntry e;
+        e.guid       = guid;
+        e.joinWallMs = 1700000000000ull + guid * 1000;
+        e.rating     = 1500 + uint32_t(guid % 300);
+        e.mmr        = 1600 + uint32_t(guid % 200);
+        e.role       = uint8_t(guid % 3);
+        e.classId    = uint8_t(1 + guid % 11);
+        e.bracketId  = 5;
+        e.rated      = (guid % 2) == 0;
+        return e;
+    }
+
+    std::string TempPath(char const* name)
+    {
+        std::string path = testing::TempDir() + name;
+        std::remove(path.c_str());
+        return path;
+    }
+}
+
+/// Records survive an encode/decode round trip bit for bit.
+TEST(SoloQueueJournalTest, Record_RoundTrip)
+{
+    SoloJournalEntry const in = MakeEntry(123456789012ull);
+    std::vector<uint8_t> buf;
+    SoloQueueJournal::EncodeRecord(SoloQueueJournal::RECORD_JOIN, in, buf);
+    ASSERT_EQ(buf.size(), SoloQueueJournal::RECORD_SIZE);
+
+    uint8_t type = 0;
+    SoloJournalEntry out;
+    ASSERT_TRUE(SoloQueueJournal::DecodeRecord(buf.data(), type, out));
+    EXPECT_EQ(type, SoloQueueJournal::RECORD_JOIN);
+    EXPECT_EQ(out, in);
+
+    buf[5] ^= 0x40; // corrupt a payload byte
+    EXPECT_FALSE(SoloQueueJournal::DecodeRecord(buf.data(), type, out));
+}
+
+/// Replay applies joins and leaves in order; a rejoin supersedes the old entry.
+TEST(SoloQueueJournalTest, Replay_AppliesJoinsAndLeaves)
+{
+    std::vector<uint8_t> buf;
+    SoloQueueJournal::EncodeHeader(buf);
+    SoloQueueJournal::EncodeRecord(SoloQueueJournal::RECORD_JOIN, MakeEntry(1), buf);
+    SoloQueueJournal::EncodeRecord(SoloQueueJournal::RECORD_JOIN, MakeEntry(2), buf);
+    SoloQueueJournal::EncodeRecord(SoloQueueJournal::RECORD_LEAVE, MakeEntry(1), buf);
+
+    SoloJournalEntry rejoin = MakeEntry(2);
+    rejoin.mmr = 2222;
+    SoloQueueJournal::EncodeRecord(SoloQueueJournal::RECORD_JOIN, rejoin, buf);
+
+    SoloQueueJournal::EntryMap live;
+    uint64_t records = 0;
+    EXPECT_EQ(SoloQueueJournal::Replay(buf.data(), buf.size(), live, &records), buf.size());
+    EXPECT_EQ(records, 4u);
+    ASSERT_EQ(live.size(), 1u);
+    EXPECT_EQ(live[2].mmr, 2222u);
+}
+
+/// A torn final record is ignored and everything before it is kept.
+TEST(SoloQueueJournalTest, Replay_StopsAtTornTail)
+{
+    std::vector<uint8_t> buf;
+    SoloQueueJournal::EncodeHeader(buf);
+    SoloQueueJournal::EncodeRecord(SoloQueueJournal::RECORD_JOIN, MakeEntry(1), buf);
+    size_t const good = buf.size();
+    SoloQueueJournal::EncodeRecord(SoloQueueJournal::RECORD_JOIN, MakeEntry(2), buf);
+    buf.resize(buf.size() - 7);
+
+    SoloQueueJournal::EntryMap live;
+    EXPECT_EQ(SoloQueueJournal::Replay(buf.data(), buf.size(), live), good);
+    EXPECT_EQ(live.size(), 1u);
+    EXPECT_EQ(live.count(1), 1u);
+
+    // Foreign files are rejected outright.
+    uint8_t junk[16] = { 'n', 'o', 'p', 'e' };
+    EXPECT_EQ(SoloQueueJournal::Replay(junk, sizeof(junk), live), 0u);
+}
+
+/// Entries written through one journal are restored by the next Open, and
+/// compaction shrinks the file to the live set.
+TEST(SoloQueueJournalTest, OpenAppendReopen_AndCompact)
+{
+    std::string const path = TempPath("solo_journal_reopen.bin");
+    {
+        SoloQueueJournal journal;
+        ASSERT_TRUE(journal.Open(path));
+        for (uint64_t g = 1; g <= 100; ++g)
+            journal.AppendJoin(MakeEntry(g));
+        for (uint64_t g = 1; g <= 90; ++g)
+            journal.AppendLeave(g);
+        journal.AppendLeave(1000); // unknown guid: no record
+        journal.Flush();
+
+        EXPECT_EQ(journal.RecordCount(), 190u);
+        EXPECT_TRUE(journal.ShouldCompact(4, 100));
+    }
+
+    SoloQueueJournal journal;
+    ASSERT_TRUE(journal.Open(path));
+    EXPECT_EQ(journal.Live().size(), 10u);
+    EXPECT_EQ(journal.Live().at(95), MakeEntry(95));
+
+    ASSERT_TRUE(journal.Compact());
+    EXPECT_EQ(journal.RecordCount(), 10u);
+    journal.AppendJoin(MakeEntry(500));
+    journal.Close();
+
+    SoloQueueJournal reopened;
+    ASSERT_TRUE(reopened.Open(path));
+    EXPECT_EQ(reopened.Live().size(), 11u);
+    EXPECT_EQ(reopened.RecordCount(), 11u);
+    reopened.Close();
+    std::remove(path.c_str());
+}
+
+/// Restored joins keep their wait on the new game clock; those that waited
+/// longer than the server has been up keep their order instead of all
+/// collapsing onto 0.
+TEST(SoloQueueJournalTest, GameJoinTimes_KeepsOrderPastUptime)
+{
+    uint64_t const now = 1700000100000ull;
+    std::vector<SoloJournalEntry> entries;
+    for (uint64_t g : { 4, 1, 3, 2, 5 })
+        entries.push_back(MakeEntry(g));
+    entries[0].joinWallMs = now - 500;     // guid 4: waited less than the uptime
+    entries[1].joinWallMs = now - 90000;   // guid 1: oldest
+    entries[2].joinWallMs = now - 60000;   // guid 3
+    entries[3].joinWallMs = now - 60000;   // guid 2: same join as 3, lower guid first
+    entries[4].joinWallMs = now - 5000;    // guid 5: maps to the same ms as guid 2
+
+    std::vector<uint32_t> const times = SoloQueueJournal::GameJoinTimes(entries, now, 5000);
+    ASSERT_EQ(times.size(), entries.size());
+
+    std::vector<uint64_t> order;
+    for (SoloJournalEntry const& entry : entries)
+        order.push_back(entry.guid);
+    EXPECT_EQ(order, (std::vector<uint64_t>{ 1, 2, 3, 5, 4 }));
+    EXPECT_EQ(times, (std::vector<uint32_t>{ 0, 1, 2, 3, 4500 }));
+}
+
+/// Replaying thousands of records is a matter of milliseconds.
+TEST(SoloQueueJournalTest, Replay_ThousandsOfEntriesIsFast)
+{
+    std::vector<uint8_t> buf;
+    SoloQueueJournal::EncodeHeader(buf);
+    for (uint64_t g = 1; g <= 20000; ++g)
+        SoloQueueJournal::EncodeRecord(SoloQueueJournal::RECORD_JOIN, MakeEntry(g), buf);
+    for (uint64_t g = 1; g <= 10000; ++g)
+        SoloQueueJournal::EncodeRecord(SoloQueueJournal::RECORD_LEAVE, MakeEntry(g), buf);
+
+    auto const start = std::chrono::steady_clock::now();
+    SoloQueueJournal::EntryMap live;
+    SoloQueueJournal::Replay(buf.data(), buf.size(), live);
+    auto const elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+    EXPECT_EQ(live.size(), 10000u);
+    EXPECT_LT(elapsed.count(), 500); // generous bound for slow CI machines
+}
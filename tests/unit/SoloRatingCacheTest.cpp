@@ -0,0 +1,86 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include "SoloRatingCache.h"
+
+namespace
+{
+    SoloLadderUpdate Win(int32_t delta)
+    {
+        SoloLadderUpdate update;
+        update.delta = delta;
+        update.games = 1;
+        update.wins  = 1;
+        return update;
+    }
+}
+
+/// Login load, reads, in-place match results and logout.
+TEST(SoloRatingCacheTest, Lifecycle)
+{
+    SoloRatingCache cache;
+    uint32_t const token = cache.BeginLoad(5);
+    EXPECT_EQ(cache.Find(5), nullptr);
+
+    SoloLadderRow loaded;
+    loaded.rating = 1700;
+    loaded.mmr    = 1750;
+    loaded.games  = 10;
+    ASSERT_TRUE(cache.Fill(5, token, loaded));
+
+    cache.Apply(5, Win(12));
+    SoloLadderRow const* row = cache.Find(5);
+    ASSERT_NE(row, nullptr);
+    EXPECT_EQ(row->rating, 1712u);
+    EXPECT_EQ(row->mmr, 1762u);
+    EXPECT_EQ(row->games, 11u);
+    EXPECT_EQ(row->wins, 1u);
+    EXPECT_EQ(cache.Hits(), 1u);
+    EXPECT_EQ(cache.Misses(), 1u);
+
+    cache.Apply(6, Win(12)); // not online: nothing cached
+    EXPECT_EQ(cache.Size(), 1u);
+
+    cache.Evict(5);
+    EXPECT_EQ(cache.Find(5), nullptr);
+    EXPECT_EQ(cache.Size(), 0u);
+}
+
+/// Results that land while the row loads are applied on Fill; loads
+/// overtaken by a logout or relog are ignored.
+TEST(SoloRatingCacheTest, PendingAndStaleLoads)
+{
+    SoloRatingCache cache;
+    uint32_t const token = cache.BeginLoad(5);
+    cache.Apply(5, Win(20));
+    cache.Apply(5, Win(-int32_t(SOLO_RATING_MAX)));
+    ASSERT_TRUE(cache.Fill(5, token, SoloLadderRow()));
+    ASSERT_NE(cache.Find(5), nullptr);
+    EXPECT_EQ(cache.Find(5)->rating, 0u);
+    EXPECT_EQ(cache.Find(5)->games, 2u);
+    EXPECT_FALSE(cache.Fill(5, token, SoloLadderRow()));
+
+    uint32_t const first = cache.BeginLoad(7);
+    cache.Evict(7);
+    EXPECT_FALSE(cache.Fill(7, first, SoloLadderRow()));
+
+    uint32_t const before = cache.BeginLoad(8);
+    uint32_t const relog  = cache.BeginLoad(8);
+    EXPECT_FALSE(cache.Fill(8, before, SoloLadderRow()));
+    EXPECT_TRUE(cache.Fill(8, relog, SoloLadderRow()));
+}
@@ -0,0 +1,99 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include "SyntheticSoloLoad.h"
+
+namespace
+{
+    SoloMatchmakerConfig FilteredConfig()
+    {
+        SoloMatchmakerConfig config;
+        config.filterTalents = true;
+        return config;
+    }
+}
+
+/// A backlog is matched one pass per tick, each match taking six players.
+TEST(SyntheticSoloLoadTest, Backlog_DrainsOneMatchPerPass)
+{
+    SoloLoadSettings settings;
+    settings.initialEntries    = 600;
+    settings.arrivalsPerMinute = 0.0;
+    settings.healerShare       = 0.5;
+
+    SyntheticSoloLoad load(settings, FilteredConfig());
+    EXPECT_EQ(load.Stats().injected[SOLO_ROLE_MELEE] + load.Stats().injected[SOLO_ROLE_RANGE] +
+        load.Stats().injected[SOLO_ROLE_HEALER], 600u);
+
+    for (uint64_t ms = 0; ms < 10 * 50; ms += 50)
+        load.Tick(ms);
+
+    SoloLoadStats const& stats = load.Stats();
+    EXPECT_EQ(stats.ticks, 10u);
+    EXPECT_EQ(stats.matches, 10u);
+    EXPECT_EQ(stats.queued, 600u - 60u);
+    EXPECT_EQ(stats.passUs.Count(), 10u);
+    EXPECT_EQ(stats.candidates.Max(), 600u);
+}
+
+/// Arrivals are queued as they come due; a DPS-only load forms matches
+/// once the AllDPS timers run out, and arrivals past maxQueued are dropped.
+TEST(SyntheticSoloLoadTest, Arrivals_AllDpsTimerAndCap)
+{
+    SoloLoadSettings settings;
+    settings.arrivalsPerMinute = 600.0;
+    settings.healerShare       = 0.0;
+    settings.allDpsTimerMs     = 30000;
+    settings.maxQueued         = 200;
+    settings.passesPerTick     = 4;
+
+    SyntheticSoloLoad load(settings, FilteredConfig());
+    for (uint64_t ms = 0; ms < 25000; ms += 100)
+        load.Tick(ms);
+
+    EXPECT_EQ(load.Stats().matches, 0u);
+    EXPECT_EQ(load.Stats().lastReason, AUDIT_REASON_ALL_DPS_WAIT);
+    EXPECT_EQ(load.Stats().queued, 200u);
+    EXPECT_GT(load.Stats().dropped, 0u);
+
+    for (uint64_t ms = 25000; ms < 120000; ms += 100)
+        load.Tick(ms);
+
+    SoloLoadStats const& stats = load.Stats();
+    EXPECT_GT(stats.matches, 50u);
+    EXPECT_EQ(stats.allDpsMatches, stats.matches);
+    EXPECT_EQ(stats.injected[SOLO_ROLE_HEALER], 0u);
+    EXPECT_LE(stats.queued, 200u);
+    EXPECT_GE(stats.waitSec.Min(), 30u);
+}
+
+/// With a zero AllDPS timer a DPS-only load matches right away.
+TEST(SyntheticSoloLoadTest, Arrivals_ZeroAllDpsTimerMatchesAtJoin)
+{
+    SoloLoadSettings settings;
+    settings.initialEntries    = 60;
+    settings.arrivalsPerMinute = 0.0;
+    settings.healerShare       = 0.0;
+    settings.allDpsTimerMs     = 0;
+
+    SyntheticSoloLoad load(settings, FilteredConfig());
+    load.Tick(0);
+
+    EXPECT_EQ(load.Stats().matches, 1u);
+    EXPECT_EQ(load.Stats().allDpsMatches, 1u);
+}
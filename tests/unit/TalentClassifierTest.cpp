@@ -0,0 +1,55 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include "TalentClassifier.h"
+
+namespace
+{
+    uint32_t const MELEE_TABS[] = { 161, 182, 0 };
+    uint32_t const RANGE_TABS[] = { 81, 361, 0 };
+    uint32_t const HEAL_TABS[]  = { 201, 282, 161, 0 }; // 161 duplicates a melee tab
+}
+
+/// Listed tabs map to their role, anything else (and tab 0) to NONE.
+TEST(TalentClassifierTest, RoleOf_MapsListedTabs)
+{
+    SoloTalentClassifier const classifier(MELEE_TABS, RANGE_TABS, HEAL_TABS);
+
+    EXPECT_EQ(classifier.RoleOf(182), 0);
+    EXPECT_EQ(classifier.RoleOf(361), 1);
+    EXPECT_EQ(classifier.RoleOf(282), 2);
+    EXPECT_EQ(classifier.RoleOf(161), 0) << "first list wins";
+    EXPECT_EQ(classifier.RoleOf(0),    SoloTalentClassifier::NONE);
+    EXPECT_EQ(classifier.RoleOf(183),  SoloTalentClassifier::NONE);
+    EXPECT_EQ(classifier.RoleOf(9999), SoloTalentClassifier::NONE);
+}
+
+/// The role with the most points wins, ties keep the earlier role and an
+/// untalented player is melee.
+TEST(TalentClassifierTest, Pick_MostPointsEarlierRoleOnTies)
+{
+    uint32_t const none[3]     = { 0, 0, 0 };
+    uint32_t const healer[3]   = { 10, 0, 51 };
+    uint32_t const tied[3]     = { 0, 30, 30 };
+    uint32_t const range[3]    = { 5, 56, 10 };
+
+    EXPECT_EQ(SoloTalentClassifier::Pick(none), 0u);
+    EXPECT_EQ(SoloTalentClassifier::Pick(healer), 2u);
+    EXPECT_EQ(SoloTalentClassifier::Pick(tied), 1u);
+    EXPECT_EQ(SoloTalentClassifier::Pick(range), 1u);
+}
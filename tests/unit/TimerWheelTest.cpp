@@ -0,0 +1,138 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include "TimerWheel.h"
+
+#include <map>
+#include <random>
+
+namespace
+{
+    using Wheel = TimerWheel<uint32_t>;
+
+    /// Advances in @p stepMs increments up to @p untilMs and records the
+    /// time each payload fired at.
+    std::map<uint32_t, uint64_t> RunUntil(Wheel& wheel, uint64_t fromMs, uint64_t untilMs, uint64_t stepMs)
+    {
+        std::map<uint32_t, uint64_t> fired;
+        for (uint64_t now = fromMs; now <= untilMs; now += stepMs)
+            wheel.Advance(now, [&](Wheel::TimerId, uint32_t payload) { fired[payload] = now; });
+        return fired;
+    }
+}
+
+/// A timer fires on the first Advance at or after its deadline, never before.
+TEST(TimerWheelTest, FiresAtDeadline_NotEarly)
+{
+    Wheel wheel(0, 100);
+    wheel.Schedule(250, 1);
+    wheel.Schedule(300, 2);
+
+    auto fired = RunUntil(wheel, 0, 1000, 50);
+    ASSERT_EQ(fired.size(), 2u);
+    EXPECT_EQ(fired[1], 300u); // 250 rounds up to the 300 ms tick
+    EXPECT_EQ(fired[2], 300u);
+    EXPECT_TRUE(wheel.Empty());
+}
+
+/// Deadlines already in the past fire on the next tick.
+TEST(TimerWheelTest, PastDeadline_FiresNextTick)
+{
+    Wheel wheel(10000, 100);
+    wheel.Schedule(500, 7);
+
+    auto fired = RunUntil(wheel, 10000, 10200, 100);
+    ASSERT_EQ(fired.size(), 1u);
+    EXPECT_EQ(fired[7], 10100u);
+}
+
+/// Cancelled timers never fire, and cancelling twice reports false.
+TEST(TimerWheelTest, Cancel_PreventsFiring)
+{
+    Wheel wheel(0, 100);
+    Wheel::TimerId const a = wheel.Schedule(1000, 1);
+    wheel.Schedule(1000, 2);
+
+    EXPECT_TRUE(wheel.Cancel(a));
+    EXPECT_FALSE(wheel.Cancel(a));
+    EXPECT_EQ(wheel.Size(), 1u);
+
+    auto fired = RunUntil(wheel, 0, 2000, 100);
+    EXPECT_EQ(fired.count(1), 0u);
+    EXPECT_EQ(fired.count(2), 1u);
+}
+
+/// Timers spread across every level (and past the top level's range) fire
+/// exactly on their tick after cascading, in deadline order.
+TEST(TimerWheelTest, RandomDeadlines_FireOnTheirTickInOrder)
+{
+    // 3 levels of 4 slots: 64 ticks of range, so most deadlines need cascading
+    // and some wrap the top level.
+    using SmallWheel = TimerWheel<uint32_t, 2, 3>;
+    SmallWheel wheel(1000, 10);
+
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<uint32_t> dist(1, 2000);
+
+    std::map<uint32_t, uint64_t> expectedTick;
+    for (uint32_t i = 0; i < 500; ++i)
+    {
+        uint64_t const when = 1000 + dist(rng) * 10;
+        expectedTick[i] = when / 10;
+        wheel.Schedule(when, i);
+    }
+
+    uint64_t lastTick = 0;
+    uint32_t count = 0;
+    for (uint64_t now = 1000; now <= 1000 + 2001 * 10; now += 10)
+    {
+        wheel.Advance(now, [&](SmallWheel::TimerId, uint32_t payload)
+        {
+            EXPECT_EQ(wheel.NowTick(), expectedTick[payload]) << "payload " << payload;
+            EXPECT_GE(wheel.NowTick(), lastTick);
+            lastTick = wheel.NowTick();
+            ++count;
+        });
+    }
+
+    EXPECT_EQ(count, 500u);
+    EXPECT_TRUE(wheel.Empty());
+}
+
+/// A large jump fires everything that became due, and callbacks may
+/// schedule new timers while the wheel is advancing.
+TEST(TimerWheelTest, LargeJump_AndRescheduleFromCallback)
+{
+    Wheel wheel(0, 100);
+    wheel.Schedule(5000, 1);
+    wheel.Schedule(60000, 2);
+
+    std::vector<uint32_t> order;
+    auto onFire = [&](Wheel::TimerId, uint32_t payload)
+    {
+        order.push_back(payload);
+        if (payload == 1)
+            wheel.Schedule(7000, 3);
+    };
+
+    wheel.Advance(100000, onFire);
+    ASSERT_EQ(order.size(), 3u);
+    EXPECT_EQ(order[0], 1u);
+    EXPECT_EQ(order[1], 3u);
+    EXPECT_EQ(order[2], 2u);
+}